@@ -3442,6 +3442,93 @@ static void test_delete_key_value(void)
     RegCloseKey(subkey);
 }
 
+static void test_many_subkeys(void)
+{
+    HKEY key, subkey;
+    char name[32], buffer[32];
+    DWORD count, size;
+    LONG ret;
+    int i;
+
+    ret = RegCreateKeyExA(hkey_main, "ManySubkeys", 0, NULL, 0, KEY_ALL_ACCESS, NULL, &key, NULL);
+    ok(!ret, "RegCreateKeyExA failed: %d\n", ret);
+
+    /* create the subkeys and values in reverse order */
+    for (i = 499; i >= 0; i--)
+    {
+        sprintf(name, "Subkey%03d", i);
+        ret = RegCreateKeyA(key, name, &subkey);
+        ok(!ret, "RegCreateKeyA %s failed: %d\n", name, ret);
+        RegCloseKey(subkey);
+        sprintf(name, "Value%03d", i);
+        ret = RegSetValueExA(key, name, 0, REG_DWORD, (const BYTE *)&i, sizeof(i));
+        ok(!ret, "RegSetValueExA %s failed: %d\n", name, ret);
+    }
+
+    ret = RegQueryInfoKeyA(key, NULL, NULL, NULL, &count, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+    ok(!ret, "RegQueryInfoKeyA failed: %d\n", ret);
+    ok(count == 500, "expected 500 subkeys, got %u\n", count);
+
+    /* subkeys are enumerated in alphabetical order */
+    for (i = 0; i < 500; i++)
+    {
+        sprintf(name, "Subkey%03d", i);
+        ret = RegEnumKeyA(key, i, buffer, sizeof(buffer));
+        ok(!ret, "RegEnumKeyA %d failed: %d\n", i, ret);
+        ok(!strcmp(buffer, name), "expected %s, got %s\n", name, buffer);
+    }
+
+    /* lookups are case insensitive */
+    for (i = 0; i < 500; i += 7)
+    {
+        sprintf(name, "SUBKEY%03d", i);
+        ret = RegOpenKeyA(key, name, &subkey);
+        ok(!ret, "RegOpenKeyA %s failed: %d\n", name, ret);
+        RegCloseKey(subkey);
+        sprintf(name, "vALUE%03d", i);
+        size = sizeof(count);
+        ret = RegQueryValueExA(key, name, NULL, NULL, (BYTE *)&count, &size);
+        ok(!ret, "RegQueryValueExA %s failed: %d\n", name, ret);
+        ok(count == i, "expected %d, got %u\n", i, count);
+    }
+
+    /* delete every other subkey and value */
+    for (i = 0; i < 500; i += 2)
+    {
+        sprintf(name, "Subkey%03d", i);
+        ret = RegDeleteKeyA(key, name);
+        ok(!ret, "RegDeleteKeyA %s failed: %d\n", name, ret);
+        sprintf(name, "Value%03d", i);
+        ret = RegDeleteValueA(key, name);
+        ok(!ret, "RegDeleteValueA %s failed: %d\n", name, ret);
+    }
+
+    ret = RegQueryInfoKeyA(key, NULL, NULL, NULL, &count, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+    ok(!ret, "RegQueryInfoKeyA failed: %d\n", ret);
+    ok(count == 250, "expected 250 subkeys, got %u\n", count);
+
+    for (i = 0; i < 250; i++)
+    {
+        sprintf(name, "Subkey%03d", 2 * i + 1);
+        ret = RegEnumKeyA(key, i, buffer, sizeof(buffer));
+        ok(!ret, "RegEnumKeyA %d failed: %d\n", i, ret);
+        ok(!strcmp(buffer, name), "expected %s, got %s\n", name, buffer);
+    }
+    ret = RegEnumKeyA(key, 250, buffer, sizeof(buffer));
+    ok(ret == ERROR_NO_MORE_ITEMS, "expected ERROR_NO_MORE_ITEMS, got %d\n", ret);
+
+    for (i = 0; i < 500; i++)
+    {
+        sprintf(name, "Value%03d", i);
+        ret = RegQueryValueExA(key, name, NULL, NULL, NULL, NULL);
+        if (i % 2) ok(!ret, "RegQueryValueExA %s failed: %d\n", name, ret);
+        else ok(ret == ERROR_FILE_NOT_FOUND, "expected ERROR_FILE_NOT_FOUND for %s, got %d\n", name, ret);
+    }
+
+    delete_key(key);
+    RegCloseKey(key);
+}
+
 static void test_RegOpenCurrentUser(void)
 {
     HKEY key;
@@ -3562,6 +3649,7 @@ START_TEST(registry)
     test_deleted_key();
     test_delete_value();
     test_delete_key_value();
+    test_many_subkeys();
     test_RegOpenCurrentUser();
     test_RegNotifyChangeKeyValue();
     test_RegQueryValueExPerformanceData();
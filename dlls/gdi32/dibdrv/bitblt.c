@@ -21,8 +21,10 @@
 #include <assert.h>
 
 #include "gdi_private.h"
+#include "winreg.h"
 #include "dibdrv.h"
 
+#include "wine/unicode.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(dib);
@@ -466,6 +468,161 @@ static int get_overlap( const dib_info *dst, const RECT *dst_rect,
     return ret;
 }
 
+/* Large operations can optionally be split into bands of rows that are processed in parallel
+ * by a thread pool. This is enabled by setting the "Threads" value of the DIB Engine key. */
+
+#define MAX_BAND_THREADS 64
+#define MIN_BAND_PIXELS  (256 * 1024)  /* smaller operations are not worth splitting */
+#define MIN_BAND_ROWS    16
+
+static INIT_ONCE band_init_once = INIT_ONCE_STATIC_INIT;
+static TP_CALLBACK_ENVIRON band_environ;
+static int band_threads;
+
+struct band_job
+{
+    LONG   next;        /* index of the next band to process */
+    int    count;       /* number of bands */
+    int    top;         /* first row of the operation */
+    int    height;      /* number of rows of the operation */
+    void (*func)( void *arg, int top, int bottom );
+    void  *arg;
+};
+
+static BOOL WINAPI init_band_threads( INIT_ONCE *once, void *param, void **context )
+{
+    static const WCHAR dib_engineW[] = {'S','o','f','t','w','a','r','e','\\','W','i','n','e','\\',
+                                        'D','I','B',' ','E','n','g','i','n','e',0};
+    static const WCHAR threadsW[] = {'T','h','r','e','a','d','s',0};
+    WCHAR buffer[16] = {0};
+    DWORD type, size = sizeof(buffer) - sizeof(WCHAR);
+    PTP_POOL pool;
+    HKEY hkey;
+    int count = 0;
+
+    if (!RegOpenKeyW( HKEY_CURRENT_USER, dib_engineW, &hkey ))
+    {
+        if (!RegQueryValueExW( hkey, threadsW, NULL, &type, (BYTE *)buffer, &size ) && type == REG_SZ)
+            count = atoiW( buffer );
+        RegCloseKey( hkey );
+    }
+    if (count <= 1) return TRUE;
+    if (count > MAX_BAND_THREADS) count = MAX_BAND_THREADS;
+
+    if (!(pool = CreateThreadpool( NULL ))) return TRUE;
+    SetThreadpoolThreadMaximum( pool, count - 1 );
+    memset( &band_environ, 0, sizeof(band_environ) );
+    band_environ.Version = 1;
+    band_environ.Pool = pool;
+    band_threads = count;
+    TRACE( "using %d threads\n", count );
+    return TRUE;
+}
+
+static void process_bands( struct band_job *job )
+{
+    int band;
+
+    while ((band = InterlockedIncrement( &job->next ) - 1) < job->count)
+        job->func( job->arg, job->top + MulDiv( band, job->height, job->count ),
+                   job->top + MulDiv( band + 1, job->height, job->count ));
+}
+
+static void CALLBACK band_work_proc( TP_CALLBACK_INSTANCE *instance, void *arg, TP_WORK *work )
+{
+    process_bands( arg );
+}
+
+/* call func on the rows from top to bottom, split in bands processed in parallel if worth it */
+static void run_in_bands( int top, int bottom, int width, void (*func)( void *arg, int top, int bottom ),
+                          void *arg )
+{
+    struct band_job job;
+    TP_WORK *work;
+    int i, height = bottom - top;
+
+    InitOnceExecuteOnce( &band_init_once, init_band_threads, NULL, NULL );
+
+    if (band_threads <= 1 || height < 2 * MIN_BAND_ROWS || (LONGLONG)width * height < MIN_BAND_PIXELS)
+    {
+        func( arg, top, bottom );
+        return;
+    }
+
+    job.next   = 0;
+    job.count  = min( band_threads, height / MIN_BAND_ROWS );
+    job.top    = top;
+    job.height = height;
+    job.func   = func;
+    job.arg    = arg;
+
+    if (!(work = CreateThreadpoolWork( band_work_proc, &job, &band_environ )))
+    {
+        func( arg, top, bottom );
+        return;
+    }
+    for (i = 1; i < job.count; i++) SubmitThreadpoolWork( work );
+    process_bands( &job );
+    WaitForThreadpoolWorkCallbacks( work, FALSE );
+    CloseThreadpoolWork( work );
+}
+
+struct rect_band_params
+{
+    const dib_info  *dst;
+    const dib_info  *src;
+    const RECT      *rect;
+    POINT            origin;
+    int              rop2;
+    int              overlap;
+    BLENDFUNCTION    blend;
+    const TRIVERTEX *vert;
+    int              mode;
+    BOOL             ret;
+};
+
+static void get_band_rect( const struct rect_band_params *params, int top, int bottom,
+                           RECT *rect, POINT *origin )
+{
+    rect->left   = params->rect->left;
+    rect->right  = params->rect->right;
+    rect->top    = top;
+    rect->bottom = bottom;
+    origin->x = params->origin.x;
+    origin->y = params->origin.y + top - params->rect->top;
+}
+
+static void copy_rect_band( void *arg, int top, int bottom )
+{
+    struct rect_band_params *params = arg;
+    POINT origin;
+    RECT rect;
+
+    get_band_rect( params, top, bottom, &rect, &origin );
+    params->dst->funcs->copy_rect( params->dst, &rect, params->src, &origin, params->rop2, params->overlap );
+}
+
+static void blend_rect_band( void *arg, int top, int bottom )
+{
+    struct rect_band_params *params = arg;
+    POINT origin;
+    RECT rect;
+
+    get_band_rect( params, top, bottom, &rect, &origin );
+    params->dst->funcs->blend_rect( params->dst, &rect, params->src, &origin, params->blend );
+}
+
+static void gradient_rect_band( void *arg, int top, int bottom )
+{
+    struct rect_band_params *params = arg;
+    POINT origin;
+    RECT rect;
+
+    get_band_rect( params, top, bottom, &rect, &origin );
+    if (!params->dst->funcs->gradient_rect( params->dst, &rect, params->vert, params->mode ))
+        params->ret = FALSE;
+}
+
 static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                         const struct clipped_rects *clipped_rects, INT rop2 )
 {
@@ -541,7 +698,7 @@ static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
             }
         }
     }
-    else  /* left to right, top to bottom */
+    else if (overlap & OVERLAP_ABOVE)  /* left to right, top to bottom */
     {
         for (i = 0; i < count; i++)
         {
@@ -550,6 +707,23 @@ static void copy_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
             dst->funcs->copy_rect( dst, &rects[i], src, &origin, rop2, overlap );
         }
     }
+    else  /* rows don't depend on each other, they can be copied in parallel */
+    {
+        struct rect_band_params params;
+
+        params.dst     = dst;
+        params.src     = src;
+        params.rop2    = rop2;
+        params.overlap = overlap;
+        for (i = 0; i < count; i++)
+        {
+            params.rect     = &rects[i];
+            params.origin.x = src_rect->left + rects[i].left - dst_rect->left;
+            params.origin.y = src_rect->top  + rects[i].top  - dst_rect->top;
+            run_in_bands( rects[i].top, rects[i].bottom, rects[i].right - rects[i].left,
+                          copy_rect_band, &params );
+        }
+    }
 }
 
 static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
@@ -584,16 +758,21 @@ static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
 static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                          HRGN clip, BLENDFUNCTION blend )
 {
-    POINT origin;
+    struct rect_band_params params;
     struct clipped_rects clipped_rects;
+    const RECT *rect;
     int i;
 
     if (!get_clipped_rects( dst, dst_rect, clip, &clipped_rects )) return ERROR_SUCCESS;
+    params.dst   = dst;
+    params.src   = src;
+    params.blend = blend;
     for (i = 0; i < clipped_rects.count; i++)
     {
-        origin.x = src_rect->left + clipped_rects.rects[i].left - dst_rect->left;
-        origin.y = src_rect->top  + clipped_rects.rects[i].top  - dst_rect->top;
-        dst->funcs->blend_rect( dst, &clipped_rects.rects[i], src, &origin, blend );
+        rect = params.rect = &clipped_rects.rects[i];
+        params.origin.x = src_rect->left + rect->left - dst_rect->left;
+        params.origin.y = src_rect->top  + rect->top  - dst_rect->top;
+        run_in_bands( rect->top, rect->bottom, rect->right - rect->left, blend_rect_band, &params );
     }
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
@@ -682,15 +861,23 @@ static BOOL gradient_rect( dib_info *dib, TRIVERTEX *v, int mode, HRGN clip, con
 {
     int i;
     struct clipped_rects clipped_rects;
-    BOOL ret = TRUE;
+    struct rect_band_params params;
+    const RECT *rect;
 
     if (!get_clipped_rects( dib, bounds, clip, &clipped_rects )) return TRUE;
+    params.dst    = dib;
+    params.vert   = v;
+    params.mode   = mode;
+    params.ret    = TRUE;
+    params.origin.x = params.origin.y = 0;
     for (i = 0; i < clipped_rects.count; i++)
     {
-        if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
+        rect = params.rect = &clipped_rects.rects[i];
+        run_in_bands( rect->top, rect->bottom, rect->right - rect->left, gradient_rect_band, &params );
+        if (!params.ret) break;
     }
     free_clipped_rects( &clipped_rects );
-    return ret;
+    return params.ret;
 }
 
 static DWORD copy_src_bits( dib_info *src, RECT *src_rect )
@@ -1189,6 +1376,102 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
+struct stretch_band_params
+{
+    dib_info                    *dst_dib;
+    const dib_info              *src_dib;
+    POINT                        dst_start;
+    POINT                        src_start;
+    struct stretch_params        v_params;
+    struct stretch_params        h_params;
+    BOOL                         vstretch;
+    int                          mode;
+    int                          width;
+    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
+                    const dib_info *src_dib, const POINT *src_start,
+                    const struct stretch_params *params, int mode, BOOL keep_dst);
+};
+
+/* stretch the source rows that end up in the destination rows from top to bottom */
+static void stretch_rows_band( void *arg, int top, int bottom )
+{
+    const struct stretch_band_params *params = arg;
+    POINT dst_start = params->dst_start, src_start = params->src_start;
+    unsigned int length = params->v_params.length;
+    int err = params->v_params.err_start;
+    int dst_inc = params->v_params.dst_inc;
+    BOOL in_band, rows_done = FALSE;
+
+    if (params->vstretch)
+    {
+        BOOL need_row = TRUE;
+        RECT last_row, this_row;
+        last_row.left = 0;
+        last_row.right = params->width;
+
+        while (length--)
+        {
+            in_band = dst_start.y >= top && dst_start.y < bottom;
+            if (in_band)
+            {
+                /* the first row of a band can't be copied from the previous band */
+                if (need_row || !rows_done)
+                {
+                    params->row_fn( params->dst_dib, &dst_start, params->src_dib, &src_start,
+                                    &params->h_params, params->mode, FALSE );
+                }
+                else
+                {
+                    last_row.top = dst_start.y - dst_inc;
+                    last_row.bottom = last_row.top + 1;
+                    this_row = last_row;
+                    offset_rect( &this_row, 0, dst_inc );
+                    copy_rect( params->dst_dib, &this_row, params->dst_dib, &last_row, NULL, R2_COPYPEN );
+                }
+                rows_done = TRUE;
+            }
+            else if (rows_done) break;
+            need_row = FALSE;
+
+            if (err > 0)
+            {
+                src_start.y += params->v_params.src_inc;
+                need_row = TRUE;
+                err += params->v_params.err_add_1;
+            }
+            else err += params->v_params.err_add_2;
+            dst_start.y += dst_inc;
+        }
+    }
+    else
+    {
+        int merged_rows = 0;
+
+        while (length--)
+        {
+            in_band = dst_start.y >= top && dst_start.y < bottom;
+            if (in_band)
+            {
+                if (params->mode != STRETCH_DELETESCANS || !merged_rows)
+                    params->row_fn( params->dst_dib, &dst_start, params->src_dib, &src_start,
+                                    &params->h_params, params->mode, merged_rows != 0 );
+                rows_done = TRUE;
+            }
+            else if (rows_done) break;
+            merged_rows++;
+
+            if (err > 0)
+            {
+                dst_start.y += dst_inc;
+                merged_rows = 0;
+                err += params->v_params.err_add_1;
+            }
+            else err += params->v_params.err_add_2;
+            src_start.y += params->v_params.src_inc;
+        }
+    }
+}
+
 DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                           const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                           INT mode )
@@ -1198,11 +1481,8 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     RECT rect;
     BOOL hstretch, vstretch;
     struct stretch_params v_params, h_params;
-    int err;
+    struct stretch_band_params params;
     DWORD ret;
-    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
-                    const dib_info *src_dib, const POINT *src_start,
-                    const struct stretch_params *params, int mode, BOOL keep_dst);
 
     TRACE("dst %d, %d - %d x %d visrect %s src %d, %d - %d x %d visrect %s\n",
           dst->x, dst->y, dst->width, dst->height, wine_dbgstr_rect(&dst->visrect),
@@ -1236,64 +1516,18 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     dst_start.x -= dst->visrect.left;
     dst_start.y -= dst->visrect.top;
 
-    err = v_params.err_start;
-
-    row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
-
-    if (vstretch)
-    {
-        BOOL need_row = TRUE;
-        RECT last_row, this_row;
-        if (hstretch) mode = STRETCH_DELETESCANS;
-        last_row.left = 0;
-        last_row.right = dst->visrect.right - dst->visrect.left;
-
-        while (v_params.length--)
-        {
-            if (need_row)
-            {
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, FALSE );
-                need_row = FALSE;
-            }
-            else
-            {
-                last_row.top = dst_start.y - v_params.dst_inc;
-                last_row.bottom = last_row.top + 1;
-                this_row = last_row;
-                offset_rect( &this_row, 0, v_params.dst_inc );
-                copy_rect( &dst_dib, &this_row, &dst_dib, &last_row, NULL, R2_COPYPEN );
-            }
-
-            if (err > 0)
-            {
-                src_start.y += v_params.src_inc;
-                need_row = TRUE;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            dst_start.y += v_params.dst_inc;
-        }
-    }
-    else
-    {
-        int merged_rows = 0;
-
-        while (v_params.length--)
-        {
-            if (mode != STRETCH_DELETESCANS || !merged_rows)
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, merged_rows != 0 );
-            merged_rows++;
-
-            if (err > 0)
-            {
-                dst_start.y += v_params.dst_inc;
-                merged_rows = 0;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            src_start.y += v_params.src_inc;
-        }
-    }
+    params.dst_dib   = &dst_dib;
+    params.src_dib   = &src_dib;
+    params.dst_start = dst_start;
+    params.src_start = src_start;
+    params.v_params  = v_params;
+    params.h_params  = h_params;
+    params.vstretch  = vstretch;
+    params.mode      = (vstretch && hstretch) ? STRETCH_DELETESCANS : mode;
+    params.width     = dst->visrect.right - dst->visrect.left;
+    params.row_fn    = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
+
+    run_in_bands( 0, dst->visrect.bottom - dst->visrect.top, params.width, stretch_rows_band, &params );
 
     /* update coordinates, the destination rectangle is always stored at 0,0 */
     *src = *dst;
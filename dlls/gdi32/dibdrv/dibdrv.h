@@ -257,6 +257,13 @@ extern void add_clipped_bounds( dibdrv_physdev *dev, const RECT *rect, HRGN clip
 extern int clip_line(const POINT *start, const POINT *end, const RECT *clip,
                      const bres_params *params, POINT *pt1, POINT *pt2) DECLSPEC_HIDDEN;
 extern void release_cached_font( struct cached_font *font ) DECLSPEC_HIDDEN;
+extern LONGLONG find_persistent_font( HDC hdc, const LOGFONTW *lf, const XFORM *xform,
+                                      UINT aa_flags ) DECLSPEC_HIDDEN;
+extern BOOL is_persistent_font_current( LONGLONG font ) DECLSPEC_HIDDEN;
+extern void *get_persistent_glyph( LONGLONG font, UINT index, UINT flags, int bit_count,
+                                   SIZE_T header_size, GLYPHMETRICS *metrics ) DECLSPEC_HIDDEN;
+extern void add_persistent_glyph( LONGLONG font, UINT index, UINT flags, const GLYPHMETRICS *metrics,
+                                  const BYTE *bits, DWORD size ) DECLSPEC_HIDDEN;
 
 static inline void init_clipped_rects( struct clipped_rects *clip_rects )
 {
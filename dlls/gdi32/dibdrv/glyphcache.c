@@ -0,0 +1,467 @@
+/*
+ * DIB driver persistent glyph cache
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * When the "GlyphCacheSize" value of the DIB Engine key is set (in megabytes),
+ * the rendered glyph bitmaps are also stored in a file of the Wine config
+ * directory, which is mapped shared by all the processes of the prefix. Glyphs
+ * are then only rasterized once, even by short-lived processes.
+ *
+ * Entries are never modified or removed once they have been added, so the file
+ * is accessed without locking: space is allocated by atomically incrementing
+ * the used size, and entries are linked at the head of their hash bucket with
+ * an atomic compare and exchange once they have been filled.
+ *
+ * The header records the FreeType version, the rendering settings and the Wine
+ * build that produced the glyphs, and a file that doesn't match them is
+ * discarded. When the file is full, it is replaced by an empty one; processes
+ * that still map the old file switch to the new one once theirs is full too.
+ * Font offsets are therefore returned along with the generation of the mapping
+ * they belong to, and become stale when the process maps another file.
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#ifdef HAVE_SYS_STAT_H
+# include <sys/stat.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+
+#include "gdi_private.h"
+#include "winreg.h"
+#include "dibdrv.h"
+
+#include "wine/library.h"
+#include "wine/unicode.h"
+#include "wine/debug.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(dib);
+
+#define GLYPH_CACHE_MAGIC    0x48434c47  /* "GLCH" */
+#define GLYPH_CACHE_VERSION  2
+#define GLYPH_CACHE_MAX_SIZE 1024        /* in megabytes */
+#define FONT_BUCKETS         0x100
+#define GLYPH_BUCKETS        0x10000
+#define MAX_CHAIN_LENGTH     1024        /* protection against corrupted files */
+
+#define MS_MAKE_TAG( _x1, _x2, _x3, _x4 ) \
+          ( ( (DWORD)_x4 << 24 ) |        \
+            ( (DWORD)_x3 << 16 ) |        \
+            ( (DWORD)_x2 <<  8 ) |        \
+              (DWORD)_x1         )
+
+#define MS_HEAD_TAG MS_MAKE_TAG('h', 'e', 'a', 'd')
+
+struct glyph_cache_header
+{
+    DWORD magic;                    /* GLYPH_CACHE_MAGIC */
+    DWORD version;                  /* GLYPH_CACHE_VERSION */
+    DWORD size;                     /* total size of the file */
+    LONG  used;                     /* size allocated so far */
+    DWORD ft_version;               /* FreeType version that rendered the glyphs */
+    DWORD render_flags;             /* WINE_RASTERIZER_* flags in effect */
+    char  build_id[64];             /* Wine build that created the file */
+    DWORD fonts[FONT_BUCKETS];      /* offsets of the first font of each bucket */
+    DWORD glyphs[GLYPH_BUCKETS];    /* offsets of the first glyph of each bucket */
+};
+
+struct glyph_cache_font_key
+{
+    LOGFONTW lf;                    /* logical font, with the face name zero-padded */
+    XFORM    xform;                 /* world to device transform */
+    UINT     aa_flags;              /* antialiasing mode */
+    WCHAR    face[LF_FACESIZE];     /* name of the face that was selected */
+    BYTE     head[36];              /* start of the 'head' table, identifies the font file version */
+};
+
+struct glyph_cache_font
+{
+    DWORD                       next;   /* offset of the next font in the bucket */
+    DWORD                       hash;   /* hash of the key */
+    struct glyph_cache_font_key key;
+};
+
+struct glyph_cache_glyph
+{
+    DWORD        next;              /* offset of the next glyph in the bucket */
+    DWORD        font;              /* offset of the font */
+    DWORD        index;             /* glyph index or character */
+    DWORD        flags;             /* ETO_GLYPH_INDEX if index is a glyph index */
+    DWORD        size;              /* size of the bits */
+    GLYPHMETRICS metrics;
+    BYTE         bits[1];
+};
+
+static INIT_ONCE init_once = INIT_ONCE_STATIC_INIT;
+static SRWLOCK cache_lock = SRWLOCK_INIT;  /* held exclusively only to switch to another file */
+static struct glyph_cache_header *cache;
+static DWORD cache_size;
+static DWORD cache_generation;     /* incremented every time another file is mapped */
+static dev_t cache_dev;
+static ino_t cache_ino;
+static char *cache_name;
+static DWORD cache_max_size;       /* size of newly created files */
+static DWORD ft_version;
+static DWORD render_flags;
+static char build_id[64];
+
+static inline BOOL is_cache_full( const struct glyph_cache_header *header, DWORD size )
+{
+    return (DWORD)header->used > size - size / 16;
+}
+
+/* map the existing cache file, if it is valid and not the one already in use */
+static struct glyph_cache_header *open_glyph_cache( const char *name )
+{
+    struct glyph_cache_header *header;
+    struct stat st;
+    int fd;
+
+    if ((fd = open( name, O_RDWR )) == -1) return NULL;
+    if (fstat( fd, &st ) || st.st_size < sizeof(*header) ||
+        st.st_size > (off_t)GLYPH_CACHE_MAX_SIZE << 20 ||
+        (cache && st.st_dev == cache_dev && st.st_ino == cache_ino) ||
+        (header = mmap( NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED)
+    {
+        close( fd );
+        return NULL;
+    }
+    close( fd );
+    if (header->magic == GLYPH_CACHE_MAGIC && header->version == GLYPH_CACHE_VERSION &&
+        header->size == st.st_size && header->ft_version == ft_version &&
+        header->render_flags == render_flags &&
+        !memcmp( header->build_id, build_id, sizeof(build_id) ) &&
+        !is_cache_full( header, st.st_size ))
+    {
+        cache_size = st.st_size;
+        cache_dev  = st.st_dev;
+        cache_ino  = st.st_ino;
+        return header;
+    }
+    TRACE( "discarding %s\n", debugstr_a(name) );
+    munmap( header, st.st_size );
+    return NULL;
+}
+
+/* create an empty cache file, atomically replacing the existing one */
+static struct glyph_cache_header *create_glyph_cache( const char *name, DWORD size )
+{
+    struct glyph_cache_header *header = NULL;
+    struct stat st;
+    char *tmp;
+    int fd;
+
+    if (!(tmp = HeapAlloc( GetProcessHeap(), 0, strlen(name) + sizeof(".XXXXXX") ))) return NULL;
+    sprintf( tmp, "%s.XXXXXX", name );
+    if ((fd = mkstemp( tmp )) != -1)
+    {
+        if (!ftruncate( fd, size ) && !fstat( fd, &st ) &&
+            (header = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) != MAP_FAILED)
+        {
+            header->magic        = GLYPH_CACHE_MAGIC;
+            header->version      = GLYPH_CACHE_VERSION;
+            header->size         = size;
+            header->used         = sizeof(*header);
+            header->ft_version   = ft_version;
+            header->render_flags = render_flags;
+            memcpy( header->build_id, build_id, sizeof(build_id) );
+            if (!rename( tmp, name ))
+            {
+                cache_size = size;
+                cache_dev  = st.st_dev;
+                cache_ino  = st.st_ino;
+            }
+            else
+            {
+                munmap( header, size );
+                header = NULL;
+            }
+        }
+        else header = NULL;
+        if (!header) unlink( tmp );
+        close( fd );
+    }
+    HeapFree( GetProcessHeap(), 0, tmp );
+    return header;
+}
+
+/* map the cache file, creating it if it doesn't exist or isn't valid */
+static struct glyph_cache_header *map_glyph_cache(void)
+{
+    struct glyph_cache_header *header;
+
+    if (!(header = open_glyph_cache( cache_name ))) header = create_glyph_cache( cache_name, cache_max_size );
+    if (header)
+    {
+        cache_generation++;
+        TRACE( "using %s, %u/%u bytes used\n", debugstr_a(cache_name), (DWORD)header->used, cache_size );
+    }
+    else WARN( "failed to map %s\n", debugstr_a(cache_name) );
+    return header;
+}
+
+/* switch to a new file once the mapped one is full */
+static void reset_glyph_cache( DWORD generation )
+{
+    struct glyph_cache_header *old;
+    DWORD old_size;
+
+    AcquireSRWLockExclusive( &cache_lock );
+    if (cache && cache_generation == generation)
+    {
+        old = cache;
+        old_size = cache_size;
+        if (!(cache = map_glyph_cache())) cache_size = 0;
+        munmap( old, old_size );
+    }
+    ReleaseSRWLockExclusive( &cache_lock );
+}
+
+static BOOL WINAPI init_glyph_cache( INIT_ONCE *once, void *param, void **context )
+{
+    static const WCHAR dib_engineW[] = {'S','o','f','t','w','a','r','e','\\','W','i','n','e','\\',
+                                        'D','I','B',' ','E','n','g','i','n','e',0};
+    static const WCHAR glyph_cache_sizeW[] = {'G','l','y','p','h','C','a','c','h','e','S','i','z','e',0};
+    static const char filename[] = "/glyphcache";
+    const char *config_dir = wine_get_config_dir();
+    WCHAR buffer[16] = {0};
+    DWORD type, size = sizeof(buffer) - sizeof(WCHAR);
+    HKEY hkey;
+    int mb = 0;
+
+    if (!RegOpenKeyW( HKEY_CURRENT_USER, dib_engineW, &hkey ))
+    {
+        if (!RegQueryValueExW( hkey, glyph_cache_sizeW, NULL, &type, (BYTE *)buffer, &size ) &&
+            type == REG_SZ)
+            mb = atoiW( buffer );
+        RegCloseKey( hkey );
+    }
+    if (mb <= 0 || !config_dir) return TRUE;
+    if (mb > GLYPH_CACHE_MAX_SIZE) mb = GLYPH_CACHE_MAX_SIZE;
+    if (!WineEngGetRasterizerInfo( &ft_version, &render_flags )) return TRUE;
+    lstrcpynA( build_id, wine_get_build_id(), sizeof(build_id) );
+
+    if (!(cache_name = HeapAlloc( GetProcessHeap(), 0, strlen(config_dir) + sizeof(filename) ))) return TRUE;
+    strcpy( cache_name, config_dir );
+    strcat( cache_name, filename );
+    cache_max_size = mb << 20;
+    cache = map_glyph_cache();
+    return TRUE;
+}
+
+/* return a pointer to an entry of the cache, or NULL if the offset is invalid */
+static void *get_cache_entry( DWORD offset, DWORD size )
+{
+    if (offset < sizeof(*cache) || offset > cache_size || cache_size - offset < size) return NULL;
+    return (char *)cache + offset;
+}
+
+/* allocate space for an entry, return its offset or 0 if the cache is full */
+static DWORD alloc_cache_entry( DWORD size, BOOL *full )
+{
+    LONG offset;
+
+    if (size > cache_size - 8) return 0;
+    size = (size + 7) & ~7;
+    if ((DWORD)cache->used > cache_size - size) offset = cache_size;
+    else offset = InterlockedExchangeAdd( &cache->used, size );
+    if ((DWORD)offset <= cache_size - size) return offset;
+    *full = TRUE;
+    return 0;
+}
+
+/* link an entry at the head of a bucket, once it has been completely filled */
+static void publish_cache_entry( DWORD *bucket, DWORD *next, DWORD offset )
+{
+    DWORD head;
+
+    do *next = head = *(volatile DWORD *)bucket;
+    while ((DWORD)InterlockedCompareExchange( (LONG *)bucket, offset, head ) != head);
+}
+
+static DWORD hash_data( const void *data, DWORD size )
+{
+    const BYTE *ptr = data;
+    DWORD hash = 2166136261u;
+
+    while (size--) hash = (hash ^ *ptr++) * 16777619;
+    return hash;
+}
+
+static DWORD glyph_bucket( DWORD font, UINT index, UINT flags )
+{
+    return ((font * 2654435761u) ^ (index << 1) ^ !!(flags & ETO_GLYPH_INDEX)) % GLYPH_BUCKETS;
+}
+
+/***********************************************************************
+ *         find_persistent_font
+ *
+ * Return the font in the persistent cache, adding it if necessary: its offset
+ * in the low part, and the generation of the mapping in the high part.
+ * Return 0 if the cache is disabled, or for fonts that are not TrueType.
+ */
+LONGLONG find_persistent_font( HDC hdc, const LOGFONTW *lf, const XFORM *xform, UINT aa_flags )
+{
+    struct glyph_cache_font_key key;
+    struct glyph_cache_font *font;
+    DWORD hash, offset, generation = 0, *bucket;
+    LONGLONG ret = 0;
+    BOOL full = FALSE;
+    int i;
+
+    InitOnceExecuteOnce( &init_once, init_glyph_cache, NULL, NULL );
+    if (!cache_name) return 0;
+
+    memset( &key, 0, sizeof(key) );
+    key.lf = *lf;
+    memset( key.lf.lfFaceName, 0, sizeof(key.lf.lfFaceName) );
+    lstrcpynW( key.lf.lfFaceName, lf->lfFaceName, LF_FACESIZE );
+    key.xform = *xform;
+    key.aa_flags = aa_flags;
+    if (!GetTextFaceW( hdc, LF_FACESIZE, key.face )) return 0;
+    if (GetFontData( hdc, MS_HEAD_TAG, 0, key.head, sizeof(key.head) ) != sizeof(key.head)) return 0;
+    hash = hash_data( &key, sizeof(key) );
+
+    AcquireSRWLockShared( &cache_lock );
+    if (!cache) goto done;
+    generation = cache_generation;
+    bucket = &cache->fonts[hash % FONT_BUCKETS];
+
+    for (i = 0, offset = *bucket; offset && i < MAX_CHAIN_LENGTH; i++, offset = font->next)
+    {
+        if (!(font = get_cache_entry( offset, sizeof(*font) ))) goto done;
+        if (font->hash == hash && !memcmp( &font->key, &key, sizeof(key) ))
+        {
+            ret = ((LONGLONG)generation << 32) | offset;
+            goto done;
+        }
+    }
+
+    if (!(offset = alloc_cache_entry( sizeof(*font), &full ))) goto done;
+    font = get_cache_entry( offset, sizeof(*font) );
+    font->hash = hash;
+    font->key = key;
+    publish_cache_entry( bucket, &font->next, offset );
+    TRACE( "added %s %d at %x\n", debugstr_w(key.face), lf->lfHeight, offset );
+    ret = ((LONGLONG)generation << 32) | offset;
+
+done:
+    ReleaseSRWLockShared( &cache_lock );
+    if (full)
+    {
+        reset_glyph_cache( generation );
+        return find_persistent_font( hdc, lf, xform, aa_flags );
+    }
+    return ret;
+}
+
+/***********************************************************************
+ *         is_persistent_font_current
+ *
+ * Check that a font returned by find_persistent_font belongs to the mapped file.
+ */
+BOOL is_persistent_font_current( LONGLONG font )
+{
+    return (DWORD)(font >> 32) == *(volatile DWORD *)&cache_generation;
+}
+
+/***********************************************************************
+ *         get_persistent_glyph
+ *
+ * Look up a glyph in the persistent cache. Return a heap block of the given
+ * header size followed by a copy of the bits, since the file may be unmapped
+ * once the lock is released. The size of the bits must match the metrics for
+ * the given depth, since the file can be written by any process.
+ */
+void *get_persistent_glyph( LONGLONG font, UINT index, UINT flags, int bit_count,
+                            SIZE_T header_size, GLYPHMETRICS *metrics )
+{
+    struct glyph_cache_glyph *glyph;
+    GLYPHMETRICS glyph_metrics;
+    DWORD offset, glyph_size;
+    BYTE *ret = NULL;
+    int i;
+
+    flags &= ETO_GLYPH_INDEX;
+    AcquireSRWLockShared( &cache_lock );
+    if (!cache || (DWORD)(font >> 32) != cache_generation) goto done;
+
+    offset = cache->glyphs[glyph_bucket( (DWORD)font, index, flags )];
+    for (i = 0; offset && i < MAX_CHAIN_LENGTH; i++, offset = glyph->next)
+    {
+        if (!(glyph = get_cache_entry( offset, FIELD_OFFSET( struct glyph_cache_glyph, bits ) ))) break;
+        if (glyph->font != (DWORD)font || glyph->index != index || glyph->flags != flags) continue;
+
+        /* read the entry only once, the checks must apply to what is returned */
+        glyph_size    = glyph->size;
+        glyph_metrics = glyph->metrics;
+        if (glyph_metrics.gmBlackBoxX > 0xffff || glyph_metrics.gmBlackBoxY > 0xffff) break;
+        if (glyph_size != (ULONGLONG)glyph_metrics.gmBlackBoxY *
+            get_dib_stride( glyph_metrics.gmBlackBoxX, bit_count )) break;
+        if (glyph_size > cache_size ||
+            !get_cache_entry( offset, FIELD_OFFSET( struct glyph_cache_glyph, bits[glyph_size] ) )) break;
+        if (!(ret = HeapAlloc( GetProcessHeap(), 0, header_size + glyph_size ))) break;
+        memcpy( ret + header_size, glyph->bits, glyph_size );
+        *metrics = glyph_metrics;
+        break;
+    }
+done:
+    ReleaseSRWLockShared( &cache_lock );
+    return ret;
+}
+
+/***********************************************************************
+ *         add_persistent_glyph
+ *
+ * Store a rendered glyph in the persistent cache.
+ */
+void add_persistent_glyph( LONGLONG font, UINT index, UINT flags, const GLYPHMETRICS *metrics,
+                           const BYTE *bits, DWORD size )
+{
+    struct glyph_cache_glyph *glyph;
+    DWORD offset, generation = font >> 32;
+    BOOL full = FALSE;
+
+    AcquireSRWLockShared( &cache_lock );
+    if (cache && generation == cache_generation &&
+        (offset = alloc_cache_entry( FIELD_OFFSET( struct glyph_cache_glyph, bits[size] ), &full )))
+    {
+        glyph = get_cache_entry( offset, FIELD_OFFSET( struct glyph_cache_glyph, bits[size] ));
+        glyph->font    = (DWORD)font;
+        glyph->index   = index;
+        glyph->flags   = flags & ETO_GLYPH_INDEX;
+        glyph->size    = size;
+        glyph->metrics = *metrics;
+        memcpy( glyph->bits, bits, size );
+        publish_cache_entry( &cache->glyphs[glyph_bucket( (DWORD)font, index, flags & ETO_GLYPH_INDEX )],
+                             &glyph->next, offset );
+    }
+    ReleaseSRWLockShared( &cache_lock );
+    if (full) reset_glyph_cache( generation );
+}
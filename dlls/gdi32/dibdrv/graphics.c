@@ -51,6 +51,7 @@ struct cached_font
     LOGFONTW              lf;
     XFORM                 xform;
     UINT                  aa_flags;
+    LONGLONG              disk_font;  /* font in the persistent glyph cache, 0 if none, -1 if not looked up */
     struct cached_glyph **glyphs[GLYPH_NBTYPES][GLYPH_CACHE_PAGES];
 };
 
@@ -568,6 +569,7 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
     }
     font.lf.lfWidth = abs( font.lf.lfWidth );
     font.aa_flags = aa_flags;
+    font.disk_font = -1;
     font.hash = font_cache_hash( &font );
 
     EnterCriticalSection( &font_cache_cs );
@@ -754,6 +756,24 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
     int pad = 0, stride, bit_count;
     GLYPHMETRICS metrics;
     struct cached_glyph *glyph;
+    LONGLONG disk_font;
+
+    bit_count = get_glyph_depth( font->aa_flags );
+    /* the font can be shared by several threads, access the 64-bit value atomically */
+    disk_font = InterlockedCompareExchange64( &font->disk_font, 0, 0 );
+    if (disk_font == -1 || (disk_font && !is_persistent_font_current( disk_font )))
+    {
+        LONGLONG prev = disk_font;
+        disk_font = find_persistent_font( dc->hSelf, &font->lf, &font->xform, font->aa_flags );
+        InterlockedCompareExchange64( &font->disk_font, disk_font, prev );
+    }
+    if (disk_font &&
+        (glyph = get_persistent_glyph( disk_font, index, flags, bit_count,
+                                       FIELD_OFFSET( struct cached_glyph, bits ), &metrics )))
+    {
+        glyph->metrics = metrics;
+        return add_cached_glyph( font, index, flags, glyph );
+    }
 
     if (flags & ETO_GLYPH_INDEX) ggo_flags |= GGO_GLYPH_INDEX;
     indices[0] = index;
@@ -766,7 +786,6 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
     if (ret == GDI_ERROR) return NULL;
     if (!ret) metrics.gmBlackBoxX = metrics.gmBlackBoxY = 0; /* empty glyph */
 
-    bit_count = get_glyph_depth( font->aa_flags );
     stride = get_dib_stride( metrics.gmBlackBoxX, bit_count );
     size = metrics.gmBlackBoxY * stride;
     glyph = HeapAlloc( GetProcessHeap(), 0, FIELD_OFFSET( struct cached_glyph, bits[size] ));
@@ -803,6 +822,7 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
 
 done:
     glyph->metrics = metrics;
+    if (disk_font) add_persistent_glyph( disk_font, index, flags, &metrics, glyph->bits, size );
     return add_cached_glyph( font, index, flags, glyph );
 }
 
@@ -19,6 +19,12 @@
  */
 
 #include <assert.h>
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define USE_X86_SIMD
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 #include "gdi_private.h"
 #include "dibdrv.h"
@@ -27,6 +33,56 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(dib);
 
+#ifdef USE_X86_SIMD
+
+/* the vector code is compiled for its target and selected at run time */
+#ifdef __i386__
+#define SIMD_TARGET(x) __attribute__((target(x),force_align_arg_pointer))
+#else
+#define SIMD_TARGET(x) __attribute__((target(x)))
+#endif
+#define SSE2_FUNC SIMD_TARGET("sse2")
+#define AVX2_FUNC SIMD_TARGET("avx2")
+
+enum simd_level
+{
+    SIMD_NONE,
+    SIMD_SSE2,
+    SIMD_AVX2
+};
+
+static enum simd_level simd_level;
+
+static enum simd_level get_cpu_simd_level(void)
+{
+    unsigned int eax, ebx, ecx, edx, xcr0_lo, xcr0_hi;
+
+    if (!__get_cpuid( 1, &eax, &ebx, &ecx, &edx )) return SIMD_NONE;
+    if (!(edx & bit_SSE2)) return SIMD_NONE;
+    /* the OS must save the AVX registers */
+    if ((ecx & (bit_OSXSAVE | bit_AVX)) != (bit_OSXSAVE | bit_AVX)) return SIMD_SSE2;
+    __asm__( ".byte 0x0f, 0x01, 0xd0" /* xgetbv */ : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0) );
+    if ((xcr0_lo & 6) != 6) return SIMD_SSE2;
+    if (__get_cpuid_max( 0, NULL ) < 7) return SIMD_SSE2;
+    __cpuid_count( 7, 0, eax, ebx, ecx, edx );
+    return (ebx & bit_AVX2) ? SIMD_AVX2 : SIMD_SSE2;
+}
+
+#endif  /* USE_X86_SIMD */
+
+/***********************************************************************
+ *           init_dib_primitives
+ *
+ * Select the vector versions of the primitives supported by the CPU.
+ */
+void init_dib_primitives(void)
+{
+#ifdef USE_X86_SIMD
+    simd_level = get_cpu_simd_level();
+    TRACE( "using %s\n", simd_level == SIMD_AVX2 ? "AVX2" : simd_level == SIMD_SSE2 ? "SSE2" : "no SIMD" );
+#endif
+}
+
 /* Bayer matrices for dithering */
 
 static const BYTE bayer_4x4[4][4] =
@@ -264,6 +320,130 @@ static inline void memset_16( WORD *start, WORD val, DWORD size )
 #endif
 }
 
+#ifdef USE_X86_SIMD
+
+/* apply a rop to 4 pixels at a time, return the number of pixels done */
+static SSE2_FUNC int do_rop_line_32_sse2( DWORD *ptr, int len, DWORD and, DWORD xor )
+{
+    __m128i and_vec = _mm_set1_epi32( and ), xor_vec = _mm_set1_epi32( xor );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4, ptr += 4)
+    {
+        __m128i val = _mm_loadu_si128( (__m128i *)ptr );
+        _mm_storeu_si128( (__m128i *)ptr, _mm_xor_si128( _mm_and_si128( val, and_vec ), xor_vec ));
+    }
+    return x;
+}
+
+/* apply a rop to groups of 16 24-bpp pixels (12 DWORDs) starting on a DWORD triplet,
+ * return the number of pixels done */
+static SSE2_FUNC int do_rop_line_24_sse2( DWORD *ptr, int len, const DWORD *and_masks, const DWORD *xor_masks )
+{
+    __m128i and_vec[3], xor_vec[3], val;
+    int i, x;
+
+    for (i = 0; i < 3; i++)
+    {
+        and_vec[i] = _mm_setr_epi32( and_masks[i], and_masks[(i + 1) % 3],
+                                     and_masks[(i + 2) % 3], and_masks[i] );
+        xor_vec[i] = _mm_setr_epi32( xor_masks[i], xor_masks[(i + 1) % 3],
+                                     xor_masks[(i + 2) % 3], xor_masks[i] );
+    }
+
+    if (!(and_masks[0] | and_masks[1] | and_masks[2]))
+    {
+        for (x = 0; x + 16 <= len; x += 16)
+            for (i = 0; i < 3; i++, ptr += 4) _mm_storeu_si128( (__m128i *)ptr, xor_vec[i] );
+        return x;
+    }
+
+    for (x = 0; x + 16 <= len; x += 16)
+    {
+        for (i = 0; i < 3; i++, ptr += 4)
+        {
+            val = _mm_loadu_si128( (__m128i *)ptr );
+            val = _mm_xor_si128( _mm_and_si128( val, and_vec[i] ), xor_vec[i] );
+            _mm_storeu_si128( (__m128i *)ptr, val );
+        }
+    }
+    return x;
+}
+
+/* apply a rop to 8 pixels at a time, return the number of pixels done */
+static AVX2_FUNC int do_rop_line_32_avx2( DWORD *ptr, int len, DWORD and, DWORD xor )
+{
+    __m256i and_vec = _mm256_set1_epi32( and ), xor_vec = _mm256_set1_epi32( xor );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8, ptr += 8)
+    {
+        __m256i val = _mm256_loadu_si256( (__m256i *)ptr );
+        _mm256_storeu_si256( (__m256i *)ptr, _mm256_xor_si256( _mm256_and_si256( val, and_vec ), xor_vec ));
+    }
+    return x;
+}
+
+/* apply a rop to groups of 32 24-bpp pixels (24 DWORDs) starting on a DWORD triplet,
+ * return the number of pixels done */
+static AVX2_FUNC int do_rop_line_24_avx2( DWORD *ptr, int len, const DWORD *and_masks, const DWORD *xor_masks )
+{
+    DWORD and_pattern[24], xor_pattern[24];
+    __m256i and_vec[3], xor_vec[3], val;
+    int i, x;
+
+    for (i = 0; i < 24; i++)
+    {
+        and_pattern[i] = and_masks[i % 3];
+        xor_pattern[i] = xor_masks[i % 3];
+    }
+    for (i = 0; i < 3; i++)
+    {
+        and_vec[i] = _mm256_loadu_si256( (const __m256i *)and_pattern + i );
+        xor_vec[i] = _mm256_loadu_si256( (const __m256i *)xor_pattern + i );
+    }
+
+    if (!(and_masks[0] | and_masks[1] | and_masks[2]))
+    {
+        for (x = 0; x + 32 <= len; x += 32)
+            for (i = 0; i < 3; i++, ptr += 8) _mm256_storeu_si256( (__m256i *)ptr, xor_vec[i] );
+        return x;
+    }
+
+    for (x = 0; x + 32 <= len; x += 32)
+    {
+        for (i = 0; i < 3; i++, ptr += 8)
+        {
+            val = _mm256_loadu_si256( (__m256i *)ptr );
+            val = _mm256_xor_si256( _mm256_and_si256( val, and_vec[i] ), xor_vec[i] );
+            _mm256_storeu_si256( (__m256i *)ptr, val );
+        }
+    }
+    return x;
+}
+
+#endif  /* USE_X86_SIMD */
+
+/* apply a rop to the start of a 32-bpp line with vector instructions, return the number of pixels done */
+static inline int do_rop_line_32_simd( DWORD *ptr, int len, DWORD and, DWORD xor )
+{
+#ifdef USE_X86_SIMD
+    if (simd_level == SIMD_AVX2) return do_rop_line_32_avx2( ptr, len, and, xor );
+    if (simd_level == SIMD_SSE2) return do_rop_line_32_sse2( ptr, len, and, xor );
+#endif
+    return 0;
+}
+
+/* apply a rop to the start of a 24-bpp line with vector instructions, return the number of pixels done */
+static inline int do_rop_line_24_simd( DWORD *ptr, int len, const DWORD *and_masks, const DWORD *xor_masks )
+{
+#ifdef USE_X86_SIMD
+    if (simd_level == SIMD_AVX2) return do_rop_line_24_avx2( ptr, len, and_masks, xor_masks );
+    if (simd_level == SIMD_SSE2) return do_rop_line_24_sse2( ptr, len, and_masks, xor_masks );
+#endif
+    return 0;
+}
+
 static void solid_rects_32(const dib_info *dib, int num, const RECT *rc, DWORD and, DWORD xor)
 {
     DWORD *ptr, *start;
@@ -276,8 +456,14 @@ static void solid_rects_32(const dib_info *dib, int num, const RECT *rc, DWORD a
         start = get_pixel_ptr_32(dib, rc->left, rc->top);
         if (and)
             for(y = rc->top; y < rc->bottom; y++, start += dib->stride / 4)
-                for(x = rc->left, ptr = start; x < rc->right; x++)
+            {
+                x = rc->left;
+                ptr = start;
+                x += do_rop_line_32_simd( ptr, rc->right - rc->left, and, xor );
+                ptr += x - rc->left;
+                for(; x < rc->right; x++)
                     do_rop_32(ptr++, and, xor);
+            }
         else
             for(y = rc->top; y < rc->bottom; y++, start += dib->stride / 4)
                 memset_32( start, xor, rc->right - rc->left );
@@ -341,7 +527,13 @@ static void solid_rects_24(const dib_info *dib, int num, const RECT *rc, DWORD a
                     break;
                 }
 
-                for(x = (left + 3) & ~3; x < (right & ~3); x += 4)
+                x = (left + 3) & ~3;
+                {
+                    int done = do_rop_line_24_simd( ptr, (right & ~3) - x, and_masks, xor_masks );
+                    x += done;
+                    ptr += done / 4 * 3;
+                }
+                for(; x < (right & ~3); x += 4)
                 {
                     do_rop_32(ptr++, and_masks[0], xor_masks[0]);
                     do_rop_32(ptr++, and_masks[1], xor_masks[1]);
@@ -388,7 +580,13 @@ static void solid_rects_24(const dib_info *dib, int num, const RECT *rc, DWORD a
                     break;
                 }
 
-                for(x = (left + 3) & ~3; x < (right & ~3); x += 4)
+                x = (left + 3) & ~3;
+                {
+                    int done = do_rop_line_24_simd( ptr, (right & ~3) - x, and_masks, xor_masks );
+                    x += done;
+                    ptr += done / 4 * 3;
+                }
+                for(; x < (right & ~3); x += 4)
                 {
                     *ptr++ = xor_masks[0];
                     *ptr++ = xor_masks[1];
@@ -4601,14 +4799,6 @@ static inline DWORD blend_argb_constant_alpha( DWORD dst, DWORD src, DWORD alpha
             blend_color( dst >> 24, src >> 24, alpha ) << 24);
 }
 
-static inline DWORD blend_argb_no_src_alpha( DWORD dst, DWORD src, DWORD alpha )
-{
-    return (blend_color( dst, src, alpha ) |
-            blend_color( dst >> 8, src >> 8, alpha ) << 8 |
-            blend_color( dst >> 16, src >> 16, alpha ) << 16 |
-            blend_color( dst >> 24, 255, alpha ) << 24);
-}
-
 static inline DWORD blend_argb( DWORD dst, DWORD src )
 {
     BYTE b = (BYTE)src;
@@ -4651,32 +4841,216 @@ static inline DWORD blend_rgb( BYTE dst_r, BYTE dst_g, BYTE dst_b, DWORD src, BL
             blend_color( dst_r, src >> 16, blend.SourceConstantAlpha ) << 16);
 }
 
+#ifdef USE_X86_SIMD
+
+/* divide 16-bit values (x + 127) by 255, exact for x <= 255 * 255 */
+static inline SSE2_FUNC __m128i div255_epu16( __m128i val )
+{
+    val = _mm_add_epi16( _mm_add_epi16( val, _mm_set1_epi16( 1 )), _mm_srli_epi16( val, 8 ));
+    return _mm_srli_epi16( val, 8 );
+}
+
+/* blend_color() on 8 channels at a time */
+static inline SSE2_FUNC __m128i blend_color_sse2( __m128i dst, __m128i src, __m128i alpha, __m128i inv_alpha )
+{
+    __m128i val = _mm_add_epi16( _mm_mullo_epi16( src, alpha ), _mm_mullo_epi16( dst, inv_alpha ));
+    return div255_epu16( _mm_add_epi16( val, _mm_set1_epi16( 127 )));
+}
+
+/* blend_argb_constant_alpha() on 4 pixels at a time, return the number of pixels done */
+static SSE2_FUNC int blend_line_constant_alpha_sse2( DWORD *dst, const DWORD *src, int len,
+                                                     DWORD alpha, DWORD src_mask )
+{
+    __m128i zero = _mm_setzero_si128(), mask = _mm_set1_epi32( src_mask );
+    __m128i alpha_vec = _mm_set1_epi16( alpha ), inv_alpha = _mm_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_or_si128( _mm_loadu_si128( (const __m128i *)(src + x) ), mask );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = blend_color_sse2( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ),
+                                       alpha_vec, inv_alpha );
+        __m128i hi = blend_color_sse2( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ),
+                                       alpha_vec, inv_alpha );
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+/* blend_argb() on 2 pixels with 16-bit channels, return the per-channel sums */
+static inline SSE2_FUNC __m128i blend_argb_sse2( __m128i dst, __m128i src )
+{
+    __m128i alpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( src, 0xff ), 0xff );
+    __m128i val = _mm_mullo_epi16( dst, _mm_sub_epi16( _mm_set1_epi16( 255 ), alpha ));
+    return _mm_add_epi16( src, div255_epu16( _mm_add_epi16( val, _mm_set1_epi16( 127 ))));
+}
+
+/* blend_argb_alpha() on 4 pixels at a time, return the number of pixels done */
+static SSE2_FUNC int blend_line_argb_sse2( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    __m128i zero = _mm_setzero_si128(), max = _mm_set1_epi16( 255 ), alpha_vec = _mm_set1_epi16( alpha );
+    __m128i lo, hi;
+    int x, i;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+
+        lo = _mm_unpacklo_epi8( s, zero );
+        hi = _mm_unpackhi_epi8( s, zero );
+        if (alpha != 255)
+        {
+            lo = div255_epu16( _mm_add_epi16( _mm_mullo_epi16( lo, alpha_vec ), _mm_set1_epi16( 127 )));
+            hi = div255_epu16( _mm_add_epi16( _mm_mullo_epi16( hi, alpha_vec ), _mm_set1_epi16( 127 )));
+        }
+        lo = blend_argb_sse2( _mm_unpacklo_epi8( d, zero ), lo );
+        hi = blend_argb_sse2( _mm_unpackhi_epi8( d, zero ), hi );
+
+        /* channels larger than alpha overflow into the next one, leave that to the C version */
+        if (_mm_movemask_epi8( _mm_or_si128( _mm_cmpgt_epi16( lo, max ), _mm_cmpgt_epi16( hi, max ))))
+        {
+            for (i = x; i < x + 4; i++) dst[i] = blend_argb_alpha( dst[i], src[i], alpha );
+            continue;
+        }
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+/* div255_epu16() on 16 values at a time */
+static inline AVX2_FUNC __m256i div255_epu16_avx2( __m256i val )
+{
+    val = _mm256_add_epi16( _mm256_add_epi16( val, _mm256_set1_epi16( 1 )), _mm256_srli_epi16( val, 8 ));
+    return _mm256_srli_epi16( val, 8 );
+}
+
+/* blend_color() on 16 channels at a time */
+static inline AVX2_FUNC __m256i blend_color_avx2( __m256i dst, __m256i src, __m256i alpha, __m256i inv_alpha )
+{
+    __m256i val = _mm256_add_epi16( _mm256_mullo_epi16( src, alpha ), _mm256_mullo_epi16( dst, inv_alpha ));
+    return div255_epu16_avx2( _mm256_add_epi16( val, _mm256_set1_epi16( 127 )));
+}
+
+/* blend_argb_constant_alpha() on 8 pixels at a time, return the number of pixels done */
+static AVX2_FUNC int blend_line_constant_alpha_avx2( DWORD *dst, const DWORD *src, int len,
+                                                     DWORD alpha, DWORD src_mask )
+{
+    __m256i zero = _mm256_setzero_si256(), mask = _mm256_set1_epi32( src_mask );
+    __m256i alpha_vec = _mm256_set1_epi16( alpha ), inv_alpha = _mm256_set1_epi16( 255 - alpha );
+    int x;
+
+    /* the unpack and pack operations work within 128-bit lanes, so the pixel order is preserved */
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_or_si256( _mm256_loadu_si256( (const __m256i *)(src + x) ), mask );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = blend_color_avx2( _mm256_unpacklo_epi8( d, zero ), _mm256_unpacklo_epi8( s, zero ),
+                                       alpha_vec, inv_alpha );
+        __m256i hi = blend_color_avx2( _mm256_unpackhi_epi8( d, zero ), _mm256_unpackhi_epi8( s, zero ),
+                                       alpha_vec, inv_alpha );
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+/* blend_argb() on 4 pixels with 16-bit channels, return the per-channel sums */
+static inline AVX2_FUNC __m256i blend_argb_avx2( __m256i dst, __m256i src )
+{
+    __m256i alpha = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( src, 0xff ), 0xff );
+    __m256i val = _mm256_mullo_epi16( dst, _mm256_sub_epi16( _mm256_set1_epi16( 255 ), alpha ));
+    return _mm256_add_epi16( src, div255_epu16_avx2( _mm256_add_epi16( val, _mm256_set1_epi16( 127 ))));
+}
+
+/* blend_argb_alpha() on 8 pixels at a time, return the number of pixels done */
+static AVX2_FUNC int blend_line_argb_avx2( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    __m256i zero = _mm256_setzero_si256(), max = _mm256_set1_epi16( 255 );
+    __m256i alpha_vec = _mm256_set1_epi16( alpha );
+    __m256i lo, hi;
+    int x, i;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_loadu_si256( (const __m256i *)(src + x) );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+
+        lo = _mm256_unpacklo_epi8( s, zero );
+        hi = _mm256_unpackhi_epi8( s, zero );
+        if (alpha != 255)
+        {
+            lo = div255_epu16_avx2( _mm256_add_epi16( _mm256_mullo_epi16( lo, alpha_vec ), _mm256_set1_epi16( 127 )));
+            hi = div255_epu16_avx2( _mm256_add_epi16( _mm256_mullo_epi16( hi, alpha_vec ), _mm256_set1_epi16( 127 )));
+        }
+        lo = blend_argb_avx2( _mm256_unpacklo_epi8( d, zero ), lo );
+        hi = blend_argb_avx2( _mm256_unpackhi_epi8( d, zero ), hi );
+
+        /* channels larger than alpha overflow into the next one, leave that to the C version */
+        if (_mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpgt_epi16( lo, max ), _mm256_cmpgt_epi16( hi, max ))))
+        {
+            for (i = x; i < x + 8; i++) dst[i] = blend_argb_alpha( dst[i], src[i], alpha );
+            continue;
+        }
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+#endif  /* USE_X86_SIMD */
+
+/* blend the start of a line with vector instructions, return the number of pixels done */
+static inline int blend_line_argb_simd( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+#ifdef USE_X86_SIMD
+    if (simd_level == SIMD_AVX2) return blend_line_argb_avx2( dst, src, len, alpha );
+    if (simd_level == SIMD_SSE2) return blend_line_argb_sse2( dst, src, len, alpha );
+#endif
+    return 0;
+}
+
+static inline int blend_line_constant_alpha_simd( DWORD *dst, const DWORD *src, int len,
+                                                  DWORD alpha, DWORD src_mask )
+{
+#ifdef USE_X86_SIMD
+    if (simd_level == SIMD_AVX2) return blend_line_constant_alpha_avx2( dst, src, len, alpha, src_mask );
+    if (simd_level == SIMD_SSE2) return blend_line_constant_alpha_sse2( dst, src, len, alpha, src_mask );
+#endif
+    return 0;
+}
+
 static void blend_rect_8888(const dib_info *dst, const RECT *rc,
                             const dib_info *src, const POINT *origin, BLENDFUNCTION blend)
 {
     DWORD *src_ptr = get_pixel_ptr_32( src, origin->x, origin->y );
     DWORD *dst_ptr = get_pixel_ptr_32( dst, rc->left, rc->top );
-    int x, y;
+    int x, y, width = rc->right - rc->left;
+    DWORD src_mask = 0;
 
     if (blend.AlphaFormat & AC_SRC_ALPHA)
     {
-	if (blend.SourceConstantAlpha == 255)
-	    for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-		for (x = 0; x < rc->right - rc->left; x++)
-		    dst_ptr[x] = blend_argb( dst_ptr[x], src_ptr[x] );
-        else
-	    for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-		for (x = 0; x < rc->right - rc->left; x++)
-		    dst_ptr[x] = blend_argb_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
-    }
-    else if (src->compression == BI_RGB)
-	for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-	    for (x = 0; x < rc->right - rc->left; x++)
-		dst_ptr[x] = blend_argb_constant_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
-    else
-	for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-	    for (x = 0; x < rc->right - rc->left; x++)
-		dst_ptr[x] = blend_argb_no_src_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
+        for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
+        {
+            x = blend_line_argb_simd( dst_ptr, src_ptr, width, blend.SourceConstantAlpha );
+            if (blend.SourceConstantAlpha == 255)
+                for (; x < width; x++)
+                    dst_ptr[x] = blend_argb( dst_ptr[x], src_ptr[x] );
+            else
+                for (; x < width; x++)
+                    dst_ptr[x] = blend_argb_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
+        }
+        return;
+    }
+
+    if (src->compression != BI_RGB) src_mask = 0xff000000;
+
+    for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
+    {
+        x = blend_line_constant_alpha_simd( dst_ptr, src_ptr, width, blend.SourceConstantAlpha, src_mask );
+        for (; x < width; x++)
+            dst_ptr[x] = blend_argb_constant_alpha( dst_ptr[x], src_ptr[x] | src_mask,
+                                                    blend.SourceConstantAlpha );
+    }
 }
 
 static void blend_rect_32(const dib_info *dst, const RECT *rc,
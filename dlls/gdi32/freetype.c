@@ -37,6 +37,7 @@
 # include <dirent.h>
 #endif
 #include <stdio.h>
+#include <time.h>
 #include <assert.h>
 
 #ifdef HAVE_CARBON_CARBON_H
@@ -173,6 +174,7 @@ static FT_Error (*pFT_Library_SetLcdFilter)(FT_Library, FT_LcdFilter);
 
 #ifdef SONAME_LIBFONTCONFIG
 #include <fontconfig/fontconfig.h>
+MAKE_FUNCPTR(FcConfigGetFontDirs);
 MAKE_FUNCPTR(FcConfigSubstitute);
 MAKE_FUNCPTR(FcFontList);
 MAKE_FUNCPTR(FcFontSetDestroy);
@@ -185,6 +187,9 @@ MAKE_FUNCPTR(FcPatternDestroy);
 MAKE_FUNCPTR(FcPatternGetBool);
 MAKE_FUNCPTR(FcPatternGetInteger);
 MAKE_FUNCPTR(FcPatternGetString);
+MAKE_FUNCPTR(FcStrListDone);
+MAKE_FUNCPTR(FcStrListNext);
+static BOOL fontconfig_enabled;
 #endif
 
 #undef MAKE_FUNCPTR
@@ -292,6 +297,8 @@ typedef struct tagFace {
 
 typedef struct tagFamily {
     struct list entry;
+    struct list name_entry;     /* entry in the family name hash table */
+    struct list english_entry;  /* entry in the English name hash table */
     unsigned int refcount;
     WCHAR *FamilyName;
     WCHAR *EnglishName;
@@ -396,7 +403,7 @@ struct font_fileinfo {
 struct tagGdiFont {
     struct list entry;
     struct list unused_entry;
-    unsigned int refcount;
+    LONG refcount;
     GM **gm;
     DWORD gmsize;
     OUTLINETEXTMETRICW *potm;
@@ -422,6 +429,7 @@ struct tagGdiFont {
     SHORT yMin;
     DWORD ntmFlags;
     DWORD aa_flags;
+    WORD gasp_flags;
     UINT ntmCellHeight, ntmAvgWidth;
     FONTSIGNATURE fs;
     GdiFont *base_font;
@@ -454,7 +462,11 @@ struct enum_charset_list {
 #define GM_BLOCK_SIZE 128
 #define FONT_GM(font,idx) (&(font)->gm[(idx) / GM_BLOCK_SIZE][(idx) % GM_BLOCK_SIZE])
 
-static struct list gdi_font_list = LIST_INIT(gdi_font_list);
+/* The cache is only modified with both freetype_cs and the table lock held,
+ * fonts that are already in use can then be looked up with the shared lock. */
+#define FONT_CACHE_HASH_SIZE 64
+static struct list gdi_font_table[FONT_CACHE_HASH_SIZE];
+static SRWLOCK gdi_font_table_lock = SRWLOCK_INIT;
 static struct list unused_gdi_font_list = LIST_INIT(unused_gdi_font_list);
 static unsigned int unused_font_count;
 #define UNUSED_CACHE_SIZE 10
@@ -464,6 +476,10 @@ static struct list font_subst_list = LIST_INIT(font_subst_list);
 
 static struct list font_list = LIST_INIT(font_list);
 
+#define FAMILY_HASH_SIZE 256
+static struct list family_name_table[FAMILY_HASH_SIZE];
+static struct list family_english_table[FAMILY_HASH_SIZE];
+
 struct freetype_physdev
 {
     struct gdi_physdev dev;
@@ -581,6 +597,7 @@ static const WCHAR face_internal_leading_value[] = {'I','n','t','e','r','n','a',
 static const WCHAR face_font_sig_value[] = {'F','o','n','t',' ','S','i','g','n','a','t','u','r','e',0};
 static const WCHAR face_file_name_value[] = {'F','i','l','e',' ','N','a','m','e','\0'};
 static const WCHAR face_full_name_value[] = {'F','u','l','l',' ','N','a','m','e','\0'};
+static const WCHAR removed_faces_value[] = {'R','e','m','o','v','e','d',' ','F','a','c','e','s',0};
 
 
 struct font_mapping
@@ -597,6 +614,8 @@ static struct list mappings_list = LIST_INIT( mappings_list );
 
 static UINT default_aa_flags;
 static HKEY hkey_font_cache;
+static BOOL building_font_index;
+static time_t font_scan_time;
 static BOOL antialias_fakes = TRUE;
 
 static CRITICAL_SECTION freetype_cs;
@@ -1017,34 +1036,77 @@ static const struct list *get_face_list_from_family(const Family *family)
         return family->replacement;
 }
 
+static unsigned int hash_family_name( const WCHAR *name )
+{
+    unsigned int hash = 0;
+
+    while (*name) hash = hash * 33 + tolowerW( *name++ );
+    return hash % FAMILY_HASH_SIZE;
+}
+
+static void init_hash_tables(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < FAMILY_HASH_SIZE; i++)
+    {
+        list_init( &family_name_table[i] );
+        list_init( &family_english_table[i] );
+    }
+    for (i = 0; i < FONT_CACHE_HASH_SIZE; i++) list_init( &gdi_font_table[i] );
+}
+
+static void add_family_to_tables( Family *family )
+{
+    list_add_tail( &family_name_table[hash_family_name( family->FamilyName )], &family->name_entry );
+    if (family->EnglishName)
+        list_add_tail( &family_english_table[hash_family_name( family->EnglishName )],
+                       &family->english_entry );
+    else
+        list_init( &family->english_entry );
+}
+
+static Face *find_face_in_family(const Family *family, const WCHAR *file_name)
+{
+    const struct list *face_list = get_face_list_from_family(family);
+    Face *face;
+    const WCHAR *file;
+
+    LIST_FOR_EACH_ENTRY(face, face_list, Face, entry)
+    {
+        if (!face->file)
+            continue;
+        file = strrchrW(face->file, '/');
+        if(!file)
+            file = face->file;
+        else
+            file++;
+        if(strcmpiW(file, file_name)) continue;
+        face->refcount++;
+        return face;
+    }
+    return NULL;
+}
+
 static Face *find_face_from_filename(const WCHAR *file_name, const WCHAR *face_name)
 {
     Family *family;
     Face *face;
-    const WCHAR *file;
 
     TRACE("looking for file %s name %s\n", debugstr_w(file_name), debugstr_w(face_name));
 
-    LIST_FOR_EACH_ENTRY(family, &font_list, Family, entry)
+    if (face_name)
     {
-        const struct list *face_list;
-        if(face_name && strcmpiW(face_name, family->FamilyName))
-            continue;
-        face_list = get_face_list_from_family(family);
-        LIST_FOR_EACH_ENTRY(face, face_list, Face, entry)
+        LIST_FOR_EACH_ENTRY(family, &family_name_table[hash_family_name(face_name)], Family, name_entry)
         {
-            if (!face->file)
-                continue;
-            file = strrchrW(face->file, '/');
-            if(!file)
-                file = face->file;
-            else
-                file++;
-            if(strcmpiW(file, file_name)) continue;
-            face->refcount++;
-            return face;
-	}
+            if (strcmpiW(face_name, family->FamilyName)) continue;
+            if ((face = find_face_in_family(family, file_name))) return face;
+        }
+        return NULL;
     }
+
+    LIST_FOR_EACH_ENTRY(family, &font_list, Family, entry)
+        if ((face = find_face_in_family(family, file_name))) return face;
     return NULL;
 }
 
@@ -1052,7 +1114,7 @@ static Family *find_family_from_name(const WCHAR *name)
 {
     Family *family;
 
-    LIST_FOR_EACH_ENTRY(family, &font_list, Family, entry)
+    LIST_FOR_EACH_ENTRY(family, &family_name_table[hash_family_name(name)], Family, name_entry)
     {
         if(!strcmpiW(family->FamilyName, name))
             return family;
@@ -1065,17 +1127,27 @@ static Family *find_family_from_any_name(const WCHAR *name)
 {
     Family *family;
 
-    LIST_FOR_EACH_ENTRY(family, &font_list, Family, entry)
+    if ((family = find_family_from_name(name))) return family;
+
+    LIST_FOR_EACH_ENTRY(family, &family_english_table[hash_family_name(name)], Family, english_entry)
     {
-        if(!strcmpiW(family->FamilyName, name))
-            return family;
-        if(family->EnglishName && !strcmpiW(family->EnglishName, name))
+        if(!strcmpiW(family->EnglishName, name))
             return family;
     }
 
     return NULL;
 }
 
+/* check if a family comes before another one in font_list */
+static BOOL family_precedes(const Family *first, const Family *second)
+{
+    const struct list *ptr;
+
+    for (ptr = list_next(&font_list, &first->entry); ptr; ptr = list_next(&font_list, ptr))
+        if (ptr == &second->entry) return TRUE;
+    return FALSE;
+}
+
 static void DumpSubstList(void)
 {
     FontSubst *psub;
@@ -1483,6 +1555,8 @@ static void release_family( Family *family )
     if (--family->refcount) return;
     assert( list_empty( &family->faces ));
     list_remove( &family->entry );
+    list_remove( &family->name_entry );
+    list_remove( &family->english_entry );
     HeapFree( GetProcessHeap(), 0, family->FamilyName );
     HeapFree( GetProcessHeap(), 0, family->EnglishName );
     HeapFree( GetProcessHeap(), 0, family );
@@ -1588,6 +1662,7 @@ static Family *create_family( WCHAR *name, WCHAR *english_name )
     list_init( &family->faces );
     family->replacement = &family->faces;
     list_add_tail( &font_list, &family->entry );
+    add_family_to_tables( family );
 
     return family;
 }
@@ -1755,16 +1830,26 @@ static void load_font_list_from_cache(HKEY hkey_font_cache)
         if (!RegQueryValueExW(hkey_family, english_name_value, NULL, NULL, (BYTE *)buffer, &size))
             english_family = strdupW( buffer );
 
-        family = create_family(family_name, english_family);
-
-        if(english_family)
+        /* the family may already have been loaded from the font index */
+        if ((family = find_family_from_name(family_name)))
         {
-            FontSubst *subst = HeapAlloc(GetProcessHeap(), 0, sizeof(*subst));
-            subst->from.name = strdupW(english_family);
-            subst->from.charset = -1;
-            subst->to.name = strdupW(family_name);
-            subst->to.charset = -1;
-            add_font_subst(&font_subst_list, subst, 0);
+            HeapFree(GetProcessHeap(), 0, family_name);
+            HeapFree(GetProcessHeap(), 0, english_family);
+            family->refcount++;
+        }
+        else
+        {
+            family = create_family(family_name, english_family);
+
+            if(english_family)
+            {
+                FontSubst *subst = HeapAlloc(GetProcessHeap(), 0, sizeof(*subst));
+                subst->from.name = strdupW(english_family);
+                subst->from.charset = -1;
+                subst->to.name = strdupW(family_name);
+                subst->to.charset = -1;
+                add_font_subst(&font_subst_list, subst, 0);
+            }
         }
 
         size = sizeof(buffer);
@@ -1814,6 +1899,8 @@ static void add_face_to_cache(Face *face)
     HKEY hkey_family, hkey_face;
     WCHAR *face_key_name;
 
+    if (building_font_index) return;  /* the face will be saved in the font index */
+
     RegCreateKeyExW(hkey_font_cache, face->family->FamilyName, 0,
                     NULL, REG_OPTION_VOLATILE, KEY_ALL_ACCESS, NULL, &hkey_family, NULL);
     if(face->family->EnglishName)
@@ -1859,11 +1946,684 @@ static void add_face_to_cache(Face *face)
     RegCloseKey(hkey_family);
 }
 
+/* Binary font index
+ *
+ * The faces found by scanning the font directories are saved in a file of the
+ * Wine config directory, which the other processes of the session map instead
+ * of scanning again or reading the registry font cache. The index is rebuilt
+ * whenever the modification time of one of the directories containing indexed
+ * fonts or of the fontconfig font directories has changed, or when the locale,
+ * the font path or the fonts listed in the registry are different; the registry
+ * settings are only compared by the first process of the session, which creates
+ * the volatile font cache key. Fonts added later through AddFontResource are
+ * still stored in the registry font cache. The index is never modified once
+ * written: indexed faces that are removed during the session are listed in a
+ * single value of the volatile font cache key.
+ */
+
+#define FONT_INDEX_MAGIC   0x58444e46  /* "FNDX" */
+#define FONT_INDEX_VERSION 3
+
+struct font_index_header
+{
+    DWORD magic;         /* FONT_INDEX_MAGIC */
+    DWORD version;       /* FONT_INDEX_VERSION */
+    DWORD size;          /* total size of the file */
+    DWORD dir_count;     /* number of directories */
+    DWORD dirs;          /* offset of the directories array */
+    DWORD family_count;  /* number of families */
+    DWORD families;      /* offset of the families array */
+    DWORD face_count;    /* number of faces */
+    DWORD faces;         /* offset of the faces array */
+    DWORD lcid;          /* system locale used for the localized family names */
+    DWORD font_path;     /* offset of the font path from the registry, 0 if none */
+    DWORD reg_checksum;  /* checksum of the fonts listed in the registry */
+    DWORD pad;
+};
+
+struct font_index_dir
+{
+    ULONGLONG mtime;     /* modification time when the index was built */
+    DWORD     name;      /* offset of the unix directory name */
+    DWORD     pad;
+};
+
+struct font_index_family
+{
+    DWORD name;          /* offset of the family name */
+    DWORD english_name;  /* offset of the English name, 0 if none */
+    DWORD first_face;    /* index of the first face of the family */
+    DWORD face_count;    /* number of faces of the family */
+};
+
+struct font_index_face
+{
+    DWORD         style_name;   /* offset of the style name */
+    DWORD         full_name;    /* offset of the full name, 0 if none */
+    DWORD         file;         /* offset of the unix file name */
+    LONG          face_index;
+    DWORD         ntm_flags;
+    LONG          font_version;
+    DWORD         flags;        /* ADDFONT flags */
+    FONTSIGNATURE fs;
+    DWORD         scalable;
+    SHORT         height;
+    SHORT         width;
+    LONG          size;
+    LONG          x_ppem;
+    LONG          y_ppem;
+    SHORT         internal_leading;
+    SHORT         pad;
+};
+
+struct font_index_buffer
+{
+    BYTE *data;
+    DWORD size;
+    DWORD used;
+};
+
+static const struct font_index_header *font_index;  /* mapping of the font index being loaded */
+
+static char *get_font_index_name(void)
+{
+    static const char filename[] = "/fontindex";
+    const char *config_dir = wine_get_config_dir();
+    char *name;
+
+    if (!config_dir) return NULL;
+    if (!(name = HeapAlloc( GetProcessHeap(), 0, strlen(config_dir) + sizeof(filename) ))) return NULL;
+    strcpy( name, config_dir );
+    strcat( name, filename );
+    return name;
+}
+
+/* retrieve a string of the font index, checking that it is inside the mapping */
+static const WCHAR *get_font_index_string( DWORD offset )
+{
+    const WCHAR *str, *end;
+    DWORD len = 0;
+
+    if (offset < sizeof(*font_index) || offset >= font_index->size || (offset & 1)) return NULL;
+    str = (const WCHAR *)((const char *)font_index + offset);
+    end = (const WCHAR *)((const char *)font_index + (font_index->size & ~1));
+    while (str + len < end) if (!str[len++]) return str;
+    return NULL;
+}
+
+/* check that an array of the font index is inside the mapping */
+static const void *get_font_index_array( DWORD offset, DWORD count, DWORD size )
+{
+    if (offset < sizeof(*font_index) || offset > font_index->size) return NULL;
+    if (count > (font_index->size - offset) / size) return NULL;
+    return (const char *)font_index + offset;
+}
+
+static BOOL font_index_dir_changed( const WCHAR *nameW, ULONGLONG mtime )
+{
+    struct stat st;
+    char *name = strWtoA( CP_UNIXCP, nameW );
+    BOOL ret = stat( name, &st ) == -1 || st.st_mtime != mtime;
+
+    if (ret) TRACE( "%s changed\n", debugstr_a(name) );
+    HeapFree( GetProcessHeap(), 0, name );
+    return ret;
+}
+
+static void unmap_font_index(void)
+{
+    munmap( (void *)font_index, font_index->size );
+    font_index = NULL;
+}
+
+/* name of an indexed face in the list of removed faces */
+static WCHAR *get_removed_face_name( const WCHAR *file, LONG face_index, LONG y_ppem )
+{
+    static const WCHAR fmtW[] = {'%','s',',','%','d',',','%','d',0};
+    WCHAR *name = HeapAlloc( GetProcessHeap(), 0, (strlenW( file ) + 24) * sizeof(WCHAR) );
+
+    if (name) sprintfW( name, fmtW, file, face_index, y_ppem );
+    return name;
+}
+
+/* read the list of the indexed faces that have been removed during the current session */
+static WCHAR *get_removed_faces(void)
+{
+    WCHAR *list;
+    DWORD type, size;
+
+    if (RegQueryValueExW( hkey_font_cache, removed_faces_value, NULL, &type, NULL, &size ) ||
+        type != REG_MULTI_SZ)
+        return NULL;
+    /* make sure that the list is terminated even if the value is not */
+    if (!(list = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size + 2 * sizeof(WCHAR) ))) return NULL;
+    if (RegQueryValueExW( hkey_font_cache, removed_faces_value, NULL, NULL, (BYTE *)list, &size ))
+    {
+        HeapFree( GetProcessHeap(), 0, list );
+        return NULL;
+    }
+    return list;
+}
+
+/* check if an indexed face is in the list of removed faces */
+static BOOL is_removed_face( const WCHAR *removed, const WCHAR *file, LONG face_index, LONG y_ppem )
+{
+    WCHAR *name = get_removed_face_name( file, face_index, y_ppem );
+    const WCHAR *p;
+    BOOL ret = FALSE;
+
+    if (!name) return FALSE;
+    for (p = removed; *p && !ret; p += strlenW( p ) + 1) ret = !strcmpW( p, name );
+    HeapFree( GetProcessHeap(), 0, name );
+    return ret;
+}
+
+/* get the list of font directories from HKCU\Software\Wine\Fonts\Path */
+static WCHAR *get_font_path_value(void)
+{
+    static const WCHAR pathW[] = {'P','a','t','h',0};
+    WCHAR *valueW = NULL;
+    HKEY hkey;
+    DWORD len;
+
+    /* @@ Wine registry key: HKCU\Software\Wine\Fonts */
+    if (RegOpenKeyW( HKEY_CURRENT_USER, wine_fonts_key, &hkey )) return NULL;
+    if (!RegQueryValueExW( hkey, pathW, NULL, NULL, NULL, &len ))
+    {
+        len += sizeof(WCHAR);
+        valueW = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, len );
+        if (valueW && RegQueryValueExW( hkey, pathW, NULL, NULL, (LPBYTE)valueW, &len ))
+        {
+            HeapFree( GetProcessHeap(), 0, valueW );
+            valueW = NULL;
+        }
+    }
+    RegCloseKey( hkey );
+    return valueW;
+}
+
+static DWORD font_checksum( DWORD checksum, const void *data, DWORD size )
+{
+    const BYTE *ptr = data;
+
+    while (size--) checksum = checksum * 31 + *ptr++;
+    return checksum;
+}
+
+/* compute a checksum of the values of the registry Fonts key, except for the external fonts
+ * that init_font_list() deletes before scanning and that are added back afterwards */
+static DWORD get_font_reg_checksum(void)
+{
+    HKEY hkey, external_key;
+    DWORD valuelen, datalen, vlen, dlen, plen, type, path_type, i = 0, checksum = 0;
+    WCHAR *valueW;
+    BYTE *data, *path;
+
+    if (RegOpenKeyW( HKEY_LOCAL_MACHINE, is_win9x() ? win9x_font_reg_key : winnt_font_reg_key, &hkey ))
+        return 0;
+    if (RegOpenKeyW( HKEY_CURRENT_USER, external_fonts_reg_key, &external_key )) external_key = 0;
+
+    RegQueryInfoKeyW( hkey, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &valuelen, &datalen, NULL, NULL );
+    valuelen++; /* returned value doesn't include room for '\0' */
+    valueW = HeapAlloc( GetProcessHeap(), 0, valuelen * sizeof(WCHAR) );
+    data = HeapAlloc( GetProcessHeap(), 0, datalen );
+    path = HeapAlloc( GetProcessHeap(), 0, datalen );
+    if (valueW && data && path)
+    {
+        vlen = valuelen;
+        dlen = datalen;
+        while (!RegEnumValueW( hkey, i++, valueW, &vlen, NULL, &type, data, &dlen ))
+        {
+            plen = dlen;
+            if (!external_key || RegQueryValueExW( external_key, valueW, NULL, &path_type, path, &plen ) ||
+                type != path_type || dlen != plen || memcmp( data, path, plen ))
+            {
+                checksum = font_checksum( checksum, valueW, (vlen + 1) * sizeof(WCHAR) );
+                checksum = font_checksum( checksum, &type, sizeof(type) );
+                checksum = font_checksum( checksum, data, dlen );
+            }
+            vlen = valuelen;
+            dlen = datalen;
+        }
+    }
+    HeapFree( GetProcessHeap(), 0, path );
+    HeapFree( GetProcessHeap(), 0, data );
+    HeapFree( GetProcessHeap(), 0, valueW );
+    if (external_key) RegCloseKey( external_key );
+    RegCloseKey( hkey );
+    return checksum;
+}
+
+/* check that the font index was built with the current locale and font settings */
+static BOOL font_index_settings_changed(void)
+{
+    const WCHAR *saved_path = NULL;
+    WCHAR *path;
+    BOOL ret;
+
+    if (font_index->lcid != GetSystemDefaultLCID())
+    {
+        TRACE( "locale changed\n" );
+        return TRUE;
+    }
+    if (font_index->font_path && !(saved_path = get_font_index_string( font_index->font_path ))) return TRUE;
+    path = get_font_path_value();
+    ret = (path || saved_path) && (!path || !saved_path || strcmpW( path, saved_path ));
+    HeapFree( GetProcessHeap(), 0, path );
+    if (ret) TRACE( "font path changed\n" );
+    else if ((ret = (font_index->reg_checksum != get_font_reg_checksum()))) TRACE( "registry fonts changed\n" );
+    return ret;
+}
+
+/* load the font list from the font index, return FALSE if it needs to be rebuilt */
+static BOOL load_font_index( BOOL check_settings )
+{
+    const struct font_index_dir *dirs;
+    const struct font_index_family *families;
+    const struct font_index_face *faces;
+    WCHAR *removed;
+    struct stat st;
+    char *name;
+    void *ptr;
+    DWORD i, j;
+    int fd;
+
+    if (!(name = get_font_index_name())) return FALSE;
+    fd = open( name, O_RDONLY );
+    HeapFree( GetProcessHeap(), 0, name );
+    if (fd == -1) return FALSE;
+
+    ptr = MAP_FAILED;
+    if (!fstat( fd, &st ) && st.st_size >= sizeof(*font_index) && st.st_size < 0x7fffffff)
+        ptr = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if (ptr == MAP_FAILED) return FALSE;
+
+    font_index = ptr;
+    if (font_index->magic != FONT_INDEX_MAGIC || font_index->version != FONT_INDEX_VERSION ||
+        font_index->size != st.st_size)
+    {
+        munmap( ptr, st.st_size );
+        font_index = NULL;
+        return FALSE;
+    }
+
+    if (!(dirs = get_font_index_array( font_index->dirs, font_index->dir_count, sizeof(*dirs) )) ||
+        !(families = get_font_index_array( font_index->families, font_index->family_count,
+                                           sizeof(*families) )) ||
+        !(faces = get_font_index_array( font_index->faces, font_index->face_count, sizeof(*faces) )))
+        goto invalid;
+
+    for (i = 0; i < font_index->dir_count; i++)
+    {
+        const WCHAR *dir = get_font_index_string( dirs[i].name );
+        if (!dir || font_index_dir_changed( dir, dirs[i].mtime )) goto invalid;
+    }
+    if (check_settings && font_index_settings_changed()) goto invalid;
+
+    removed = get_removed_faces();
+
+    for (i = 0; i < font_index->family_count; i++)
+    {
+        const WCHAR *family_name = get_font_index_string( families[i].name );
+        const WCHAR *english_name = get_font_index_string( families[i].english_name );
+        Family *family;
+
+        if (!family_name) continue;
+        if (families[i].first_face > font_index->face_count ||
+            families[i].face_count > font_index->face_count - families[i].first_face) continue;
+
+        family = create_family( strdupW( family_name ), strdupW( english_name ));
+        if (english_name)
+        {
+            FontSubst *subst = HeapAlloc( GetProcessHeap(), 0, sizeof(*subst) );
+            subst->from.name = strdupW( english_name );
+            subst->from.charset = -1;
+            subst->to.name = strdupW( family_name );
+            subst->to.charset = -1;
+            add_font_subst( &font_subst_list, subst, 0 );
+        }
+
+        for (j = families[i].first_face; j < families[i].first_face + families[i].face_count; j++)
+        {
+            const struct font_index_face *entry = &faces[j];
+            const WCHAR *style_name = get_font_index_string( entry->style_name );
+            const WCHAR *file = get_font_index_string( entry->file );
+            Face *face;
+
+            if (!style_name || !file) continue;
+            if (removed && is_removed_face( removed, file, entry->face_index,
+                                            entry->scalable ? 0 : entry->y_ppem ))
+                continue;
+
+            face = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*face) );
+            face->refcount     = 1;
+            face->StyleName    = strdupW( style_name );
+            face->FullName     = strdupW( get_font_index_string( entry->full_name ));
+            face->file         = strdupW( file );
+            face->face_index   = entry->face_index;
+            face->ntmFlags     = entry->ntm_flags;
+            face->font_version = entry->font_version;
+            face->flags        = entry->flags;
+            face->fs           = entry->fs;
+            face->scalable     = entry->scalable;
+            if (!face->scalable)
+            {
+                face->size.height           = entry->height;
+                face->size.width            = entry->width;
+                face->size.size             = entry->size;
+                face->size.x_ppem           = entry->x_ppem;
+                face->size.y_ppem           = entry->y_ppem;
+                face->size.internal_leading = entry->internal_leading;
+            }
+
+            if (insert_face_in_family_list( face, family ))
+                TRACE( "Added font %s %s\n", debugstr_w(family->FamilyName), debugstr_w(face->StyleName) );
+            release_face( face );
+        }
+        release_family( family );
+    }
+
+    reorder_vertical_fonts();
+    TRACE( "loaded %u families from the font index\n", font_index->family_count );
+    HeapFree( GetProcessHeap(), 0, removed );
+    unmap_font_index();
+    return TRUE;
+
+invalid:
+    unmap_font_index();
+    return FALSE;
+}
+
+static DWORD font_index_alloc( struct font_index_buffer *buffer, DWORD size )
+{
+    DWORD offset = buffer->used;
+
+    size = (size + 7) & ~7;
+    if (buffer->used + size > buffer->size)
+    {
+        DWORD new_size = max( buffer->size * 2, buffer->used + size );
+        BYTE *new_data;
+
+        if (buffer->data) new_data = HeapReAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, buffer->data, new_size );
+        else new_data = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, new_size );
+        if (!new_data) return 0;
+        buffer->data = new_data;
+        buffer->size = new_size;
+    }
+    buffer->used += size;
+    return offset;
+}
+
+static DWORD font_index_add_string( struct font_index_buffer *buffer, const WCHAR *str )
+{
+    DWORD offset, size;
+
+    if (!str) return 0;
+    size = (strlenW( str ) + 1) * sizeof(WCHAR);
+    if ((offset = font_index_alloc( buffer, size ))) memcpy( buffer->data + offset, str, size );
+    return offset;
+}
+
+/* add the directory of a font file to the index, unless it is already there */
+static BOOL font_index_add_dir( struct font_index_buffer *buffer, const WCHAR *dir, DWORD len )
+{
+    struct font_index_header *header = (struct font_index_header *)buffer->data;
+    struct font_index_dir *entry;
+    struct stat st;
+    WCHAR *name;
+    char *nameA;
+    DWORD i, offset;
+    BOOL ret;
+
+    for (i = 0; i < header->dir_count; i++)
+    {
+        entry = (struct font_index_dir *)(buffer->data + header->dirs) + i;
+        name = (WCHAR *)(buffer->data + entry->name);
+        if (!strncmpW( name, dir, len ) && !name[len]) return TRUE;
+    }
+
+    if (!(name = HeapAlloc( GetProcessHeap(), 0, (len + 1) * sizeof(WCHAR) ))) return FALSE;
+    memcpy( name, dir, len * sizeof(WCHAR) );
+    name[len] = 0;
+    nameA = strWtoA( CP_UNIXCP, name );
+    ret = !stat( nameA, &st ) && (offset = font_index_add_string( buffer, name ));
+    HeapFree( GetProcessHeap(), 0, nameA );
+    HeapFree( GetProcessHeap(), 0, name );
+    if (!ret) return FALSE;
+
+    /* the directories are stored in a separate buffer that is appended at the end */
+    header = (struct font_index_header *)buffer->data;
+    entry = (struct font_index_dir *)(buffer->data + header->dirs) + header->dir_count++;
+    /* a directory modified since the scan started may contain fonts that were missed,
+     * store an invalid time so that the index gets rebuilt (allowing for timestamp granularity) */
+    entry->mtime = (st.st_mtime + 1 < font_scan_time) ? st.st_mtime : 0;
+    entry->name  = offset;
+    return TRUE;
+}
+
+static BOOL font_index_is_saved( const Face *face )
+{
+    return (face->flags & ADDFONT_ADD_TO_CACHE) && face->file;
+}
+
+/* save the font list to the font index */
+static void save_font_index(void)
+{
+    struct font_index_buffer buffer = { NULL, 0, 0 };
+    struct font_index_header *header;
+    struct font_index_family *family_entry;
+    struct font_index_face *face_entry;
+    DWORD family_count = 0, face_count = 0, dir_count = 1, families, faces, dirs, count, offset, i;
+    DWORD font_path = 0;
+    Family *family;
+    Face *face;
+    WCHAR *path;
+    char *name, *tmp = NULL;
+    int fd = -1;
+#ifdef SONAME_LIBFONTCONFIG
+    FcStrList *fc_dirs;
+    FcChar8 *fc_dir;
+
+    /* new fonts are usually installed in new subdirectories of the fontconfig directories */
+    if (fontconfig_enabled && (fc_dirs = pFcConfigGetFontDirs( NULL )))
+    {
+        while (pFcStrListNext( fc_dirs )) dir_count++;
+        pFcStrListDone( fc_dirs );
+    }
+#endif
+
+    LIST_FOR_EACH_ENTRY( family, &font_list, Family, entry )
+    {
+        count = 0;
+        LIST_FOR_EACH_ENTRY( face, &family->faces, Face, entry )
+            if (font_index_is_saved( face )) count++;
+        if (!count) continue;
+        family_count++;
+        face_count += count;
+    }
+
+    /* reserve one directory per face, which is the worst case */
+    if (!font_index_alloc( &buffer, sizeof(*header) ) ||
+        !(families = font_index_alloc( &buffer, family_count * sizeof(*family_entry) )) ||
+        !(faces = font_index_alloc( &buffer, face_count * sizeof(*face_entry) )) ||
+        !(dirs = font_index_alloc( &buffer, (face_count + dir_count) * sizeof(struct font_index_dir) )))
+        goto done;
+
+    header = (struct font_index_header *)buffer.data;
+    header->magic        = FONT_INDEX_MAGIC;
+    header->version      = FONT_INDEX_VERSION;
+    header->family_count = family_count;
+    header->families     = families;
+    header->face_count   = face_count;
+    header->faces        = faces;
+    header->dirs         = dirs;
+
+    family_count = face_count = 0;
+    LIST_FOR_EACH_ENTRY( family, &font_list, Family, entry )
+    {
+        DWORD family_name, english_name, first_face = face_count;
+
+        LIST_FOR_EACH_ENTRY( face, &family->faces, Face, entry )
+        {
+            DWORD style_name, full_name, file;
+            const WCHAR *slash;
+
+            if (!font_index_is_saved( face )) continue;
+
+            if (!(style_name = font_index_add_string( &buffer, face->StyleName )) ||
+                !(file = font_index_add_string( &buffer, face->file )))
+                goto done;
+            full_name = font_index_add_string( &buffer, face->FullName );
+            if (face->FullName && !full_name) goto done;
+
+            if ((slash = strrchrW( face->file, '/' )) && slash > face->file &&
+                !font_index_add_dir( &buffer, face->file, slash - face->file ))
+                goto done;
+
+            face_entry = (struct font_index_face *)(buffer.data + faces) + face_count++;
+            face_entry->style_name   = style_name;
+            face_entry->full_name    = full_name;
+            face_entry->file         = file;
+            face_entry->face_index   = face->face_index;
+            face_entry->ntm_flags    = face->ntmFlags;
+            face_entry->font_version = face->font_version;
+            face_entry->flags        = face->flags;
+            face_entry->fs           = face->fs;
+            face_entry->scalable     = face->scalable;
+            if (!face->scalable)
+            {
+                face_entry->height           = face->size.height;
+                face_entry->width            = face->size.width;
+                face_entry->size             = face->size.size;
+                face_entry->x_ppem           = face->size.x_ppem;
+                face_entry->y_ppem           = face->size.y_ppem;
+                face_entry->internal_leading = face->size.internal_leading;
+            }
+        }
+        if (face_count == first_face) continue;
+
+        if (!(family_name = font_index_add_string( &buffer, family->FamilyName ))) goto done;
+        english_name = font_index_add_string( &buffer, family->EnglishName );
+        if (family->EnglishName && !english_name) goto done;
+
+        family_entry = (struct font_index_family *)(buffer.data + families) + family_count++;
+        family_entry->name         = family_name;
+        family_entry->english_name = english_name;
+        family_entry->first_face   = first_face;
+        family_entry->face_count   = face_count - first_face;
+    }
+
+    /* also watch the Windows font directory, where new fonts are usually installed */
+    {
+        WCHAR windowsdir[MAX_PATH];
+        char *unixname;
+
+        GetWindowsDirectoryW( windowsdir, sizeof(windowsdir) / sizeof(WCHAR) );
+        strcatW( windowsdir, fontsW );
+        if ((unixname = wine_get_unix_file_name( windowsdir )))
+        {
+            WCHAR *dir = towstr( CP_UNIXCP, unixname );
+            font_index_add_dir( &buffer, dir, strlenW( dir ));
+            HeapFree( GetProcessHeap(), 0, dir );
+            HeapFree( GetProcessHeap(), 0, unixname );
+        }
+    }
+
+#ifdef SONAME_LIBFONTCONFIG
+    if (fontconfig_enabled && (fc_dirs = pFcConfigGetFontDirs( NULL )))
+    {
+        /* the list may have changed since the directories were counted */
+        for (count = 1; count < dir_count && (fc_dir = pFcStrListNext( fc_dirs )); count++)
+        {
+            WCHAR *dir = towstr( CP_UNIXCP, (const char *)fc_dir );
+            font_index_add_dir( &buffer, dir, strlenW( dir ));
+            HeapFree( GetProcessHeap(), 0, dir );
+        }
+        pFcStrListDone( fc_dirs );
+    }
+#endif
+
+    if ((path = get_font_path_value()))
+    {
+        font_path = font_index_add_string( &buffer, path );
+        HeapFree( GetProcessHeap(), 0, path );
+        if (!font_path) goto done;
+    }
+
+    header = (struct font_index_header *)buffer.data;
+    header->size         = buffer.used;
+    header->lcid         = GetSystemDefaultLCID();
+    header->font_path    = font_path;
+    header->reg_checksum = get_font_reg_checksum();
+
+    if (!(name = get_font_index_name())) goto done;
+    if ((tmp = HeapAlloc( GetProcessHeap(), 0, strlen(name) + sizeof(".XXXXXX") )))
+    {
+        sprintf( tmp, "%s.XXXXXX", name );
+        if ((fd = mkstemp( tmp )) != -1)
+        {
+            for (offset = 0; offset < buffer.used; offset += i)
+                if ((i = write( fd, buffer.data + offset, buffer.used - offset )) == -1 || !i) break;
+            if (offset < buffer.used || rename( tmp, name ) == -1)
+            {
+                WARN( "failed to write %s\n", debugstr_a(name) );
+                unlink( tmp );
+            }
+            else TRACE( "saved %u families to %s\n", family_count, debugstr_a(name) );
+            close( fd );
+        }
+    }
+    HeapFree( GetProcessHeap(), 0, name );
+
+done:
+    HeapFree( GetProcessHeap(), 0, tmp );
+    HeapFree( GetProcessHeap(), 0, buffer.data );
+}
+
+/* record the removal of an indexed face, so that the other processes of the session no longer load it */
+static void remove_face_from_index( Face *face )
+{
+    WCHAR *name, *removed, *list;
+    const WCHAR *end;
+    HANDLE mutex;
+    DWORD len, name_len;
+
+    if (building_font_index || !font_index_is_saved( face )) return;
+    if (!(name = get_removed_face_name( face->file, face->face_index, face->scalable ? 0 : face->size.y_ppem )))
+        return;
+
+    /* the list is shared by all the processes of the session */
+    if ((mutex = CreateMutexW( NULL, FALSE, font_mutex_nameW ))) WaitForSingleObject( mutex, INFINITE );
+    removed = get_removed_faces();
+    for (end = removed; end && *end; end += strlenW( end ) + 1) ;
+    len = removed ? end - removed : 0;
+    name_len = strlenW( name ) + 1;
+    if ((list = HeapAlloc( GetProcessHeap(), 0, (len + name_len + 1) * sizeof(WCHAR) )))
+    {
+        if (len) memcpy( list, removed, len * sizeof(WCHAR) );
+        memcpy( list + len, name, name_len * sizeof(WCHAR) );
+        list[len + name_len] = 0;
+        RegSetValueExW( hkey_font_cache, removed_faces_value, 0, REG_MULTI_SZ, (BYTE *)list,
+                        (len + name_len + 1) * sizeof(WCHAR) );
+        HeapFree( GetProcessHeap(), 0, list );
+    }
+    if (mutex)
+    {
+        ReleaseMutex( mutex );
+        CloseHandle( mutex );
+    }
+    HeapFree( GetProcessHeap(), 0, removed );
+    HeapFree( GetProcessHeap(), 0, name );
+}
+
 static void remove_face_from_cache( Face *face )
 {
     HKEY hkey_family;
 
-    RegOpenKeyExW( hkey_font_cache, face->family->FamilyName, 0, KEY_ALL_ACCESS, &hkey_family );
+    remove_face_from_index( face );
+    if (RegOpenKeyExW( hkey_font_cache, face->family->FamilyName, 0, KEY_ALL_ACCESS, &hkey_family ))
+        return;
 
     if (face->scalable)
     {
@@ -2356,6 +3116,7 @@ static BOOL map_font_family(const WCHAR *orig, const WCHAR *repl)
             list_init(&new_family->faces);
             new_family->replacement = &family->faces;
             list_add_tail(&font_list, &new_family->entry);
+            add_family_to_tables(new_family);
             return TRUE;
         }
     }
@@ -2760,8 +3521,6 @@ static BOOL ReadFontDir(const char *dirname, BOOL external_fonts)
 
 #ifdef SONAME_LIBFONTCONFIG
 
-static BOOL fontconfig_enabled;
-
 static UINT parse_aa_pattern( FcPattern *pattern )
 {
     FcBool antialias;
@@ -2796,6 +3555,7 @@ static void init_fontconfig(void)
     }
 
 #define LOAD_FUNCPTR(f) if((p##f = wine_dlsym(fc_handle, #f, NULL, 0)) == NULL){WARN("Can't find symbol %s\n", #f); return;}
+    LOAD_FUNCPTR(FcConfigGetFontDirs);
     LOAD_FUNCPTR(FcConfigSubstitute);
     LOAD_FUNCPTR(FcFontList);
     LOAD_FUNCPTR(FcFontSetDestroy);
@@ -2808,6 +3568,8 @@ static void init_fontconfig(void)
     LOAD_FUNCPTR(FcPatternGetBool);
     LOAD_FUNCPTR(FcPatternGetInteger);
     LOAD_FUNCPTR(FcPatternGetString);
+    LOAD_FUNCPTR(FcStrListDone);
+    LOAD_FUNCPTR(FcStrListNext);
 #undef LOAD_FUNCPTR
 
     if (pFcInit())
@@ -4183,10 +4945,9 @@ sym_not_found:
 static void init_font_list(void)
 {
     static const WCHAR dot_fonW[] = {'.','f','o','n','\0'};
-    static const WCHAR pathW[] = {'P','a','t','h',0};
     HKEY hkey;
     DWORD valuelen, datalen, i = 0, type, dlen, vlen;
-    WCHAR windowsdir[MAX_PATH];
+    WCHAR windowsdir[MAX_PATH], *font_path;
     char *unixname;
 
     delete_external_font_keys();
@@ -4274,62 +5035,46 @@ static void init_font_list(void)
 #endif
 
     /* then look in any directories that we've specified in the config file */
-    /* @@ Wine registry key: HKCU\Software\Wine\Fonts */
-    if(RegOpenKeyA(HKEY_CURRENT_USER, "Software\\Wine\\Fonts", &hkey) == ERROR_SUCCESS)
+    if ((font_path = get_font_path_value()))
     {
         DWORD len;
-        LPWSTR valueW;
         LPSTR valueA, ptr;
 
-        if (RegQueryValueExW( hkey, pathW, NULL, NULL, NULL, &len ) == ERROR_SUCCESS)
+        len = WideCharToMultiByte( CP_UNIXCP, 0, font_path, -1, NULL, 0, NULL, NULL );
+        valueA = HeapAlloc( GetProcessHeap(), 0, len );
+        WideCharToMultiByte( CP_UNIXCP, 0, font_path, -1, valueA, len, NULL, NULL );
+        TRACE( "got font path %s\n", debugstr_a(valueA) );
+        ptr = valueA;
+        while (ptr)
         {
-            len += sizeof(WCHAR);
-            valueW = HeapAlloc( GetProcessHeap(), 0, len );
-            if (RegQueryValueExW( hkey, pathW, NULL, NULL, (LPBYTE)valueW, &len ) == ERROR_SUCCESS)
+            const char* home;
+            LPSTR next = strchr( ptr, ':' );
+            if (next) *next++ = 0;
+            if (ptr[0] == '~' && ptr[1] == '/' && (home = getenv( "HOME" )) &&
+                (unixname = HeapAlloc( GetProcessHeap(), 0, strlen(ptr) + strlen(home) )))
             {
-                len = WideCharToMultiByte( CP_UNIXCP, 0, valueW, -1, NULL, 0, NULL, NULL );
-                valueA = HeapAlloc( GetProcessHeap(), 0, len );
-                WideCharToMultiByte( CP_UNIXCP, 0, valueW, -1, valueA, len, NULL, NULL );
-                TRACE( "got font path %s\n", debugstr_a(valueA) );
-                ptr = valueA;
-                while (ptr)
-                {
-                    const char* home;
-                    LPSTR next = strchr( ptr, ':' );
-                    if (next) *next++ = 0;
-                    if (ptr[0] == '~' && ptr[1] == '/' && (home = getenv( "HOME" )) &&
-                        (unixname = HeapAlloc( GetProcessHeap(), 0, strlen(ptr) + strlen(home) )))
-                    {
-                        strcpy( unixname, home );
-                        strcat( unixname, ptr + 1 );
-                        ReadFontDir( unixname, TRUE );
-                        HeapFree( GetProcessHeap(), 0, unixname );
-                    }
-                    else
-                        ReadFontDir( ptr, TRUE );
-                    ptr = next;
-                }
-                HeapFree( GetProcessHeap(), 0, valueA );
+                strcpy( unixname, home );
+                strcat( unixname, ptr + 1 );
+                ReadFontDir( unixname, TRUE );
+                HeapFree( GetProcessHeap(), 0, unixname );
             }
-            HeapFree( GetProcessHeap(), 0, valueW );
+            else
+                ReadFontDir( ptr, TRUE );
+            ptr = next;
         }
-        RegCloseKey(hkey);
+        HeapFree( GetProcessHeap(), 0, valueA );
+        HeapFree( GetProcessHeap(), 0, font_path );
     }
 }
 
 static BOOL move_to_front(const WCHAR *name)
 {
-    Family *family, *cursor2;
-    LIST_FOR_EACH_ENTRY_SAFE(family, cursor2, &font_list, Family, entry)
-    {
-        if(!strcmpiW(family->FamilyName, name))
-        {
-            list_remove(&family->entry);
-            list_add_head(&font_list, &family->entry);
-            return TRUE;
-        }
-    }
-    return FALSE;
+    Family *family = find_family_from_name(name);
+
+    if (!family) return FALSE;
+    list_remove(&family->entry);
+    list_add_head(&font_list, &family->entry);
+    return TRUE;
 }
 
 static BOOL set_default(const WCHAR **name_list)
@@ -4364,6 +5109,8 @@ BOOL WineEngInit(void)
     /* update locale dependent font info in registry */
     update_font_info();
 
+    init_hash_tables();
+
     if(!init_freetype()) return FALSE;
 
 #ifdef SONAME_LIBFONTCONFIG
@@ -4396,9 +5143,15 @@ BOOL WineEngInit(void)
 
     create_font_cache_key(&hkey_font_cache, &disposition);
 
-    if(disposition == REG_CREATED_NEW_KEY)
+    if (!load_font_index( disposition == REG_CREATED_NEW_KEY ))
+    {
+        font_scan_time = time( NULL );
+        building_font_index = TRUE;
         init_font_list();
-    else
+        building_font_index = FALSE;
+        save_font_index();
+    }
+    if (disposition != REG_CREATED_NEW_KEY)
         load_font_list_from_cache(hkey_font_cache);
 
     reorder_font_list();
@@ -4417,6 +5170,23 @@ BOOL WineEngInit(void)
     return TRUE;
 }
 
+/*************************************************************
+ *    WineEngGetRasterizerInfo
+ *
+ * Return the FreeType version and the settings that affect the rendered
+ * glyphs, so that cached bitmaps can be discarded when they change.
+ */
+BOOL WineEngGetRasterizerInfo( DWORD *version, DWORD *flags )
+{
+    if (!library) return FALSE;
+    *version = FT_SimpleVersion;
+    *flags = 0;
+    if (is_hinting_enabled()) *flags |= WINE_RASTERIZER_HINTING;
+    if (is_subpixel_rendering_enabled()) *flags |= WINE_RASTERIZER_SUBPIXEL;
+    if (antialias_fakes) *flags |= WINE_RASTERIZER_AA_FAKES;
+    return TRUE;
+}
+
 /* Some fonts have large usWinDescent values, as a result of storing signed short
    in unsigned field. That's probably caused by sTypoDescent vs usWinDescent confusion in
    some font generation tools. */
@@ -4896,26 +5666,47 @@ static LONG load_VDMX(GdiFont *font, LONG height)
 static void dump_gdi_font_list(void)
 {
     GdiFont *font;
+    unsigned int i;
 
     TRACE("---------- Font Cache ----------\n");
-    LIST_FOR_EACH_ENTRY( font, &gdi_font_list, struct tagGdiFont, entry )
-        TRACE("font=%p ref=%u %s %d\n", font, font->refcount,
-              debugstr_w(font->font_desc.lf.lfFaceName), font->font_desc.lf.lfHeight);
+    for (i = 0; i < FONT_CACHE_HASH_SIZE; i++)
+        LIST_FOR_EACH_ENTRY( font, &gdi_font_table[i], struct tagGdiFont, entry )
+            TRACE("font=%p ref=%d %s %d\n", font, font->refcount,
+                  debugstr_w(font->font_desc.lf.lfFaceName), font->font_desc.lf.lfHeight);
 }
 
+/* add a reference to a font, must be called with freetype_cs held */
 static void grab_font( GdiFont *font )
 {
-    if (!font->refcount++)
+    if (InterlockedIncrement( &font->refcount ) == 1)
     {
         list_remove( &font->unused_entry );
         unused_font_count--;
     }
 }
 
+/* add a reference to a font that is already in use, without locking */
+static BOOL grab_used_font( GdiFont *font )
+{
+    LONG ref, prev;
+
+    for (ref = font->refcount; ref > 0; ref = prev)
+        if ((prev = InterlockedCompareExchange( &font->refcount, ref + 1, ref )) == ref) return TRUE;
+    return FALSE;
+}
+
 static void release_font( GdiFont *font )
 {
+    LONG ref, prev;
+
     if (!font) return;
-    if (!--font->refcount)
+
+    /* only the last reference needs the lock */
+    for (ref = font->refcount; ref > 1; ref = prev)
+        if ((prev = InterlockedCompareExchange( &font->refcount, ref - 1, ref )) == ref) return;
+
+    EnterCriticalSection( &freetype_cs );
+    if (!InterlockedDecrement( &font->refcount ))
     {
         TRACE( "font %p\n", font );
 
@@ -4925,7 +5716,9 @@ static void release_font( GdiFont *font )
         {
             font = LIST_ENTRY( list_tail( &unused_gdi_font_list ), struct tagGdiFont, unused_entry );
             TRACE( "freeing %p\n", font );
+            AcquireSRWLockExclusive( &gdi_font_table_lock );
             list_remove( &font->entry );
+            ReleaseSRWLockExclusive( &gdi_font_table_lock );
             list_remove( &font->unused_entry );
             free_font( font );
         }
@@ -4933,6 +5726,7 @@ static void release_font( GdiFont *font )
 
         if (TRACE_ON(font)) dump_gdi_font_list();
     }
+    LeaveCriticalSection( &freetype_cs );
 }
 
 static BOOL fontcmp(const GdiFont *font, FONT_DESC *fd)
@@ -4968,7 +5762,9 @@ static void calc_hash(FONT_DESC *pfd)
     pfd->hash = hash;
 }
 
-static GdiFont *find_in_cache(HFONT hfont, const LOGFONTW *plf, const FMAT2 *pmat, BOOL can_use_bitmap)
+/* look for a font in the cache; without freetype_cs held only fonts that are in use are returned */
+static GdiFont *find_in_cache(HFONT hfont, const LOGFONTW *plf, const FMAT2 *pmat, BOOL can_use_bitmap,
+                              BOOL locked)
 {
     GdiFont *ret;
     FONT_DESC fd;
@@ -4978,16 +5774,17 @@ static GdiFont *find_in_cache(HFONT hfont, const LOGFONTW *plf, const FMAT2 *pma
     fd.can_use_bitmap = can_use_bitmap;
     calc_hash(&fd);
 
-    /* try the in-use list */
-    LIST_FOR_EACH_ENTRY( ret, &gdi_font_list, struct tagGdiFont, entry )
+    AcquireSRWLockShared( &gdi_font_table_lock );
+    LIST_FOR_EACH_ENTRY( ret, &gdi_font_table[fd.hash % FONT_CACHE_HASH_SIZE], struct tagGdiFont, entry )
     {
         if(fontcmp(ret, &fd)) continue;
         if(!can_use_bitmap && !FT_IS_SCALABLE(ret->ft_face)) continue;
-        list_remove( &ret->entry );
-        list_add_head( &gdi_font_list, &ret->entry );
-        grab_font( ret );
+        if (locked) grab_font( ret );
+        else if (!grab_used_font( ret )) continue;
+        ReleaseSRWLockShared( &gdi_font_table_lock );
         return ret;
     }
+    ReleaseSRWLockShared( &gdi_font_table_lock );
     return NULL;
 }
 
@@ -4996,7 +5793,9 @@ static void add_to_cache(GdiFont *font)
     static DWORD cache_num = 1;
 
     font->cache_num = cache_num++;
-    list_add_head(&gdi_font_list, &font->entry);
+    AcquireSRWLockExclusive( &gdi_font_table_lock );
+    list_add_head(&gdi_font_table[font->font_desc.hash % FONT_CACHE_HASH_SIZE], &font->entry);
+    ReleaseSRWLockExclusive( &gdi_font_table_lock );
     TRACE( "font %p\n", font );
 }
 
@@ -5364,6 +6163,8 @@ static HFONT freetype_SelectFont( PHYSDEV dev, HFONT hfont, UINT *aa_flags )
     unsigned int score = 0, new_score;
     signed int diff = 0, newdiff;
     BOOL bd, it, can_use_bitmap, want_vertical;
+    Family *candidates[2];
+    unsigned int i;
     LOGFONTW lf;
     CHARSETINFO csi;
     FMAT2 dcmat;
@@ -5419,10 +6220,17 @@ static HFONT freetype_SelectFont( PHYSDEV dev, HFONT hfont, UINT *aa_flags )
                                         dcmat.eM21, dcmat.eM22);
 
     GDI_CheckNotLock();
+
+    /* fonts already selected in another DC can be shared without locking */
+    if((ret = find_in_cache(hfont, &lf, &dcmat, can_use_bitmap, FALSE)) != NULL) {
+        TRACE("returning in-use gdiFont(%p) for hFont %p\n", ret, hfont);
+        goto selected;
+    }
+
     EnterCriticalSection( &freetype_cs );
 
     /* check the cache first */
-    if((ret = find_in_cache(hfont, &lf, &dcmat, can_use_bitmap)) != NULL) {
+    if((ret = find_in_cache(hfont, &lf, &dcmat, can_use_bitmap, TRUE)) != NULL) {
         TRACE("returning cached gdiFont(%p) for hFont %p\n", ret, hfont);
         goto done;
     }
@@ -5475,23 +6283,30 @@ static HFONT freetype_SelectFont( PHYSDEV dev, HFONT hfont, UINT *aa_flags )
 	   where we'll either use the charset of the current ansi codepage
 	   or if that's unavailable the first charset that the font supports.
 	*/
-        LIST_FOR_EACH_ENTRY( family, &font_list, Family, entry ) {
-            if (!strcmpiW(family->FamilyName, FaceName) ||
-                (psub && !strcmpiW(family->FamilyName, psub->to.name)))
-            {
-                font_link = find_font_link(family->FamilyName);
-                face_list = get_face_list_from_family(family);
-                LIST_FOR_EACH_ENTRY( face, face_list, Face, entry ) {
-                    if (!(face->scalable || can_use_bitmap))
-                        continue;
-                    if (csi.fs.fsCsb[0] & face->fs.fsCsb[0])
-                        goto found;
-                    if (font_link != NULL &&
-                        csi.fs.fsCsb[0] & font_link->fs.fsCsb[0])
-                        goto found;
-                    if (!csi.fs.fsCsb[0])
-                        goto found;
-                }
+        candidates[0] = find_family_from_name(FaceName);
+        candidates[1] = psub ? find_family_from_name(psub->to.name) : NULL;
+        if (candidates[0] == candidates[1])
+            candidates[1] = NULL;
+        else if (candidates[0] && candidates[1] && family_precedes(candidates[1], candidates[0]))
+        {
+            family = candidates[0];
+            candidates[0] = candidates[1];
+            candidates[1] = family;
+        }
+        for (i = 0; i < 2; i++) {
+            if (!(family = candidates[i])) continue;
+            font_link = find_font_link(family->FamilyName);
+            face_list = get_face_list_from_family(family);
+            LIST_FOR_EACH_ENTRY( face, face_list, Face, entry ) {
+                if (!(face->scalable || can_use_bitmap))
+                    continue;
+                if (csi.fs.fsCsb[0] & face->fs.fsCsb[0])
+                    goto found;
+                if (font_link != NULL &&
+                    csi.fs.fsCsb[0] & font_link->fs.fsCsb[0])
+                    goto found;
+                if (!csi.fs.fsCsb[0])
+                    goto found;
             }
 	}
 
@@ -5568,18 +6383,16 @@ static HFONT freetype_SelectFont( PHYSDEV dev, HFONT hfont, UINT *aa_flags )
         strcpyW(lf.lfFaceName, defSans);
     else
         strcpyW(lf.lfFaceName, defSans);
-    LIST_FOR_EACH_ENTRY( family, &font_list, Family, entry ) {
-        if(!strcmpiW(family->FamilyName, lf.lfFaceName)) {
-            font_link = find_font_link(family->FamilyName);
-            face_list = get_face_list_from_family(family);
-            LIST_FOR_EACH_ENTRY( face, face_list, Face, entry ) {
-                if (!(face->scalable || can_use_bitmap))
-                    continue;
-                if (csi.fs.fsCsb[0] & face->fs.fsCsb[0])
-                    goto found;
-                if (font_link != NULL && csi.fs.fsCsb[0] & font_link->fs.fsCsb[0])
-                    goto found;
-            }
+    if ((family = find_family_from_name(lf.lfFaceName))) {
+        font_link = find_font_link(family->FamilyName);
+        face_list = get_face_list_from_family(family);
+        LIST_FOR_EACH_ENTRY( face, face_list, Face, entry ) {
+            if (!(face->scalable || can_use_bitmap))
+                continue;
+            if (csi.fs.fsCsb[0] & face->fs.fsCsb[0])
+                goto found;
+            if (font_link != NULL && csi.fs.fsCsb[0] & font_link->fs.fsCsb[0])
+                goto found;
         }
     }
 
@@ -5708,7 +6521,7 @@ found_face:
         dcmat.eM11 = dcmat.eM22 = 1.0;
         /* As we changed the matrix, we need to search the cache for the font again,
          * otherwise we might explode the cache. */
-        if((cachedfont = find_in_cache(hfont, &lf, &dcmat, can_use_bitmap)) != NULL) {
+        if((cachedfont = find_in_cache(hfont, &lf, &dcmat, can_use_bitmap, TRUE)) != NULL) {
             TRACE("Found cached font after non-scalable matrix rescale!\n");
             free_font( ret );
             ret = cachedfont;
@@ -5772,11 +6585,15 @@ found_face:
         }
     }
     ret->aa_flags = HIWORD( face->flags );
+    /* a missing gasp table doesn't disable antialiasing */
+    if (!get_gasp_flags( ret, &ret->gasp_flags )) ret->gasp_flags = GASP_DOGRAY;
 
     TRACE("caching: gdiFont=%p  hfont=%p\n", ret, hfont);
 
     add_to_cache(ret);
 done:
+    LeaveCriticalSection( &freetype_cs );
+selected:
     if (ret)
     {
         PHYSDEV next = GET_NEXT_PHYSDEV( dev, pSelectFont );
@@ -5809,8 +6626,7 @@ done:
             case WINE_GGO_GRAY16_BITMAP:
                 if ((!antialias_fakes || (!ret->fake_bold && !ret->fake_italic)) && is_hinting_enabled())
                 {
-                    WORD gasp_flags;
-                    if (get_gasp_flags( ret, &gasp_flags ) && !(gasp_flags & GASP_DOGRAY))
+                    if (!(ret->gasp_flags & GASP_DOGRAY))
                     {
                         TRACE( "font %s %d aa disabled by GASP\n",
                                debugstr_w(lf.lfFaceName), lf.lfHeight );
@@ -5823,7 +6639,6 @@ done:
         release_font( physdev->font );
         physdev->font = ret;
     }
-    LeaveCriticalSection( &freetype_cs );
     return ret ? hfont : 0;
 }
 
@@ -8920,6 +9735,11 @@ BOOL WineEngInit(void)
     return FALSE;
 }
 
+BOOL WineEngGetRasterizerInfo( DWORD *version, DWORD *flags )
+{
+    return FALSE;
+}
+
 INT WineEngAddFontResourceEx(LPCWSTR file, DWORD flags, PVOID pdv)
 {
     FIXME("(%s, %x, %p): stub\n", debugstr_w(file), flags, pdv);
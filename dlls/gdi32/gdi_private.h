@@ -259,6 +259,9 @@ extern DWORD put_image_into_bitmap( BITMAPOBJ *bmp, HRGN clip, BITMAPINFO *info,
                                     struct bitblt_coords *dst ) DECLSPEC_HIDDEN;
 extern void dibdrv_set_window_surface( DC *dc, struct window_surface *surface ) DECLSPEC_HIDDEN;
 
+/* dibdrv/primitives.c */
+extern void init_dib_primitives(void) DECLSPEC_HIDDEN;
+
 /* driver.c */
 extern const struct gdi_dc_funcs null_driver DECLSPEC_HIDDEN;
 extern const struct gdi_dc_funcs dib_driver DECLSPEC_HIDDEN;
@@ -284,9 +287,15 @@ struct font_realization_info
     WORD  simulations; /* 0 bit - bold simulation, 1 bit - oblique simulation */
 };
 
+/* flags returned by WineEngGetRasterizerInfo */
+#define WINE_RASTERIZER_HINTING   0x0001
+#define WINE_RASTERIZER_SUBPIXEL  0x0002
+#define WINE_RASTERIZER_AA_FAKES  0x0004
+
 extern INT WineEngAddFontResourceEx(LPCWSTR, DWORD, PVOID) DECLSPEC_HIDDEN;
 extern HANDLE WineEngAddFontMemResourceEx(PVOID, DWORD, PVOID, LPDWORD) DECLSPEC_HIDDEN;
 extern BOOL WineEngCreateScalableFontResource(DWORD, LPCWSTR, LPCWSTR, LPCWSTR) DECLSPEC_HIDDEN;
+extern BOOL WineEngGetRasterizerInfo(DWORD *, DWORD *) DECLSPEC_HIDDEN;
 extern BOOL WineEngInit(void) DECLSPEC_HIDDEN;
 extern BOOL WineEngRemoveFontResourceEx(LPCWSTR, DWORD, PVOID) DECLSPEC_HIDDEN;
 
@@ -4069,6 +4069,123 @@ static void test_32bit_ddb(void)
     DeleteDC(hdcScreen);
 }
 
+static void test_wide_rows(void)
+{
+    static const BYTE alphas[] = { 255, 128, 7 };
+    static const BYTE formats[] = { AC_SRC_ALPHA, 0 };
+    BITMAPINFO bmi;
+    HBITMAP bmpSrc, bmpDst, bmpRef, oldDst;
+    HDC hdcSrc, hdcDst, hdcRef;
+    DWORD *src_bits, *dst_bits, *ref_bits, seed = 0x12345678;
+    BYTE *bytes, orig[3 * 45];
+    BLENDFUNCTION blend;
+    HBRUSH brush;
+    int i, j, x, y;
+
+    /* rows wide enough to cover both the vectorized and the per-pixel code paths of the DIB engine */
+    memset( &bmi, 0, sizeof(bmi) );
+    bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+    bmi.bmiHeader.biWidth = 37;
+    bmi.bmiHeader.biHeight = -3;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    hdcSrc = CreateCompatibleDC( 0 );
+    hdcDst = CreateCompatibleDC( 0 );
+    hdcRef = CreateCompatibleDC( 0 );
+    bmpSrc = CreateDIBSection( hdcSrc, &bmi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0 );
+    bmpDst = CreateDIBSection( hdcDst, &bmi, DIB_RGB_COLORS, (void **)&dst_bits, NULL, 0 );
+    bmpRef = CreateDIBSection( hdcRef, &bmi, DIB_RGB_COLORS, (void **)&ref_bits, NULL, 0 );
+    SelectObject( hdcSrc, bmpSrc );
+    oldDst = SelectObject( hdcDst, bmpDst );
+    SelectObject( hdcRef, bmpRef );
+
+    if (pGdiAlphaBlend)
+    {
+        blend.BlendOp = AC_SRC_OVER;
+        blend.BlendFlags = 0;
+        for (i = 0; i < sizeof(formats); i++)
+        {
+            for (j = 0; j < sizeof(alphas); j++)
+            {
+                for (x = 0; x < 37 * 3; x++)
+                {
+                    BYTE a;
+
+                    seed = seed * 1103515245 + 12345;
+                    a = seed >> 24;
+                    /* keep the source premultiplied */
+                    src_bits[x] = a << 24 | ((seed >> 16) & 0xff) * a / 255 << 16 |
+                                  ((seed >> 8) & 0xff) * a / 255 << 8 | (seed & 0xff) * a / 255;
+                    seed = seed * 1103515245 + 12345;
+                    dst_bits[x] = ref_bits[x] = seed;
+                }
+                blend.SourceConstantAlpha = alphas[j];
+                blend.AlphaFormat = formats[i];
+                pGdiAlphaBlend( hdcDst, 1, 0, 35, 3, hdcSrc, 1, 0, 35, 3, blend );
+                for (y = 0; y < 3; y++)
+                    for (x = 1; x < 36; x++)
+                        pGdiAlphaBlend( hdcRef, x, y, 1, 1, hdcSrc, x, y, 1, 1, blend );
+                for (x = 0; x < 37 * 3; x++)
+                    if (dst_bits[x] != ref_bits[x]) break;
+                ok( x == 37 * 3, "%u/%u: pixel %u got %08x expected %08x\n",
+                    formats[i], alphas[j], x, dst_bits[x], ref_bits[x] );
+            }
+        }
+    }
+
+    brush = CreateSolidBrush( RGB( 0x12, 0x34, 0x56 ));
+    SelectObject( hdcDst, brush );
+    for (x = 0; x < 37 * 3; x++) dst_bits[x] = ref_bits[x] = x * 0x01030507;
+    PatBlt( hdcDst, 1, 0, 35, 3, PATINVERT );
+    for (x = 0; x < 37 * 3; x++)
+    {
+        DWORD expect = ref_bits[x];
+        if (x % 37 && x % 37 != 36) expect ^= 0x123456;
+        if ((dst_bits[x] & 0xffffff) != (expect & 0xffffff)) break;
+    }
+    ok( x == 37 * 3, "pixel %u got %08x\n", x, dst_bits[x] );
+
+    bmi.bmiHeader.biWidth = 45;
+    bmi.bmiHeader.biHeight = -1;
+    bmi.bmiHeader.biBitCount = 24;
+    SelectObject( hdcDst, oldDst );
+    DeleteObject( bmpDst );
+    bmpDst = CreateDIBSection( hdcDst, &bmi, DIB_RGB_COLORS, (void **)&bytes, NULL, 0 );
+    SelectObject( hdcDst, bmpDst );
+    SelectObject( hdcDst, brush );
+    for (i = 0; i < 3 * 45; i++) bytes[i] = orig[i] = i * 7;
+    PatBlt( hdcDst, 1, 0, 43, 1, PATINVERT );
+    for (i = 0; i < 3 * 45; i++)
+    {
+        static const BYTE color[3] = { 0x56, 0x34, 0x12 };
+        BYTE expect = orig[i];
+        if (i >= 3 && i < 3 * 44) expect ^= color[i % 3];
+        if (bytes[i] != expect) break;
+    }
+    ok( i == 3 * 45, "byte %u got %02x\n", i, bytes[i] );
+    PatBlt( hdcDst, 2, 0, 41, 1, PATCOPY );
+    for (i = 0; i < 3 * 45; i++)
+    {
+        static const BYTE color[3] = { 0x56, 0x34, 0x12 };
+        BYTE expect = orig[i];
+        if (i >= 3 && i < 3 * 44) expect ^= color[i % 3];
+        if (i >= 6 && i < 3 * 43) expect = color[i % 3];
+        if (bytes[i] != expect) break;
+    }
+    ok( i == 3 * 45, "byte %u got %02x\n", i, bytes[i] );
+
+    SelectObject( hdcDst, GetStockObject( BLACK_BRUSH ));
+    DeleteObject( brush );
+    DeleteDC( hdcSrc );
+    DeleteDC( hdcDst );
+    DeleteDC( hdcRef );
+    DeleteObject( bmpSrc );
+    DeleteObject( bmpDst );
+    DeleteObject( bmpRef );
+}
+
 /*
  * Used by test_GetDIBits_top_down to create the bitmap to test against.
  */
@@ -5957,6 +6074,7 @@ START_TEST(bitmap)
     test_GdiAlphaBlend();
     test_GdiGradientFill();
     test_32bit_ddb();
+    test_wide_rows();
     test_bitmapinfoheadersize();
     test_get16dibits();
     test_clipping();
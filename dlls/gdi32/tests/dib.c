@@ -26,6 +26,7 @@
 #include "winbase.h"
 #include "wingdi.h"
 #include "winuser.h"
+#include "winreg.h"
 #include "wincrypt.h"
 #include "mmsystem.h" /* DIBINDEX */
 
@@ -3252,11 +3253,149 @@ static void test_simple_graphics(void)
     DeleteDC(mem_dc);
 }
 
+#define BANDED_WIDTH  1024
+#define BANDED_HEIGHT 512
+
+static HBITMAP create_banded_dib( HDC hdc, DWORD **bits )
+{
+    BITMAPINFO bmi;
+    HBITMAP dib;
+    int i;
+
+    memset( &bmi, 0, sizeof(bmi) );
+    bmi.bmiHeader.biSize        = sizeof(bmi.bmiHeader);
+    bmi.bmiHeader.biWidth       = BANDED_WIDTH;
+    bmi.bmiHeader.biHeight      = -BANDED_HEIGHT;
+    bmi.bmiHeader.biPlanes      = 1;
+    bmi.bmiHeader.biBitCount    = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    dib = CreateDIBSection( hdc, &bmi, DIB_RGB_COLORS, (void **)bits, NULL, 0 );
+    ok( dib != NULL, "CreateDIBSection failed\n" );
+    for (i = 0; i < BANDED_WIDTH * BANDED_HEIGHT; i++) (*bits)[i] = i * 0x9e3779b1;
+    return dib;
+}
+
+/* run in a child process, since the "Threads" value is only read before the first operation */
+static void draw_banded( const char *filename )
+{
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 0x80, 0 };
+    TRIVERTEX vrect[] = { { 0, 0, 0x1000, 0x2000, 0xff00, 0x8000 },
+                          { BANDED_WIDTH, BANDED_HEIGHT, 0xff00, 0x0000, 0x3000, 0xc000 } };
+    GRADIENT_RECT rect = { 0, 1 };
+    HDC hdc, src_dc;
+    HBITMAP dib, src_dib, old, old_src;
+    DWORD *bits, *src_bits, written;
+    HANDLE file;
+
+    hdc = CreateCompatibleDC( 0 );
+    src_dc = CreateCompatibleDC( 0 );
+    dib = create_banded_dib( hdc, &bits );
+    src_dib = create_banded_dib( src_dc, &src_bits );
+    old = SelectObject( hdc, dib );
+    old_src = SelectObject( src_dc, src_dib );
+
+    BitBlt( hdc, 3, 0, BANDED_WIDTH - 3, BANDED_HEIGHT, hdc, 0, 0, SRCCOPY );
+    BitBlt( hdc, 0, 1, BANDED_WIDTH, BANDED_HEIGHT - 1, src_dc, 5, 0, SRCINVERT );
+    SetStretchBltMode( hdc, COLORONCOLOR );
+    StretchBlt( hdc, 0, 0, BANDED_WIDTH, BANDED_HEIGHT, src_dc, 10, 10, 300, 200, SRCCOPY );
+    StretchBlt( hdc, 7, 3, 700, 400, src_dc, 0, 0, BANDED_WIDTH, BANDED_HEIGHT, SRCPAINT );
+    GdiAlphaBlend( hdc, 0, 0, BANDED_WIDTH, BANDED_HEIGHT, src_dc, 0, 0, BANDED_WIDTH, BANDED_HEIGHT, blend );
+    GdiGradientFill( hdc, vrect, 2, &rect, 1, GRADIENT_FILL_RECT_H );
+    GdiFlush();
+
+    file = CreateFileA( filename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL );
+    ok( file != INVALID_HANDLE_VALUE, "CreateFile failed, error %u\n", GetLastError() );
+    WriteFile( file, bits, BANDED_WIDTH * BANDED_HEIGHT * sizeof(*bits), &written, NULL );
+    CloseHandle( file );
+
+    SelectObject( src_dc, old_src );
+    SelectObject( hdc, old );
+    DeleteObject( src_dib );
+    DeleteObject( dib );
+    DeleteDC( src_dc );
+    DeleteDC( hdc );
+}
+
+static DWORD *run_banded_child( HKEY key, const char *threads, const char *filename )
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH * 2];
+    DWORD size = BANDED_WIDTH * BANDED_HEIGHT * sizeof(DWORD), read = 0;
+    DWORD *bits;
+    HANDLE file;
+    char **argv;
+
+    RegSetValueExA( key, "Threads", 0, REG_SZ, (const BYTE *)threads, strlen(threads) + 1 );
+
+    winetest_get_mainargs( &argv );
+    sprintf( cmdline, "\"%s\" dib banded \"%s\"", argv[0], filename );
+    if (!CreateProcessA( NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi ))
+    {
+        ok( 0, "CreateProcess failed, error %u\n", GetLastError() );
+        return NULL;
+    }
+    winetest_wait_child_process( pi.hProcess );
+    CloseHandle( pi.hProcess );
+    CloseHandle( pi.hThread );
+
+    bits = HeapAlloc( GetProcessHeap(), 0, size );
+    file = CreateFileA( filename, GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, NULL );
+    ok( file != INVALID_HANDLE_VALUE, "CreateFile failed, error %u\n", GetLastError() );
+    ReadFile( file, bits, size, &read, NULL );
+    CloseHandle( file );
+    DeleteFileA( filename );
+    ok( read == size, "read %u bytes\n", read );
+    return bits;
+}
+
+static void test_banded_operations(void)
+{
+    char path[MAX_PATH], filename[MAX_PATH], old_value[16];
+    DWORD *serial, *banded, type, size = sizeof(old_value);
+    BOOL restore;
+    HKEY key;
+
+    if (RegCreateKeyA( HKEY_CURRENT_USER, "Software\\Wine\\DIB Engine", &key ))
+    {
+        skip( "can't create the DIB Engine key\n" );
+        return;
+    }
+    restore = !RegQueryValueExA( key, "Threads", NULL, &type, (BYTE *)old_value, &size );
+
+    GetTempPathA( sizeof(path), path );
+    GetTempFileNameA( path, "dib", 0, filename );
+
+    serial = run_banded_child( key, "1", filename );
+    banded = run_banded_child( key, "4", filename );
+    if (serial && banded)
+        ok( !memcmp( serial, banded, BANDED_WIDTH * BANDED_HEIGHT * sizeof(DWORD) ),
+            "banded operations don't match the serial ones\n" );
+    HeapFree( GetProcessHeap(), 0, serial );
+    HeapFree( GetProcessHeap(), 0, banded );
+
+    if (restore) RegSetValueExA( key, "Threads", 0, type, (BYTE *)old_value, size );
+    else RegDeleteValueA( key, "Threads" );
+    RegCloseKey( key );
+}
+
 START_TEST(dib)
 {
+    char **argv;
+    int argc;
+
+    argc = winetest_get_mainargs( &argv );
+    if (argc >= 4 && !strcmp( argv[2], "banded" ))
+    {
+        draw_banded( argv[3] );
+        return;
+    }
+
     CryptAcquireContextW(&crypt_prov, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT);
 
     test_simple_graphics();
+    test_banded_operations();
 
     CryptReleaseContext(crypt_prov, 0);
 }
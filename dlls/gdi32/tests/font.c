@@ -6679,6 +6679,78 @@ static void test_GetCharWidthI(void)
     ReleaseDC(0, hdc);
 }
 
+struct select_font_thread_params
+{
+    HFONT hfont;
+    TEXTMETRICA tm;
+    char face[LF_FACESIZE];
+    LONG failures;
+};
+
+static DWORD WINAPI select_font_thread(void *arg)
+{
+    struct select_font_thread_params *params = arg;
+    char face[LF_FACESIZE];
+    TEXTMETRICA tm;
+    HFONT old_hfont;
+    HDC hdc;
+    int i;
+
+    hdc = CreateCompatibleDC(0);
+    for (i = 0; i < 200; i++)
+    {
+        old_hfont = SelectObject(hdc, params->hfont);
+        GetTextMetricsA(hdc, &tm);
+        GetTextFaceA(hdc, sizeof(face), face);
+        if (tm.tmHeight != params->tm.tmHeight || tm.tmAveCharWidth != params->tm.tmAveCharWidth ||
+            strcmp(face, params->face))
+            InterlockedIncrement(&params->failures);
+        SelectObject(hdc, old_hfont);
+    }
+    DeleteDC(hdc);
+    return 0;
+}
+
+static void test_select_font_threads(void)
+{
+    struct select_font_thread_params params;
+    HANDLE threads[4];
+    HFONT old_hfont;
+    LOGFONTA lf;
+    DWORD tid;
+    HDC hdc;
+    int i;
+
+    memset(&lf, 0, sizeof(lf));
+    strcpy(lf.lfFaceName, "Tahoma");
+    lf.lfHeight = -16;
+    params.hfont = CreateFontIndirectA(&lf);
+    params.failures = 0;
+
+    hdc = CreateCompatibleDC(0);
+    old_hfont = SelectObject(hdc, params.hfont);
+    GetTextMetricsA(hdc, &params.tm);
+    GetTextFaceA(hdc, sizeof(params.face), params.face);
+
+    /* keep the font selected so that the threads share the realized font */
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+    {
+        threads[i] = CreateThread(NULL, 0, select_font_thread, &params, 0, &tid);
+        ok(threads[i] != NULL, "CreateThread failed %u\n", GetLastError());
+    }
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+    {
+        if (!threads[i]) continue;
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+    ok(!params.failures, "got %d mismatches\n", params.failures);
+
+    SelectObject(hdc, old_hfont);
+    DeleteDC(hdc);
+    DeleteObject(params.hfont);
+}
+
 START_TEST(font)
 {
     init();
@@ -6742,6 +6814,7 @@ START_TEST(font)
     test_fake_bold_font();
     test_bitmap_font_glyph_index();
     test_GetCharWidthI();
+    test_select_font_threads();
 
     /* These tests should be last test until RemoveFontResource
      * is properly implemented.
@@ -457,29 +457,23 @@ static BOOL set_registry_environment( BOOL volatile_only )
 
 
 /***********************************************************************
- *           get_reg_value
+ *           reg_data_to_string
+ *
+ * Convert the data of a REG_SZ or REG_EXPAND_SZ value to an allocated string.
  */
-static WCHAR *get_reg_value( HKEY hkey, const WCHAR *name )
+static WCHAR *reg_data_to_string( ULONG type, const void *data, DWORD size )
 {
-    char buffer[1024 * sizeof(WCHAR) + sizeof(KEY_VALUE_PARTIAL_INFORMATION)];
-    KEY_VALUE_PARTIAL_INFORMATION *info = (KEY_VALUE_PARTIAL_INFORMATION *)buffer;
-    DWORD len, size = sizeof(buffer);
+    DWORD len = size / sizeof(WCHAR);
     WCHAR *ret = NULL;
-    UNICODE_STRING nameW;
 
-    RtlInitUnicodeString( &nameW, name );
-    if (NtQueryValueKey( hkey, &nameW, KeyValuePartialInformation, buffer, size, &size ))
-        return NULL;
-
-    if (size <= FIELD_OFFSET( KEY_VALUE_PARTIAL_INFORMATION, Data )) return NULL;
-    len = (size - FIELD_OFFSET( KEY_VALUE_PARTIAL_INFORMATION, Data )) / sizeof(WCHAR);
+    if (!len) return NULL;
 
-    if (info->Type == REG_EXPAND_SZ)
+    if (type == REG_EXPAND_SZ)
     {
         UNICODE_STRING value, expanded;
 
         value.MaximumLength = len * sizeof(WCHAR);
-        value.Buffer = (WCHAR *)info->Data;
+        value.Buffer = (WCHAR *)data;
         if (!value.Buffer[len - 1]) len--;  /* don't count terminating null if any */
         value.Length = len * sizeof(WCHAR);
         expanded.Length = expanded.MaximumLength = 1024 * sizeof(WCHAR);
@@ -487,11 +481,11 @@ static WCHAR *get_reg_value( HKEY hkey, const WCHAR *name )
         if (!RtlExpandEnvironmentStrings_U( NULL, &value, &expanded, NULL )) ret = expanded.Buffer;
         else RtlFreeUnicodeString( &expanded );
     }
-    else if (info->Type == REG_SZ)
+    else if (type == REG_SZ)
     {
         if ((ret = HeapAlloc( GetProcessHeap(), 0, (len + 1) * sizeof(WCHAR) )))
         {
-            memcpy( ret, info->Data, len * sizeof(WCHAR) );
+            memcpy( ret, data, len * sizeof(WCHAR) );
             ret[len] = 0;
         }
     }
@@ -499,6 +493,59 @@ static WCHAR *get_reg_value( HKEY hkey, const WCHAR *name )
 }
 
 
+/***********************************************************************
+ *           get_reg_value
+ */
+static WCHAR *get_reg_value( HKEY hkey, const WCHAR *name )
+{
+    char buffer[1024 * sizeof(WCHAR) + sizeof(KEY_VALUE_PARTIAL_INFORMATION)];
+    KEY_VALUE_PARTIAL_INFORMATION *info = (KEY_VALUE_PARTIAL_INFORMATION *)buffer;
+    DWORD size = sizeof(buffer);
+    UNICODE_STRING nameW;
+
+    RtlInitUnicodeString( &nameW, name );
+    if (NtQueryValueKey( hkey, &nameW, KeyValuePartialInformation, buffer, size, &size ))
+        return NULL;
+
+    if (size <= FIELD_OFFSET( KEY_VALUE_PARTIAL_INFORMATION, Data )) return NULL;
+    return reg_data_to_string( info->Type, info->Data, size - FIELD_OFFSET( KEY_VALUE_PARTIAL_INFORMATION, Data ));
+}
+
+
+#define MAX_REG_VALUES 4
+
+/***********************************************************************
+ *           get_reg_values
+ *
+ * Retrieve several values of a key at once, or one by one if some are missing.
+ */
+static void get_reg_values( HKEY hkey, const WCHAR * const *names, WCHAR **values, unsigned int count )
+{
+    KEY_MULTIPLE_VALUE_INFORMATION info[MAX_REG_VALUES];
+    UNICODE_STRING nameW[MAX_REG_VALUES];
+    WCHAR buffer[MAX_REG_VALUES * 1024];
+    unsigned int i;
+
+    assert( count <= MAX_REG_VALUES );
+
+    for (i = 0; i < count; i++)
+    {
+        RtlInitUnicodeString( &nameW[i], names[i] );
+        info[i].ValueName = &nameW[i];
+    }
+
+    if (NtQueryMultipleValueKey( hkey, info, count, buffer, sizeof(buffer), NULL ))
+    {
+        for (i = 0; i < count; i++) values[i] = get_reg_value( hkey, names[i] );
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+        values[i] = reg_data_to_string( info[i].Type, (char *)buffer + info[i].DataOffset,
+                                        info[i].DataLength );
+}
+
+
 /***********************************************************************
  *           set_additional_environment
  *
@@ -519,7 +566,9 @@ static void set_additional_environment(void)
     static const WCHAR allusersW[] = {'A','L','L','U','S','E','R','S','P','R','O','F','I','L','E',0};
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING nameW;
-    WCHAR *profile_dir = NULL, *all_users_dir = NULL;
+    const WCHAR *names[] = { profiles_valueW, all_users_valueW };
+    WCHAR *values[2] = { NULL, NULL };
+    WCHAR *profile_dir, *all_users_dir;
     WCHAR buf[MAX_COMPUTERNAME_LENGTH+1];
     HANDLE hkey;
     DWORD len;
@@ -540,10 +589,11 @@ static void set_additional_environment(void)
     RtlInitUnicodeString( &nameW, profile_keyW );
     if (!NtOpenKey( &hkey, KEY_READ, &attr ))
     {
-        profile_dir = get_reg_value( hkey, profiles_valueW );
-        all_users_dir = get_reg_value( hkey, all_users_valueW );
+        get_reg_values( hkey, names, values, 2 );
         NtClose( hkey );
     }
+    profile_dir = values[0];
+    all_users_dir = values[1];
 
     if (profile_dir && all_users_dir)
     {
@@ -588,10 +638,13 @@ static void set_wow64_environment(void)
     static const WCHAR commonfilesW[] = {'C','o','m','m','o','n','P','r','o','g','r','a','m','F','i','l','e','s',0};
     static const WCHAR commonw6432W[] = {'C','o','m','m','o','n','P','r','o','g','r','a','m','W','6','4','3','2',0};
 
+    /* the (x86) values are only needed, and only present, in 64-bit prefixes */
+    const WCHAR *names[] = { progdirW, commondirW, progdir86W, commondir86W };
+    WCHAR *values[4];
+    unsigned int i;
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING nameW;
     WCHAR arch[64];
-    WCHAR *value;
     HANDLE hkey;
 
     /* set the PROCESSOR_ARCHITECTURE variable */
@@ -622,35 +675,29 @@ static void set_wow64_environment(void)
     RtlInitUnicodeString( &nameW, versionW );
     if (NtOpenKey( &hkey, KEY_READ | KEY_WOW64_64KEY, &attr )) return;
 
+    values[2] = values[3] = NULL;
+    get_reg_values( hkey, names, values, is_wow64 ? 4 : 2 );
+    NtClose( hkey );
+
     /* set the ProgramFiles variables */
 
-    if ((value = get_reg_value( hkey, progdirW )))
-    {
-        if (is_win64 || is_wow64) SetEnvironmentVariableW( progw6432W, value );
-        if (is_win64 || !is_wow64) SetEnvironmentVariableW( progfilesW, value );
-        HeapFree( GetProcessHeap(), 0, value );
-    }
-    if (is_wow64 && (value = get_reg_value( hkey, progdir86W )))
+    if (values[0])
     {
-        SetEnvironmentVariableW( progfilesW, value );
-        HeapFree( GetProcessHeap(), 0, value );
+        if (is_win64 || is_wow64) SetEnvironmentVariableW( progw6432W, values[0] );
+        if (is_win64 || !is_wow64) SetEnvironmentVariableW( progfilesW, values[0] );
     }
+    if (values[2]) SetEnvironmentVariableW( progfilesW, values[2] );
 
     /* set the CommonProgramFiles variables */
 
-    if ((value = get_reg_value( hkey, commondirW )))
+    if (values[1])
     {
-        if (is_win64 || is_wow64) SetEnvironmentVariableW( commonw6432W, value );
-        if (is_win64 || !is_wow64) SetEnvironmentVariableW( commonfilesW, value );
-        HeapFree( GetProcessHeap(), 0, value );
-    }
-    if (is_wow64 && (value = get_reg_value( hkey, commondir86W )))
-    {
-        SetEnvironmentVariableW( commonfilesW, value );
-        HeapFree( GetProcessHeap(), 0, value );
+        if (is_win64 || is_wow64) SetEnvironmentVariableW( commonw6432W, values[1] );
+        if (is_win64 || !is_wow64) SetEnvironmentVariableW( commonfilesW, values[1] );
     }
+    if (values[3]) SetEnvironmentVariableW( commonfilesW, values[3] );
 
-    NtClose( hkey );
+    for (i = 0; i < 4; i++) HeapFree( GetProcessHeap(), 0, values[i] );
 }
 
 /***********************************************************************
@@ -39,6 +39,7 @@
 #define HEAP_VALIDATE_PARAMS  0x40000000
 
 static BOOL (WINAPI *pHeapQueryInformation)(HANDLE, HEAP_INFORMATION_CLASS, PVOID, SIZE_T, PSIZE_T);
+static BOOL (WINAPI *pHeapSetInformation)(HANDLE, HEAP_INFORMATION_CLASS, PVOID, SIZE_T);
 static BOOL (WINAPI *pGetPhysicallyInstalledSystemMemory)(ULONGLONG *);
 static ULONG (WINAPI *pRtlGetNtGlobalFlags)(void);
 
@@ -874,6 +875,126 @@ static void test_HeapQueryInformation(void)
     ok(info == 0 || info == 1 || info == 2, "expected 0, 1 or 2, got %u\n", info);
 }
 
+static DWORD WINAPI lfh_thread( void *arg )
+{
+    HANDLE heap = arg;
+    BYTE *ptrs[64];
+    SIZE_T sizes[64], size;
+    DWORD seed = GetCurrentThreadId();
+    unsigned int i, j, k;
+    BOOL ret;
+
+    memset( ptrs, 0, sizeof(ptrs) );
+    for (i = 0; i < 20000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        k = (seed >> 16) % 64;
+        if (ptrs[k])
+        {
+            size = HeapSize( heap, 0, ptrs[k] );
+            ok( size == sizes[k], "wrong size %lu/%lu\n", size, sizes[k] );
+            for (j = 0; j < sizes[k]; j++) if (ptrs[k][j] != (BYTE)k) break;
+            ok( j == sizes[k], "block %p corrupted at %u\n", ptrs[k], j );
+            if (i % 3)
+            {
+                ret = HeapFree( heap, 0, ptrs[k] );
+                ok( ret, "HeapFree failed\n" );
+                ptrs[k] = NULL;
+                continue;
+            }
+            sizes[k] = (seed >> 8) % 1100;
+            ptrs[k] = HeapReAlloc( heap, 0, ptrs[k], sizes[k] );
+        }
+        else
+        {
+            sizes[k] = (seed >> 8) % 1100;
+            ptrs[k] = HeapAlloc( heap, HEAP_ZERO_MEMORY, sizes[k] );
+            ok( ptrs[k] != NULL, "HeapAlloc failed\n" );
+            for (j = 0; j < sizes[k]; j++) if (ptrs[k][j]) break;
+            ok( j == sizes[k], "block %p not zeroed at %u\n", ptrs[k], j );
+        }
+        ok( ptrs[k] != NULL, "allocation failed\n" );
+        if (!ptrs[k]) break;
+        memset( ptrs[k], k, sizes[k] );
+    }
+    for (k = 0; k < 64; k++) HeapFree( heap, 0, ptrs[k] );
+    return 0;
+}
+
+static void test_lfh(void)
+{
+    HANDLE heap, threads[8];
+    ULONG info;
+    BYTE *p, *p2;
+    SIZE_T size;
+    unsigned int i;
+    BOOL ret;
+
+    pHeapSetInformation = (void *)GetProcAddress(GetModuleHandleA("kernel32.dll"), "HeapSetInformation");
+    if (!pHeapSetInformation || !pHeapQueryInformation)
+    {
+        win_skip("HeapSetInformation is not available\n");
+        return;
+    }
+
+    heap = HeapCreate( HEAP_NO_SERIALIZE, 0, 0 );
+    ok( heap != NULL, "HeapCreate failed\n" );
+    info = 2;
+    ret = pHeapSetInformation( heap, HeapCompatibilityInformation, &info, sizeof(info) );
+    ok( !ret, "LFH enabled on a non-serialized heap\n" );
+    HeapDestroy( heap );
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( heap != NULL, "HeapCreate failed\n" );
+    info = 2;
+    ret = pHeapSetInformation( heap, HeapCompatibilityInformation, &info, sizeof(info) );
+    if (!ret && IsDebuggerPresent())
+    {
+        skip("LFH is disabled under a debugger\n");
+        HeapDestroy( heap );
+        return;
+    }
+    ok( ret, "HeapSetInformation failed %u\n", GetLastError() );
+    info = 0xdeadbeef;
+    ret = pHeapQueryInformation( heap, HeapCompatibilityInformation, &info, sizeof(info), NULL );
+    ok( ret, "HeapQueryInformation failed %u\n", GetLastError() );
+    ok( info == 2, "expected 2, got %u\n", info );
+
+    p = HeapAlloc( heap, 0, 17 );
+    ok( p != NULL, "HeapAlloc failed\n" );
+    ok( HeapValidate( heap, 0, p ), "HeapValidate failed\n" );
+    size = HeapSize( heap, 0, p );
+    ok( size == 17, "wrong size %lu\n", size );
+    memset( p, 0x55, 17 );
+
+    p2 = HeapReAlloc( heap, HEAP_ZERO_MEMORY, p, 20 );
+    ok( p2 != NULL, "HeapReAlloc failed\n" );
+    size = HeapSize( heap, 0, p2 );
+    ok( size == 20, "wrong size %lu\n", size );
+    ok( p2[16] == 0x55, "wrong data %x\n", p2[16] );
+    ok( !p2[17] && !p2[18] && !p2[19], "data not zeroed\n" );
+
+    p = HeapReAlloc( heap, 0, p2, 5000 );
+    ok( p != NULL, "HeapReAlloc failed\n" );
+    size = HeapSize( heap, 0, p );
+    ok( size == 5000, "wrong size %lu\n", size );
+    ok( p[16] == 0x55, "wrong data %x\n", p[16] );
+    ret = HeapFree( heap, 0, p );
+    ok( ret, "HeapFree failed\n" );
+
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+        threads[i] = CreateThread( NULL, 0, lfh_thread, heap, 0, NULL );
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+    {
+        ok( !WaitForSingleObject( threads[i], 60000 ), "thread %u didn't finish\n", i );
+        CloseHandle( threads[i] );
+    }
+
+    ok( HeapValidate( heap, 0, NULL ), "HeapValidate failed\n" );
+    ret = HeapDestroy( heap );
+    ok( ret, "HeapDestroy failed\n" );
+}
+
 static void test_heap_checks( DWORD flags )
 {
     BYTE old, *p, *p2;
@@ -1227,6 +1348,7 @@ START_TEST(heap)
     test_sized_HeapReAlloc((1 << 20), 1);
 
     test_HeapQueryInformation();
+    test_lfh();
     test_GetPhysicallyInstalledSystemMemory();
 
     if (pRtlGetNtGlobalFlags)
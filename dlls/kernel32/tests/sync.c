@@ -2648,6 +2648,112 @@ static void test_apc_deadlock(void)
     CloseHandle(pi.hProcess);
 }
 
+static void test_cross_process_child(void)
+{
+    HANDLE start, done, manual, sem;
+    DWORD ret;
+    LONG prev;
+    int i;
+
+    start = OpenEventA( EVENT_ALL_ACCESS, FALSE, "winetest_sync_start" );
+    ok( start != NULL, "OpenEvent failed with %u\n", GetLastError() );
+    done = OpenEventA( EVENT_ALL_ACCESS, FALSE, "winetest_sync_done" );
+    ok( done != NULL, "OpenEvent failed with %u\n", GetLastError() );
+    manual = OpenEventA( SYNCHRONIZE, FALSE, "winetest_sync_manual" );
+    ok( manual != NULL, "OpenEvent failed with %u\n", GetLastError() );
+    sem = OpenSemaphoreA( SEMAPHORE_ALL_ACCESS, FALSE, "winetest_sync_sem" );
+    ok( sem != NULL, "OpenSemaphore failed with %u\n", GetLastError() );
+
+    for (i = 0; i < 100; i++)
+    {
+        ret = WaitForSingleObject( start, 5000 );
+        ok( ret == WAIT_OBJECT_0, "%u: WaitForSingleObject returned %u\n", i, ret );
+        ret = WaitForSingleObject( start, 0 );
+        ok( ret == WAIT_TIMEOUT, "%u: WaitForSingleObject returned %u\n", i, ret );
+        SetEvent( done );
+    }
+
+    ret = WaitForSingleObject( manual, 5000 );
+    ok( ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret );
+    ret = WaitForSingleObject( manual, 0 );
+    ok( ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret );
+
+    prev = 0xdeadbeef;
+    ret = ReleaseSemaphore( sem, 2, &prev );
+    ok( ret, "ReleaseSemaphore failed with %u\n", GetLastError() );
+    ok( !prev, "got previous count %d\n", prev );
+    SetLastError( 0xdeadbeef );
+    ret = ReleaseSemaphore( sem, 1, NULL );
+    ok( !ret, "ReleaseSemaphore succeeded\n" );
+    ok( GetLastError() == ERROR_TOO_MANY_POSTS, "got error %u\n", GetLastError() );
+    SetEvent( done );
+
+    CloseHandle( sem );
+    CloseHandle( manual );
+    CloseHandle( done );
+    CloseHandle( start );
+}
+
+/* this uses the shared state from both processes, which needs WINEFASTSYNC in the server environment */
+static void test_cross_process(void)
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH];
+    HANDLE start, done, manual, sem;
+    BOOL success;
+    char **argv;
+    DWORD ret;
+    int i;
+
+    if (!getenv( "WINEFASTSYNC" ))
+    {
+        skip( "WINEFASTSYNC is not set, not testing shared synchronization objects\n" );
+        return;
+    }
+
+    start = CreateEventA( NULL, FALSE, FALSE, "winetest_sync_start" );
+    ok( start != NULL, "CreateEvent failed with %u\n", GetLastError() );
+    done = CreateEventA( NULL, FALSE, FALSE, "winetest_sync_done" );
+    ok( done != NULL, "CreateEvent failed with %u\n", GetLastError() );
+    manual = CreateEventA( NULL, TRUE, FALSE, "winetest_sync_manual" );
+    ok( manual != NULL, "CreateEvent failed with %u\n", GetLastError() );
+    sem = CreateSemaphoreA( NULL, 0, 2, "winetest_sync_sem" );
+    ok( sem != NULL, "CreateSemaphore failed with %u\n", GetLastError() );
+
+    winetest_get_mainargs( &argv );
+    sprintf( cmdline, "\"%s\" sync cross_process", argv[0] );
+    success = CreateProcessA( argv[0], cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi );
+    ok( success, "CreateProcess failed with %u\n", GetLastError() );
+
+    /* signal both before and after the child starts waiting */
+    for (i = 0; i < 100; i++)
+    {
+        if (i % 2) Sleep( 1 );
+        SetEvent( start );
+        ret = WaitForSingleObject( done, 5000 );
+        ok( ret == WAIT_OBJECT_0, "%u: WaitForSingleObject returned %u\n", i, ret );
+    }
+
+    SetEvent( manual );
+    ret = WaitForSingleObject( done, 5000 );
+    ok( ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret );
+    ret = WaitForSingleObject( sem, 0 );
+    ok( ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret );
+    ret = WaitForSingleObject( sem, 0 );
+    ok( ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret );
+    ret = WaitForSingleObject( sem, 0 );
+    ok( ret == WAIT_TIMEOUT, "WaitForSingleObject returned %u\n", ret );
+
+    winetest_wait_child_process( pi.hProcess );
+    CloseHandle( pi.hThread );
+    CloseHandle( pi.hProcess );
+    CloseHandle( sem );
+    CloseHandle( manual );
+    CloseHandle( done );
+    CloseHandle( start );
+}
+
 START_TEST(sync)
 {
     char **argv;
@@ -2694,6 +2800,7 @@ START_TEST(sync)
         {
             for (;;) SleepEx(INFINITE, TRUE);
         }
+        if (!strcmp(argv[2], "cross_process")) test_cross_process_child();
         return;
     }
 
@@ -2715,4 +2822,5 @@ START_TEST(sync)
     test_srwlock_example();
     test_alertable_wait();
     test_apc_deadlock();
+    test_cross_process();
 }
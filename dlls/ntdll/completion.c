@@ -0,0 +1,852 @@
+/*
+ * Process-local I/O completion queues
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * When the WINEFASTIOCP environment variable is set, the completion ports
+ * created by the process get a completion queue in the process in addition
+ * to the server object. Completions posted from the process to a port, or
+ * to a file associated with it, are stored in that queue, and the server is
+ * only involved when a thread has to wait for the port: it then waits on the
+ * server object and on a semaphore of the port, which is released by the
+ * threads posting local completions, once for every waiter that hasn't been
+ * woken up yet. Completions queued by the server, e.g. from other processes,
+ * are still retrieved from the server object.
+ *
+ * Asynchronous socket operations on sockets associated with such a port are
+ * also handled in the process: instead of being queued in the server, they
+ * are polled by a thread of the process with epoll, which runs the async
+ * callbacks and posts the completions to the local queue. The asyncs that are
+ * ready are moved to the running list of their file under the files lock,
+ * and their callbacks are run once the lock has been released.
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_EPOLL_H
+# include <sys/epoll.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#define NONAMELESSUNION
+#include "windef.h"
+#include "winternl.h"
+#include "wine/server.h"
+#include "wine/list.h"
+#include "wine/rbtree.h"
+#include "wine/debug.h"
+#include "ntdll_misc.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(ntdll);
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE)
+# define USE_EPOLL
+#endif
+
+struct local_completion
+{
+    struct list           entry;      /* entry in the port queue */
+    ULONG_PTR             ckey;       /* completion key */
+    ULONG_PTR             cvalue;     /* completion value */
+    NTSTATUS              status;     /* completion status */
+    ULONG_PTR             info;       /* number of bytes transferred */
+};
+
+struct local_port
+{
+    struct list           entry;      /* entry in the list of local ports */
+    HANDLE                handle;     /* handle to the server completion object */
+    LONG                  refcount;   /* reference count */
+    HANDLE                wake;       /* semaphore released to wake up the waiting threads */
+    unsigned int          waiters;    /* number of threads waiting on the port */
+    unsigned int          wakes;      /* number of times the semaphore has been released for them */
+    RTL_CRITICAL_SECTION  cs;         /* protects the queue */
+    struct list           queue;      /* queued completions */
+    ULONG                 depth;      /* number of queued completions */
+};
+
+struct local_async
+{
+    struct list           entry;      /* entry in the file read or write queue */
+    void                 *user;       /* async callback data, starting with the callback */
+    local_async_batch_func batch;     /* optional function to process several asyncs at once */
+    IO_STATUS_BLOCK      *iosb;       /* I/O status block of the operation */
+    HANDLE                event;      /* event to signal on completion */
+    ULONG_PTR             cvalue;     /* completion value, 0 if no completion */
+    DWORD                 tid;        /* id of the thread that started the operation */
+    NTSTATUS              status;     /* status to terminate it with, STATUS_PENDING if none */
+};
+
+struct local_file
+{
+    struct wine_rb_entry  entry;      /* entry in the files tree */
+    HANDLE                handle;     /* file handle */
+    LONG                  refcount;   /* reference count */
+    BOOL                  closed;     /* has the handle been closed? */
+    struct local_port    *port;       /* associated completion port */
+    ULONG_PTR             ckey;       /* associated completion key */
+    int                   fd;         /* private unix fd registered with epoll, or -1 */
+    unsigned int          events;     /* currently registered poll events */
+    struct list           reads;      /* queued read operations */
+    struct list           writes;     /* queued write operations */
+    struct list           running;    /* operations whose callbacks are being run by the epoll thread */
+};
+
+static int local_iocp = -1;  /* whether local completion queues are enabled, -1 if not checked yet */
+
+static struct list local_ports = LIST_INIT( local_ports );
+static RTL_SRWLOCK ports_lock = RTL_SRWLOCK_INIT;
+
+static int compare_local_file( const void *key, const struct wine_rb_entry *entry );
+static struct wine_rb_tree local_files = { compare_local_file };
+
+#ifdef USE_EPOLL
+static int epoll_fd = -1;
+#endif
+
+static RTL_CRITICAL_SECTION files_section;
+static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
+{
+    0, 0, &files_section,
+    { &critsect_debug.ProcessLocksList, &critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": files_section") }
+};
+static RTL_CRITICAL_SECTION files_section = { &critsect_debug, -1, 0, 0, 0, 0 };
+
+static int compare_local_file( const void *key, const struct wine_rb_entry *entry )
+{
+    HANDLE handle = WINE_RB_ENTRY_VALUE( entry, struct local_file, entry )->handle;
+
+    if (key < handle) return -1;
+    if (key > handle) return 1;
+    return 0;
+}
+
+/* find the local data of a file; caller must hold files_section */
+static struct local_file *find_local_file( HANDLE handle )
+{
+    struct wine_rb_entry *entry = wine_rb_get( &local_files, handle );
+    return entry ? WINE_RB_ENTRY_VALUE( entry, struct local_file, entry ) : NULL;
+}
+
+/* find a local port and grab a reference to it */
+static struct local_port *grab_local_port( HANDLE handle )
+{
+    struct local_port *port, *ret = NULL;
+
+    RtlAcquireSRWLockShared( &ports_lock );
+    LIST_FOR_EACH_ENTRY( port, &local_ports, struct local_port, entry )
+    {
+        if (port->handle != handle) continue;
+        interlocked_xchg_add( &port->refcount, 1 );
+        ret = port;
+        break;
+    }
+    RtlReleaseSRWLockShared( &ports_lock );
+    return ret;
+}
+
+static void release_local_port( struct local_port *port )
+{
+    struct local_completion *comp, *next;
+
+    if (interlocked_xchg_add( &port->refcount, -1 ) > 1) return;
+
+    LIST_FOR_EACH_ENTRY_SAFE( comp, next, &port->queue, struct local_completion, entry )
+        RtlFreeHeap( GetProcessHeap(), 0, comp );
+    port->cs.DebugInfo->Spare[0] = 0;
+    RtlDeleteCriticalSection( &port->cs );
+    NtClose( port->wake );
+    RtlFreeHeap( GetProcessHeap(), 0, port );
+}
+
+static void release_local_file( struct local_file *file )
+{
+    if (interlocked_xchg_add( &file->refcount, -1 ) > 1) return;
+
+    if (file->fd != -1) close( file->fd );
+    release_local_port( file->port );
+    RtlFreeHeap( GetProcessHeap(), 0, file );
+}
+
+/* queue a completion on the server object */
+static NTSTATUS add_server_completion( HANDLE handle, ULONG_PTR ckey, ULONG_PTR cvalue,
+                                       NTSTATUS status, ULONG_PTR info )
+{
+    NTSTATUS ret;
+
+    SERVER_START_REQ( add_completion )
+    {
+        req->handle      = wine_server_obj_handle( handle );
+        req->ckey        = ckey;
+        req->cvalue      = cvalue;
+        req->status      = status;
+        req->information = info;
+        ret = wine_server_call( req );
+    }
+    SERVER_END_REQ;
+    return ret;
+}
+
+/* queue a completion on the local queue of a port, and wake up a waiting thread if needed */
+static void post_local_completion( struct local_port *port, ULONG_PTR ckey, ULONG_PTR cvalue,
+                                   NTSTATUS status, ULONG_PTR info )
+{
+    struct local_completion *comp;
+    BOOL wake = FALSE;
+
+    if (!(comp = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*comp) )))
+    {
+        add_server_completion( port->handle, ckey, cvalue, status, info );
+        return;
+    }
+    comp->ckey   = ckey;
+    comp->cvalue = cvalue;
+    comp->status = status;
+    comp->info   = info;
+
+    RtlEnterCriticalSection( &port->cs );
+    list_add_tail( &port->queue, &comp->entry );
+    port->depth++;
+    if (port->waiters > port->wakes)
+    {
+        port->wakes++;
+        wake = TRUE;
+    }
+    RtlLeaveCriticalSection( &port->cs );
+
+    if (wake) NtReleaseSemaphore( port->wake, 1, NULL );
+}
+
+/* retrieve completions from the local queue of a port, or register as a waiter if it's empty */
+static ULONG remove_local_completions( struct local_port *port, FILE_IO_COMPLETION_INFORMATION *info,
+                                       ULONG count, BOOL add_waiter )
+{
+    struct list removed = LIST_INIT( removed );
+    struct local_completion *comp, *next;
+    struct list *ptr;
+    ULONG i = 0;
+
+    RtlEnterCriticalSection( &port->cs );
+    while (i < count && (ptr = list_head( &port->queue )))
+    {
+        list_remove( ptr );
+        list_add_tail( &removed, ptr );
+        port->depth--;
+        i++;
+    }
+    if (!i && add_waiter) port->waiters++;
+    RtlLeaveCriticalSection( &port->cs );
+
+    i = 0;
+    LIST_FOR_EACH_ENTRY_SAFE( comp, next, &removed, struct local_completion, entry )
+    {
+        info[i].CompletionKey             = comp->ckey;
+        info[i].CompletionValue           = comp->cvalue;
+        info[i].IoStatusBlock.u.Status    = comp->status;
+        info[i].IoStatusBlock.Information = comp->info;
+        RtlFreeHeap( GetProcessHeap(), 0, comp );
+        i++;
+    }
+    return i;
+}
+
+/* run the callback of an async operation, return FALSE if it's still pending; called without files_section */
+static BOOL run_local_async( struct local_port *port, ULONG_PTR ckey, struct local_async *async,
+                             NTSTATUS status )
+{
+    NTSTATUS (**func)(void *, IO_STATUS_BLOCK *, NTSTATUS) = async->user;
+
+    if ((status = (*func)( async->user, async->iosb, status )) == STATUS_PENDING) return FALSE;
+
+    if (status != STATUS_MORE_PROCESSING_REQUIRED)  /* else don't report the completion */
+    {
+        if (async->cvalue)
+            post_local_completion( port, ckey, async->cvalue, status, async->iosb->Information );
+        if (async->event) NtSetEvent( async->event, NULL );
+    }
+    return TRUE;
+}
+
+/* terminate the asyncs of a list with their status, and free them; called without files_section */
+static void terminate_async_list( struct local_port *port, ULONG_PTR ckey, struct list *list )
+{
+    struct local_async *async, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( async, next, list, struct local_async, entry )
+    {
+        run_local_async( port, ckey, async, async->status );
+        list_remove( &async->entry );
+        RtlFreeHeap( GetProcessHeap(), 0, async );
+    }
+}
+
+#ifdef USE_EPOLL
+
+/* update the events polled for a file; caller must hold files_section */
+static BOOL update_file_events( struct local_file *file )
+{
+    struct epoll_event ev;
+    unsigned int events = 0;
+    int op;
+
+    if (!list_empty( &file->reads )) events |= EPOLLIN;
+    if (!list_empty( &file->writes )) events |= EPOLLOUT;
+    if (events == file->events) return TRUE;
+
+    /* error and hangup conditions are always reported, so idle files are removed from the set */
+    if (!events) op = EPOLL_CTL_DEL;
+    else if (!file->events) op = EPOLL_CTL_ADD;
+    else op = EPOLL_CTL_MOD;
+
+    ev.events = events;
+    ev.data.u64 = wine_server_obj_handle( file->handle );
+    if (epoll_ctl( epoll_fd, op, file->fd, &ev ) == -1)
+    {
+        WARN( "epoll_ctl failed for %p: %s\n", file->handle, strerror(errno) );
+        return FALSE;
+    }
+    file->events = events;
+    return TRUE;
+}
+
+/* maximum number of asyncs run at once for a file queue */
+#define MAX_ASYNC_BATCH 64
+
+/* asyncs taken from the queue of a file to be run outside of files_section */
+struct async_run
+{
+    struct local_file  *file;
+    struct local_port  *port;
+    ULONG_PTR           ckey;
+    struct list        *queue;     /* queue the asyncs have been taken from */
+    unsigned int        count;     /* number of asyncs taken */
+    unsigned int        done;      /* number of asyncs that are no longer pending */
+    struct local_async *asyncs[MAX_ASYNC_BATCH];
+};
+
+/* move the first asyncs of a queue to the running list; caller must hold files_section */
+static void start_async_run( struct async_run *run, struct local_file *file, struct list *queue )
+{
+    struct list *ptr;
+
+    run->file  = file;
+    run->port  = file->port;
+    run->ckey  = file->ckey;
+    run->queue = queue;
+    run->count = run->done = 0;
+    while (run->count < MAX_ASYNC_BATCH && (ptr = list_head( queue )))
+    {
+        list_remove( ptr );
+        list_add_tail( &file->running, ptr );
+        run->asyncs[run->count++] = LIST_ENTRY( ptr, struct local_async, entry );
+    }
+    interlocked_xchg_add( &file->refcount, 1 );
+    interlocked_xchg_add( &run->port->refcount, 1 );
+}
+
+/* run the callbacks of the asyncs until one of them is still pending; called without files_section */
+static void process_async_run( struct async_run *run )
+{
+    void *users[MAX_ASYNC_BATCH];
+    unsigned int i;
+
+    /* let the owner of the first asyncs prepare their results with a single system call */
+    for (i = 0; i < run->count; i++)
+    {
+        if (!run->asyncs[i]->batch || run->asyncs[i]->batch != run->asyncs[0]->batch) break;
+        users[i] = run->asyncs[i]->user;
+    }
+    if (i > 1) run->asyncs[0]->batch( run->file->fd, users, i );
+
+    while (run->done < run->count &&
+           run_local_async( run->port, run->ckey, run->asyncs[run->done], STATUS_ALERTED ))
+        run->done++;
+}
+
+/* free the completed asyncs, and queue the pending ones again, unless they have been
+ * terminated in the meantime; caller must hold files_section */
+static void finish_async_run( struct async_run *run, struct list *terminated )
+{
+    struct local_async *async;
+    unsigned int i;
+
+    for (i = 0; i < run->done; i++)
+    {
+        list_remove( &run->asyncs[i]->entry );
+        RtlFreeHeap( GetProcessHeap(), 0, run->asyncs[i] );
+    }
+    /* put them back in reverse order at the head, before the asyncs queued since */
+    for (i = run->count; i > run->done; i--)
+    {
+        async = run->asyncs[i - 1];
+        list_remove( &async->entry );
+        if (run->file->closed && async->status == STATUS_PENDING) async->status = STATUS_HANDLES_CLOSED;
+        if (async->status != STATUS_PENDING) list_add_head( terminated, &async->entry );
+        else list_add_head( run->queue, &async->entry );
+    }
+}
+
+static void WINAPI epoll_thread( LPVOID arg )
+{
+    struct epoll_event events[64];
+    struct async_run runs[2];
+    struct list terminated;
+    struct local_file *file;
+    unsigned int i, j, count, run_count;
+    int ret;
+
+    for (;;)
+    {
+        if ((ret = epoll_wait( epoll_fd, events, sizeof(events) / sizeof(events[0]), -1 )) == -1)
+        {
+            if (errno == EINTR) continue;
+            ERR( "epoll_wait failed: %s\n", strerror(errno) );
+            break;
+        }
+        count = ret;
+
+        for (i = 0; i < count; i++)
+        {
+            run_count = 0;
+            RtlEnterCriticalSection( &files_section );
+            /* the file may have been closed since the events were retrieved */
+            if ((file = find_local_file( wine_server_ptr_handle( (obj_handle_t)events[i].data.u64 ))))
+            {
+                if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && !list_empty( &file->reads ))
+                    start_async_run( &runs[run_count++], file, &file->reads );
+                if ((events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && !list_empty( &file->writes ))
+                    start_async_run( &runs[run_count++], file, &file->writes );
+            }
+            RtlLeaveCriticalSection( &files_section );
+            if (!run_count) continue;
+
+            for (j = 0; j < run_count; j++) process_async_run( &runs[j] );
+
+            list_init( &terminated );
+            RtlEnterCriticalSection( &files_section );
+            for (j = 0; j < run_count; j++) finish_async_run( &runs[j], &terminated );
+            if (!file->closed) update_file_events( file );
+            RtlLeaveCriticalSection( &files_section );
+
+            terminate_async_list( runs[0].port, runs[0].ckey, &terminated );
+            for (j = 0; j < run_count; j++)
+            {
+                release_local_port( runs[j].port );
+                release_local_file( runs[j].file );
+            }
+        }
+    }
+}
+
+/* create the epoll thread if needed; caller must hold files_section */
+static BOOL start_epoll_thread(void)
+{
+    HANDLE thread;
+    int fd;
+
+    if (epoll_fd != -1) return TRUE;
+
+    if ((fd = epoll_create( 128 )) == -1) return FALSE;
+    fcntl( fd, F_SETFD, FD_CLOEXEC );
+    epoll_fd = fd;
+    if (RtlCreateUserThread( GetCurrentProcess(), NULL, FALSE, NULL, 0, 0,
+                             epoll_thread, NULL, &thread, NULL ))
+    {
+        close( fd );
+        epoll_fd = -1;
+        return FALSE;
+    }
+    NtClose( thread );
+    TRACE( "started epoll thread\n" );
+    return TRUE;
+}
+
+#endif  /* USE_EPOLL */
+
+/* move the asyncs of a file to a list to be terminated with the given status, except for
+ * the running ones that are only marked for termination; caller must hold files_section */
+static unsigned int terminate_file_asyncs( struct local_file *file, const IO_STATUS_BLOCK *iosb,
+                                           DWORD tid, NTSTATUS status, struct list *terminated )
+{
+    struct local_async *async, *next;
+    struct list *queues[2] = { &file->reads, &file->writes };
+    unsigned int i, count = 0;
+
+    for (i = 0; i < 2; i++)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE( async, next, queues[i], struct local_async, entry )
+        {
+            if ((iosb && async->iosb != iosb) || (tid && async->tid != tid)) continue;
+            async->status = status;
+            list_remove( &async->entry );
+            list_add_tail( terminated, &async->entry );
+            count++;
+        }
+    }
+    LIST_FOR_EACH_ENTRY( async, &file->running, struct local_async, entry )
+    {
+        if ((iosb && async->iosb != iosb) || (tid && async->tid != tid)) continue;
+        if (async->status == STATUS_PENDING) async->status = status;
+        count++;
+    }
+#ifdef USE_EPOLL
+    if (count) update_file_events( file );
+#endif
+    return count;
+}
+
+/***********************************************************************
+ *           iocp_create_port
+ *
+ * Create the local queue of a new completion port, if enabled.
+ */
+void iocp_create_port( HANDLE handle )
+{
+    struct local_port *port;
+
+    if (local_iocp == -1)
+    {
+        const char *env = getenv( "WINEFASTIOCP" );
+        local_iocp = env && atoi( env );
+    }
+    if (!local_iocp) return;
+
+    if (!(port = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*port) ))) return;
+    if (NtCreateSemaphore( &port->wake, SEMAPHORE_ALL_ACCESS, NULL, 0, MAXLONG ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, port );
+        return;
+    }
+    port->handle   = handle;
+    port->refcount = 1;
+    port->waiters  = 0;
+    port->wakes    = 0;
+    port->depth    = 0;
+    list_init( &port->queue );
+    RtlInitializeCriticalSection( &port->cs );
+    port->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": local_port.cs");
+
+    RtlAcquireSRWLockExclusive( &ports_lock );
+    list_add_tail( &local_ports, &port->entry );
+    RtlReleaseSRWLockExclusive( &ports_lock );
+}
+
+/***********************************************************************
+ *           iocp_close_handle
+ *
+ * Remove the local data of a handle being closed.
+ */
+void iocp_close_handle( HANDLE handle )
+{
+    struct local_port *port;
+    struct local_file *file;
+    struct list terminated;
+
+    if (local_iocp <= 0) return;
+
+    list_init( &terminated );
+    RtlEnterCriticalSection( &files_section );
+    if ((file = find_local_file( handle )))
+    {
+        terminate_file_asyncs( file, NULL, 0, STATUS_HANDLES_CLOSED, &terminated );
+        wine_rb_remove( &local_files, &file->entry );
+#ifdef USE_EPOLL
+        if (file->events) epoll_ctl( epoll_fd, EPOLL_CTL_DEL, file->fd, NULL );
+        file->events = 0;
+#endif
+        file->closed = TRUE;
+    }
+    RtlLeaveCriticalSection( &files_section );
+
+    if (file)
+    {
+        terminate_async_list( file->port, file->ckey, &terminated );
+        release_local_file( file );
+    }
+
+    RtlAcquireSRWLockExclusive( &ports_lock );
+    LIST_FOR_EACH_ENTRY( port, &local_ports, struct local_port, entry )
+    {
+        if (port->handle != handle) continue;
+        list_remove( &port->entry );
+        RtlReleaseSRWLockExclusive( &ports_lock );
+        release_local_port( port );
+        return;
+    }
+    RtlReleaseSRWLockExclusive( &ports_lock );
+}
+
+/***********************************************************************
+ *           iocp_set_completion_info
+ *
+ * Associate a file with a completion port that has a local queue.
+ */
+void iocp_set_completion_info( HANDLE handle, HANDLE port_handle, ULONG_PTR ckey )
+{
+    struct local_port *port;
+    struct local_file *file;
+
+    if (local_iocp <= 0 || !(port = grab_local_port( port_handle ))) return;
+
+    RtlEnterCriticalSection( &files_section );
+    if ((file = find_local_file( handle )))
+    {
+        release_local_port( file->port );
+        file->port = port;
+        file->ckey = ckey;
+    }
+    else if ((file = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*file) )))
+    {
+        file->handle   = handle;
+        file->refcount = 1;
+        file->closed   = FALSE;
+        file->port     = port;
+        file->ckey     = ckey;
+        file->fd       = -1;
+        file->events   = 0;
+        list_init( &file->reads );
+        list_init( &file->writes );
+        list_init( &file->running );
+        wine_rb_put( &local_files, handle, &file->entry );
+    }
+    else release_local_port( port );
+    RtlLeaveCriticalSection( &files_section );
+}
+
+/***********************************************************************
+ *           iocp_cancel_asyncs
+ *
+ * Cancel the asyncs of a file handled in the process.
+ * Returns the number of cancelled asyncs.
+ */
+unsigned int iocp_cancel_asyncs( HANDLE handle, const IO_STATUS_BLOCK *iosb, BOOL only_thread )
+{
+    struct local_port *port = NULL;
+    struct local_file *file;
+    struct list terminated;
+    unsigned int count = 0;
+    ULONG_PTR ckey = 0;
+
+    if (local_iocp <= 0) return 0;
+
+    list_init( &terminated );
+    RtlEnterCriticalSection( &files_section );
+    if ((file = find_local_file( handle )))
+    {
+        count = terminate_file_asyncs( file, iosb, only_thread ? HandleToULong( NtCurrentTeb()->ClientId.UniqueThread ) : 0,
+                                       STATUS_CANCELLED, &terminated );
+        port = file->port;
+        ckey = file->ckey;
+        interlocked_xchg_add( &port->refcount, 1 );
+    }
+    RtlLeaveCriticalSection( &files_section );
+
+    if (port)
+    {
+        terminate_async_list( port, ckey, &terminated );
+        release_local_port( port );
+    }
+    return count;
+}
+
+/***********************************************************************
+ *           iocp_set_completion
+ *
+ * Queue a completion on the local queue of a port.
+ * Returns FALSE if the port doesn't have a local queue.
+ */
+BOOL iocp_set_completion( HANDLE handle, ULONG_PTR ckey, ULONG_PTR cvalue, NTSTATUS status, ULONG_PTR info )
+{
+    struct local_port *port;
+
+    if (local_iocp <= 0 || !(port = grab_local_port( handle ))) return FALSE;
+    post_local_completion( port, ckey, cvalue, status, info );
+    release_local_port( port );
+    return TRUE;
+}
+
+/***********************************************************************
+ *           iocp_remove_completions
+ *
+ * Retrieve completions from a port with a local queue, waiting if needed.
+ * Returns STATUS_NOT_SUPPORTED if the port doesn't have a local queue.
+ */
+NTSTATUS iocp_remove_completions( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
+                                  ULONG *written, const LARGE_INTEGER *timeout, BOOLEAN alertable )
+{
+    struct local_port *port;
+    LARGE_INTEGER deadline;
+    HANDLE handles[2];
+    NTSTATUS status;
+
+    if (local_iocp <= 0 || !(port = grab_local_port( handle ))) return STATUS_NOT_SUPPORTED;
+
+    /* wait against an absolute time, so that waking up doesn't restart the timeout */
+    if (timeout && timeout->QuadPart < 0)
+    {
+        NtQuerySystemTime( &deadline );
+        deadline.QuadPart -= timeout->QuadPart;
+        timeout = &deadline;
+    }
+
+    for (;;)
+    {
+        if ((*written = remove_local_completions( port, info, count, FALSE )))
+        {
+            status = STATUS_SUCCESS;
+            break;
+        }
+
+        status = remove_server_completions( handle, info, count, written );
+        if (status != STATUS_PENDING) break;
+
+        /* check the local queue again, atomically with telling the posters that we are going to wait */
+        if ((*written = remove_local_completions( port, info, count, TRUE )))
+        {
+            status = STATUS_SUCCESS;
+            break;
+        }
+        handles[0] = handle;
+        handles[1] = port->wake;
+        status = NtWaitForMultipleObjects( 2, handles, TRUE, alertable, timeout );
+        RtlEnterCriticalSection( &port->cs );
+        port->waiters--;
+        if (status == STATUS_WAIT_1) port->wakes--;
+        RtlLeaveCriticalSection( &port->cs );
+        if (status != STATUS_WAIT_0 && status != STATUS_WAIT_1) break;
+    }
+
+    release_local_port( port );
+    return status;
+}
+
+/***********************************************************************
+ *           iocp_get_depth
+ *
+ * Return the number of completions in the local queue of a port.
+ */
+ULONG iocp_get_depth( HANDLE handle )
+{
+    struct local_port *port;
+    ULONG depth;
+
+    if (local_iocp <= 0 || !(port = grab_local_port( handle ))) return 0;
+    depth = port->depth;
+    release_local_port( port );
+    return depth;
+}
+
+/***********************************************************************
+ *           __wine_add_local_completion   (NTDLL.@)
+ *
+ * Queue a completion for a file on the local queue of its completion port.
+ * Returns STATUS_NOT_SUPPORTED if it has to be queued by the server.
+ */
+NTSTATUS CDECL __wine_add_local_completion( HANDLE handle, ULONG_PTR cvalue, NTSTATUS status,
+                                            ULONG_PTR info )
+{
+    struct local_port *port = NULL;
+    struct local_file *file;
+    ULONG_PTR ckey = 0;
+
+    if (local_iocp <= 0) return STATUS_NOT_SUPPORTED;
+
+    RtlEnterCriticalSection( &files_section );
+    if ((file = find_local_file( handle )))
+    {
+        port = file->port;
+        ckey = file->ckey;
+        interlocked_xchg_add( &port->refcount, 1 );
+    }
+    RtlLeaveCriticalSection( &files_section );
+
+    if (!port) return STATUS_NOT_SUPPORTED;
+    post_local_completion( port, ckey, cvalue, status, info );
+    release_local_port( port );
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           __wine_queue_local_async   (NTDLL.@)
+ *
+ * Queue an asynchronous read or write on a socket associated with a
+ * completion port that has a local queue. The callback is called as for
+ * APC_ASYNC_IO, from the epoll thread. If a batch function is given, it
+ * is called with the unix fd and the callback data of consecutive queued
+ * asyncs using the same function, before their callbacks are run, so that
+ * it can retrieve their results at once.
+ * Returns STATUS_NOT_SUPPORTED if the async has to be queued in the server.
+ */
+NTSTATUS CDECL __wine_queue_local_async( HANDLE handle, int type, void *user, IO_STATUS_BLOCK *iosb,
+                                         HANDLE event, ULONG_PTR cvalue, local_async_batch_func batch )
+{
+#ifdef USE_EPOLL
+    struct local_async *async;
+    struct local_file *file;
+    int fd;
+
+    if (local_iocp <= 0) return STATUS_NOT_SUPPORTED;
+    if (type != ASYNC_TYPE_READ && type != ASYNC_TYPE_WRITE) return STATUS_NOT_SUPPORTED;
+
+    if (!(async = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*async) ))) return STATUS_NOT_SUPPORTED;
+    async->user   = user;
+    async->batch  = batch;
+    async->iosb   = iosb;
+    async->event  = event;
+    async->cvalue = cvalue;
+    async->tid    = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    async->status = STATUS_PENDING;
+
+    RtlEnterCriticalSection( &files_section );
+
+    if (!(file = find_local_file( handle )) || !start_epoll_thread()) goto failed;
+    if (file->fd == -1)
+    {
+        if (wine_server_handle_to_fd( handle, 0, &fd, NULL )) goto failed;
+        file->fd = dup( fd );
+        wine_server_release_fd( handle, fd );
+        if (file->fd == -1) goto failed;
+    }
+
+    list_add_tail( type == ASYNC_TYPE_READ ? &file->reads : &file->writes, &async->entry );
+    if (!update_file_events( file ))
+    {
+        list_remove( &async->entry );
+        goto failed;
+    }
+    if (event) NtResetEvent( event, NULL );
+
+    RtlLeaveCriticalSection( &files_section );
+    return STATUS_PENDING;
+
+failed:
+    RtlLeaveCriticalSection( &files_section );
+    RtlFreeHeap( GetProcessHeap(), 0, async );
+#endif
+    return STATUS_NOT_SUPPORTED;
+}
@@ -199,6 +199,30 @@ static const unsigned int dir_data_names_initial_size  = 64;
 static struct dir_data **dir_data_cache;
 static unsigned int dir_data_cache_size;
 
+struct dir_cache_name
+{
+    struct dir_cache_name *next;           /* next name in the hash bucket */
+    const char      *unix_name;      /* Unix file name in host encoding */
+    BOOL             is_short;       /* whether this is a hashed short name */
+    unsigned int     len;            /* length of the case-folded name */
+    WCHAR            name[1];        /* case-folded file name */
+};
+
+struct dir_name_cache
+{
+    struct list           entry;     /* entry in the LRU list */
+    struct file_identity  id;        /* directory file identity */
+    ULONGLONG             mtime;     /* directory modification time when it was read */
+    time_t                recheck;   /* time after which to read it again if it was modified while read */
+    unsigned int          mask;      /* size of the hash table minus one */
+    struct dir_cache_name     **hash;      /* hash table of the directory names */
+};
+
+#define MAX_DIR_NAME_CACHE 64  /* max number of directories in the name lookup cache */
+
+static struct list dir_name_cache_list = LIST_INIT( dir_name_cache_list );
+static unsigned int dir_name_cache_count;
+
 static BOOL show_dot_files;
 static RTL_RUN_ONCE init_once = RTL_RUN_ONCE_INIT;
 
@@ -2073,6 +2097,227 @@ NTSTATUS WINAPI NtQueryDirectoryFile( HANDLE handle, HANDLE event,
 }
 
 
+/***********************************************************************
+ *           get_dir_mtime
+ */
+static ULONGLONG get_dir_mtime( const struct stat *st )
+{
+    ULONGLONG ret = (ULONGLONG)st->st_mtime * 1000000000;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    ret += st->st_mtim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    ret += st->st_mtimespec.tv_nsec;
+#endif
+    return ret;
+}
+
+
+/***********************************************************************
+ *           hash_dir_name
+ */
+static inline unsigned int hash_dir_name( const WCHAR *name, unsigned int len )
+{
+    unsigned int hash = 0;
+    while (len--) hash = hash * 65599 + *name++;
+    return hash;
+}
+
+
+/***********************************************************************
+ *           add_dir_name
+ *
+ * Add a name to the list of names of a directory being read.
+ */
+static struct dir_cache_name *add_dir_name( struct dir_cache_name *list, const WCHAR *name,
+                                            unsigned int len, const char *unix_name, BOOL is_short )
+{
+    struct dir_cache_name *entry;
+    unsigned int i, unix_len = strlen( unix_name ) + 1;
+
+    if (!(entry = RtlAllocateHeap( GetProcessHeap(), 0,
+                                   FIELD_OFFSET( struct dir_cache_name, name[len] ) + unix_len )))
+        return NULL;
+    for (i = 0; i < len; i++) entry->name[i] = tolowerW( name[i] );
+    entry->len = len;
+    entry->is_short = is_short;
+    entry->unix_name = memcpy( (char *)&entry->name[len], unix_name, unix_len );
+    entry->next = list;
+    return entry;
+}
+
+
+/***********************************************************************
+ *           free_dir_name_cache
+ */
+static void free_dir_name_cache( struct dir_name_cache *cache )
+{
+    struct dir_cache_name *entry, *next;
+    unsigned int i;
+
+    list_remove( &cache->entry );
+    dir_name_cache_count--;
+    for (i = 0; i <= cache->mask; i++)
+    {
+        for (entry = cache->hash[i]; entry; entry = next)
+        {
+            next = entry->next;
+            RtlFreeHeap( GetProcessHeap(), 0, entry );
+        }
+    }
+    RtlFreeHeap( GetProcessHeap(), 0, cache->hash );
+    RtlFreeHeap( GetProcessHeap(), 0, cache );
+}
+
+
+/***********************************************************************
+ *           read_dir_name_cache
+ *
+ * Read all the names of a directory into a new cache entry.
+ * The dir_section must be held by caller.
+ */
+static struct dir_name_cache *read_dir_name_cache( const char *unix_name, const struct stat *st )
+{
+    WCHAR buffer[MAX_DIR_ENTRY_LEN];
+    UNICODE_STRING str;
+    BOOLEAN spaces;
+    struct dir_name_cache *cache;
+    struct dir_cache_name *names = NULL, *entry;
+    struct dirent *de;
+    unsigned int count = 0, size = 16, pos;
+    time_t now = time( NULL );
+    DIR *dir;
+    int len;
+
+    if (!(dir = opendir( unix_name ))) return NULL;
+    str.Buffer = buffer;
+    str.MaximumLength = sizeof(buffer);
+    while ((de = readdir( dir )))
+    {
+        len = ntdll_umbstowcs( 0, de->d_name, strlen(de->d_name), buffer, MAX_DIR_ENTRY_LEN );
+        if (len <= 0) continue;
+        if (!(entry = add_dir_name( names, buffer, len, de->d_name, FALSE ))) goto failed;
+        names = entry;
+        count++;
+
+        str.Length = len * sizeof(WCHAR);
+        if (!RtlIsNameLegalDOS8Dot3( &str, NULL, &spaces ) || spaces)
+        {
+            WCHAR short_nameW[12];
+            len = hash_short_file_name( &str, short_nameW );
+            if (!(entry = add_dir_name( names, short_nameW, len, de->d_name, TRUE ))) goto failed;
+            names = entry;
+            count++;
+        }
+    }
+    closedir( dir );
+    dir = NULL;
+
+    while (size < count) size *= 2;
+    if (!(cache = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*cache) ))) goto failed;
+    if (!(cache->hash = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                         size * sizeof(*cache->hash) )))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, cache );
+        goto failed;
+    }
+    cache->id.dev = st->st_dev;
+    cache->id.ino = st->st_ino;
+    cache->mtime = get_dir_mtime( st );
+    /* a directory modified within the clock granularity of the scan could change
+     * again without its mtime being updated, so it has to be read again once
+     * that window has passed */
+    cache->recheck = (st->st_mtime >= now - 1) ? st->st_mtime + 1 : 0;
+    cache->mask = size - 1;
+    while ((entry = names))
+    {
+        names = entry->next;
+        pos = hash_dir_name( entry->name, entry->len ) & cache->mask;
+        entry->next = cache->hash[pos];
+        cache->hash[pos] = entry;
+    }
+    list_add_head( &dir_name_cache_list, &cache->entry );
+    if (++dir_name_cache_count > MAX_DIR_NAME_CACHE)
+        free_dir_name_cache( LIST_ENTRY( list_tail( &dir_name_cache_list ),
+                                         struct dir_name_cache, entry ));
+    TRACE( "cached %u names for %s\n", count, debugstr_a(unix_name) );
+    return cache;
+
+failed:
+    if (dir) closedir( dir );
+    while ((entry = names))
+    {
+        names = entry->next;
+        RtlFreeHeap( GetProcessHeap(), 0, entry );
+    }
+    return NULL;
+}
+
+
+/***********************************************************************
+ *           find_cached_dir_name
+ *
+ * Find a file in a directory using the directory name cache, which is
+ * refreshed when the directory has been modified. Names missing from an
+ * entry read right after a modification are looked up the hard way, since
+ * they may have been added without changing the modification time.
+ * unix_name must contain the directory name; the file found is appended at pos.
+ * Returns 1 if found, 0 if not found, -1 if the cache can't be used.
+ */
+static int find_cached_dir_name( char *unix_name, int pos, const WCHAR *name, int length,
+                                 BOOLEAN is_name_8_dot_3 )
+{
+    WCHAR folded[MAX_DIR_ENTRY_LEN];
+    struct dir_name_cache *cache;
+    struct dir_cache_name *entry;
+    const char *found = NULL;
+    struct stat st;
+    int i, ret = 0;
+
+    if (length > MAX_DIR_ENTRY_LEN) return 0;
+    if (stat( unix_name, &st ) == -1) return -1;
+
+    RtlEnterCriticalSection( &dir_section );
+
+    LIST_FOR_EACH_ENTRY( cache, &dir_name_cache_list, struct dir_name_cache, entry )
+    {
+        if (cache->id.dev != st.st_dev || cache->id.ino != st.st_ino) continue;
+        if (cache->mtime == get_dir_mtime( &st ) && (!cache->recheck || time( NULL ) <= cache->recheck))
+        {
+            list_remove( &cache->entry );
+            list_add_head( &dir_name_cache_list, &cache->entry );
+            goto done;
+        }
+        free_dir_name_cache( cache );
+        break;
+    }
+    if (!(cache = read_dir_name_cache( unix_name, &st )))
+    {
+        RtlLeaveCriticalSection( &dir_section );
+        return -1;
+    }
+
+done:
+    for (i = 0; i < length; i++) folded[i] = tolowerW( name[i] );
+    entry = cache->hash[hash_dir_name( folded, length ) & cache->mask];
+    for ( ; entry; entry = entry->next)
+    {
+        if (entry->len != length || memcmp( entry->name, folded, length * sizeof(WCHAR) )) continue;
+        if (entry->is_short && !is_name_8_dot_3) continue;
+        found = entry->unix_name;
+        if (!entry->is_short) break;
+    }
+    if (found)
+    {
+        unix_name[pos - 1] = '/';
+        strcpy( unix_name + pos, found );
+        ret = 1;
+    }
+    else if (cache->recheck) ret = -1;
+    RtlLeaveCriticalSection( &dir_section );
+    return ret;
+}
+
+
 /***********************************************************************
  *           find_file_in_dir
  *
@@ -2183,6 +2428,12 @@ static NTSTATUS find_file_in_dir( char *unix_name, int pos, const WCHAR *name, i
     }
 #endif /* VFAT_IOCTL_READDIR_BOTH */
 
+    switch (find_cached_dir_name( unix_name, pos, name, length, is_name_8_dot_3 ))
+    {
+    case 1: goto success;
+    case 0: goto not_found;
+    }
+
     if (!(dir = opendir( unix_name )))
     {
         if (errno == ENOENT) return STATUS_OBJECT_PATH_NOT_FOUND;
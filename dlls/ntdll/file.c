@@ -2780,6 +2780,8 @@ NTSTATUS WINAPI NtSetInformationFile(HANDLE handle, PIO_STATUS_BLOCK io,
                 io->u.Status  = wine_server_call( req );
             }
             SERVER_END_REQ;
+            if (!io->u.Status)
+                iocp_set_completion_info( handle, info->CompletionPort, info->CompletionKey );
         } else
             io->u.Status = STATUS_INVALID_PARAMETER_3;
         break;
@@ -3407,6 +3409,38 @@ NTSTATUS WINAPI NtFlushBuffersFile( HANDLE hFile, IO_STATUS_BLOCK* IoStatusBlock
     {
         ret = COMM_FlushBuffersFile( fd );
     }
+    else if (!ret && type == FD_TYPE_FILE)
+    {
+        struct async_irp *async;
+
+        /* the server may complete the flush of a regular file from a worker thread,
+         * the fsync status is then returned through the irp completion */
+        if (!(async = (struct async_irp *)alloc_fileio( sizeof(*async), irp_completion, hFile )))
+        {
+            if (needs_close) close( fd );
+            return STATUS_NO_MEMORY;
+        }
+        async->event  = NULL;
+        async->buffer = NULL;
+        async->size   = 0;
+
+        SERVER_START_REQ( flush )
+        {
+            req->async = server_async( hFile, &async->io, NULL, NULL, NULL, IoStatusBlock );
+            ret = wine_server_call( req );
+            hEvent = wine_server_ptr_handle( reply->event );
+        }
+        SERVER_END_REQ;
+
+        if (ret != STATUS_PENDING) RtlFreeHeap( GetProcessHeap(), 0, async );
+
+        if (hEvent)
+        {
+            NtWaitForSingleObject( hEvent, FALSE, NULL );
+            NtClose( hEvent );
+            ret = IoStatusBlock->u.Status;
+        }
+    }
     else if (ret != STATUS_ACCESS_DENIED)
     {
         SERVER_START_REQ( flush )
@@ -3623,6 +3657,9 @@ NTSTATUS WINAPI NtCancelIoFileEx( HANDLE hFile, PIO_STATUS_BLOCK iosb, PIO_STATU
     }
     SERVER_END_REQ;
 
+    if (iocp_cancel_asyncs( hFile, iosb, FALSE ) && io_status->u.Status == STATUS_NOT_FOUND)
+        io_status->u.Status = STATUS_SUCCESS;
+
     return io_status->u.Status;
 }
 
@@ -3644,6 +3681,8 @@ NTSTATUS WINAPI NtCancelIoFile( HANDLE hFile, PIO_STATUS_BLOCK io_status )
     }
     SERVER_END_REQ;
 
+    iocp_cancel_asyncs( hFile, NULL, TRUE );
+
     return io_status->u.Status;
 }
 
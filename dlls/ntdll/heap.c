@@ -85,6 +85,8 @@ typedef struct
 #define ARENA_PENDING_MAGIC    0xbedead
 #define ARENA_FREE_MAGIC       0x45455246
 #define ARENA_LARGE_MAGIC      0x6752614c
+#define ARENA_LFH_MAGIC        0x48464c
+#define ARENA_LFH_FREE_MAGIC   0x46464c
 
 #define ARENA_INUSE_FILLER     0x55
 #define ARENA_TAIL_FILLER      0xab
@@ -158,6 +160,7 @@ typedef struct tagHEAP
     ARENA_INUSE    **pending_free;  /* Ring buffer for pending free requests */
     RTL_CRITICAL_SECTION critSection; /* Critical section for serialization */
     FREE_LIST_ENTRY *freeList;      /* Free lists */
+    struct lfh_heap *lfh;           /* Low fragmentation heap front-end */
 } HEAP;
 
 #define HEAP_MAGIC       ((DWORD)('H' | ('E'<<8) | ('A'<<16) | ('P'<<24)))
@@ -172,7 +175,56 @@ typedef struct tagHEAP
 #define HEAP_VALIDATE_ALL     0x20000000
 #define HEAP_VALIDATE_PARAMS  0x40000000
 
+/* Low fragmentation heap front-end: small blocks are allocated from groups of
+ * blocks of the same size, carved from separate regions reserved for the heap
+ * as needed, each one twice as large as the previous one. Each group belongs to one of several affinity slots, selected from the
+ * thread id, that have their own lock instead of using the heap one. */
+
+#define LFH_BLOCK_GRANULARITY  16
+#define LFH_MAX_BLOCK_SIZE     1024      /* largest allocation handled by the front-end */
+#define LFH_NB_BINS            (LFH_MAX_BLOCK_SIZE / LFH_BLOCK_GRANULARITY)
+#define LFH_NB_SLOTS           8         /* number of affinity slots */
+#define LFH_GROUP_SIZE         0x4000    /* size of a group of blocks, must be a power of 2 */
+#define LFH_REGION_SIZE        0x100000  /* size of the first region reserved for the groups */
+#define LFH_MAX_REGIONS        (sizeof(void *) * 2)
+#define LFH_GROUP_HEADER_SIZE  ROUND_SIZE( sizeof(struct lfh_group) )
+
+/* heap flags that prevent using the front-end */
+#define HEAP_LFH_DISABLED_FLAGS (HEAP_NO_SERIALIZE | HEAP_SHARED | HEAP_TAIL_CHECKING_ENABLED | \
+                                 HEAP_FREE_CHECKING_ENABLED | HEAP_VALIDATE | HEAP_VALIDATE_ALL | \
+                                 HEAP_VALIDATE_PARAMS)
+
+struct lfh_group
+{
+    DWORD            block_size;    /* size of the blocks, including the arena */
+    WORD             bin;           /* bin index of the blocks */
+    WORD             slot;          /* affinity slot owning the group */
+};
+
+struct lfh_slot
+{
+    RTL_SRWLOCK      lock;                /* lock protecting the free lists */
+    ARENA_INUSE     *free[LFH_NB_BINS];   /* free blocks of each size */
+};
+
+struct lfh_region
+{
+    char            *base;          /* start of the reserved address range */
+    SIZE_T           used;          /* size of the range used so far */
+};
+
+struct lfh_heap
+{
+    RTL_SRWLOCK       lock;         /* lock protecting the allocation of new groups */
+    LONG              nb_regions;   /* number of reserved regions, the first one starts with this header */
+    struct lfh_region regions[LFH_MAX_REGIONS];
+    struct lfh_slot   slots[LFH_NB_SLOTS];
+};
+
+C_ASSERT( sizeof(struct lfh_heap) <= LFH_GROUP_SIZE );
+
 static HEAP *processHeap;  /* main process heap */
+static int lfh_default;    /* whether new heaps use the LFH front-end by default */
 
 static BOOL HEAP_IsRealArena( HEAP *heapPtr, DWORD flags, LPCVOID block, BOOL quiet );
 
@@ -860,6 +912,291 @@ static BOOL validate_large_arena( HEAP *heap, const ARENA_LARGE *arena, BOOL qui
 }
 
 
+/***********************************************************************
+ *           get_lfh_bin
+ *
+ * Return the bin index of the LFH blocks for a given size.
+ */
+static inline unsigned int get_lfh_bin( SIZE_T size )
+{
+    return size ? (size - 1) / LFH_BLOCK_GRANULARITY : 0;
+}
+
+
+/***********************************************************************
+ *           get_lfh_group
+ *
+ * Return the group containing an LFH block.
+ */
+static inline struct lfh_group *get_lfh_group( const void *ptr )
+{
+    return (struct lfh_group *)((UINT_PTR)ptr & ~(UINT_PTR)(LFH_GROUP_SIZE - 1));
+}
+
+
+/***********************************************************************
+ *           get_lfh_block_size
+ *
+ * Return the size available for user data in an LFH block.
+ */
+static inline SIZE_T get_lfh_block_size( const ARENA_INUSE *arena )
+{
+    return get_lfh_group( arena + 1 )->block_size - sizeof(ARENA_INUSE);
+}
+
+
+/***********************************************************************
+ *           get_lfh_region_size
+ *
+ * Return the size of an LFH region.
+ */
+static inline SIZE_T get_lfh_region_size( unsigned int index )
+{
+    return (SIZE_T)LFH_REGION_SIZE << index;
+}
+
+
+/***********************************************************************
+ *           find_lfh_block
+ *
+ * Find the LFH block arena for a given pointer, or NULL if the pointer
+ * is not the start of a block of the front-end.
+ */
+static ARENA_INUSE *find_lfh_block( const HEAP *heap, const void *ptr )
+{
+    const struct lfh_heap *lfh = heap->lfh;
+    const char *arena = (const char *)ptr - sizeof(ARENA_INUSE);
+    const struct lfh_group *group;
+    LONG i, count = lfh->nb_regions;
+    SIZE_T offset;
+
+    for (i = 0; i < count; i++)
+    {
+        const struct lfh_region *region = &lfh->regions[i];
+        if ((const char *)ptr >= region->base && (const char *)ptr < region->base + region->used) break;
+    }
+    if (i == count) return NULL;
+    group = get_lfh_group( ptr );
+    if ((const void *)group == lfh) return NULL;
+    if (arena < (const char *)group + LFH_GROUP_HEADER_SIZE) return NULL;
+    offset = arena - ((const char *)group + LFH_GROUP_HEADER_SIZE);
+    if (offset % group->block_size) return NULL;
+    return (ARENA_INUSE *)arena;
+}
+
+
+/***********************************************************************
+ *           add_lfh_region
+ *
+ * Reserve a new region for the LFH groups. The LFH lock must be held by caller.
+ */
+static struct lfh_region *add_lfh_region( HEAP *heap )
+{
+    struct lfh_heap *lfh = heap->lfh;
+    struct lfh_region *region;
+    SIZE_T size;
+    void *addr = NULL;
+
+    if (lfh->nb_regions == LFH_MAX_REGIONS) return NULL;
+    size = get_lfh_region_size( lfh->nb_regions );
+    if (NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, &size, MEM_RESERVE,
+                                 get_protection_type( heap->flags ) ))
+        return NULL;
+    region = &lfh->regions[lfh->nb_regions];
+    region->base = addr;
+    region->used = 0;
+    /* the region must be visible to find_lfh_block, which doesn't take the lock */
+    interlocked_xchg_add( &lfh->nb_regions, 1 );
+    return region;
+}
+
+
+/***********************************************************************
+ *           alloc_lfh_group
+ *
+ * Allocate a new group of blocks for an LFH bin, and return the list of
+ * its blocks. The slot lock must be held by caller.
+ */
+static ARENA_INUSE *alloc_lfh_group( HEAP *heap, unsigned int slot, unsigned int bin )
+{
+    struct lfh_heap *lfh = heap->lfh;
+    struct lfh_region *region;
+    struct lfh_group *group = NULL;
+    ARENA_INUSE *arena, *next = NULL;
+    SIZE_T size = LFH_GROUP_SIZE;
+    DWORD block_size;
+    char *ptr;
+
+    RtlAcquireSRWLockExclusive( &lfh->lock );
+    region = &lfh->regions[lfh->nb_regions - 1];
+    if (region->used > get_lfh_region_size( lfh->nb_regions - 1 ) - LFH_GROUP_SIZE)
+        region = add_lfh_region( heap );
+    if (region)
+    {
+        void *addr = region->base + region->used;
+        if (!NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, &size, MEM_COMMIT,
+                                      get_protection_type( heap->flags ) ))
+        {
+            group = addr;
+            group->block_size = (bin + 1) * LFH_BLOCK_GRANULARITY + ALIGNMENT;
+            group->bin  = bin;
+            group->slot = slot;
+            region->used += LFH_GROUP_SIZE;
+        }
+    }
+    RtlReleaseSRWLockExclusive( &lfh->lock );
+    if (!group) return NULL;
+
+    /* link all the blocks in reverse order, so that the first one ends up at the head */
+    block_size = group->block_size;
+    ptr = (char *)group + LFH_GROUP_HEADER_SIZE;
+    ptr += (LFH_GROUP_SIZE - LFH_GROUP_HEADER_SIZE) / block_size * block_size;
+    while ((ptr -= block_size) >= (char *)group + LFH_GROUP_HEADER_SIZE)
+    {
+        arena = (ARENA_INUSE *)ptr;
+        arena->size  = block_size - sizeof(ARENA_INUSE);
+        arena->magic = ARENA_LFH_FREE_MAGIC;
+        arena->unused_bytes = 0;
+        *(ARENA_INUSE **)(arena + 1) = next;
+        next = arena;
+    }
+    return next;
+}
+
+
+/***********************************************************************
+ *           lfh_alloc
+ *
+ * Allocate a block from the low fragmentation heap front-end.
+ */
+static void *lfh_alloc( HEAP *heap, DWORD flags, SIZE_T size )
+{
+    unsigned int bin = get_lfh_bin( size );
+    unsigned int slot = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread ) / 4 % LFH_NB_SLOTS;
+    struct lfh_slot *lfh_slot = &heap->lfh->slots[slot];
+    ARENA_INUSE *arena;
+
+    RtlAcquireSRWLockExclusive( &lfh_slot->lock );
+    if ((arena = lfh_slot->free[bin]) || (arena = alloc_lfh_group( heap, slot, bin )))
+        lfh_slot->free[bin] = *(ARENA_INUSE **)(arena + 1);
+    RtlReleaseSRWLockExclusive( &lfh_slot->lock );
+    if (!arena) return NULL;
+
+    arena->magic = ARENA_LFH_MAGIC;
+    arena->unused_bytes = get_lfh_block_size( arena ) - size;
+    notify_alloc( arena + 1, size, flags & HEAP_ZERO_MEMORY );
+    initialize_block( arena + 1, size, arena->unused_bytes, flags );
+    return arena + 1;
+}
+
+
+/***********************************************************************
+ *           lfh_free
+ *
+ * Free a block of the low fragmentation heap front-end, after validating it.
+ */
+static BOOL lfh_free( HEAP *heap, ARENA_INUSE *arena )
+{
+    struct lfh_group *group = get_lfh_group( arena + 1 );
+    struct lfh_slot *lfh_slot = &heap->lfh->slots[group->slot];
+    BOOL ret = FALSE;
+
+    RtlAcquireSRWLockExclusive( &lfh_slot->lock );
+    if (arena->magic == ARENA_LFH_MAGIC)
+    {
+        notify_free( arena + 1 );
+        arena->magic = ARENA_LFH_FREE_MAGIC;
+        *(ARENA_INUSE **)(arena + 1) = lfh_slot->free[group->bin];
+        lfh_slot->free[group->bin] = arena;
+        ret = TRUE;
+    }
+    RtlReleaseSRWLockExclusive( &lfh_slot->lock );
+
+    if (!ret) WARN( "Heap %p: invalid LFH arena magic %08x for %p\n", heap, arena->magic, arena );
+    return ret;
+}
+
+
+/***********************************************************************
+ *           lfh_realloc
+ *
+ * Reallocate a block of the low fragmentation heap front-end.
+ */
+static void *lfh_realloc( HEAP *heap, DWORD flags, ARENA_INUSE *arena, SIZE_T size )
+{
+    SIZE_T block_size = get_lfh_block_size( arena );
+    SIZE_T old_size = block_size - arena->unused_bytes;
+    void *ret;
+
+    /* the block can be reused as long as the unused bytes fit in the arena */
+    if (size <= block_size && block_size - size <= 0xff)
+    {
+        notify_realloc( arena + 1, old_size, size );
+        arena->unused_bytes = block_size - size;
+        if (size > old_size)
+            initialize_block( (char *)(arena + 1) + old_size, size - old_size, arena->unused_bytes, flags );
+        else
+            mark_block_tail( (char *)(arena + 1) + size, arena->unused_bytes, flags );
+        return arena + 1;
+    }
+    if (flags & HEAP_REALLOC_IN_PLACE_ONLY) return NULL;
+
+    if (!(ret = RtlAllocateHeap( heap, flags & ~HEAP_GENERATE_EXCEPTIONS, size ))) return NULL;
+    memcpy( ret, arena + 1, min( size, old_size ) );
+    lfh_free( heap, arena );
+    return ret;
+}
+
+
+/***********************************************************************
+ *           enable_lfh
+ *
+ * Enable the low fragmentation heap front-end.
+ */
+static NTSTATUS enable_lfh( HEAP *heap )
+{
+    SIZE_T size = LFH_REGION_SIZE;
+    struct lfh_heap *lfh;
+    void *addr = NULL;
+    NTSTATUS status;
+
+    if (heap->flags & HEAP_LFH_DISABLED_FLAGS) return STATUS_UNSUCCESSFUL;
+    if (heap->lfh) return STATUS_SUCCESS;
+
+    if ((status = NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, &size, MEM_RESERVE,
+                                           get_protection_type( heap->flags ) )))
+        return status;
+    size = LFH_GROUP_SIZE;
+    if ((status = NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, &size, MEM_COMMIT,
+                                           PAGE_READWRITE )))
+    {
+        size = 0;
+        NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+        return status;
+    }
+    lfh = addr;
+    lfh->nb_regions = 1;
+    lfh->regions[0].base = addr;
+    lfh->regions[0].used = LFH_GROUP_SIZE;
+
+    RtlEnterCriticalSection( &heap->critSection );
+    if (!heap->lfh)
+    {
+        heap->lfh = addr;
+        addr = NULL;
+    }
+    RtlLeaveCriticalSection( &heap->critSection );
+
+    if (addr)  /* enabled by another thread in the meantime */
+    {
+        size = 0;
+        NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+    }
+    TRACE( "enabled LFH for heap %p\n", heap );
+    return STATUS_SUCCESS;
+}
+
+
 /***********************************************************************
  *           HEAP_CreateSubHeap
  */
@@ -1335,7 +1672,17 @@ static BOOL HEAP_IsRealArena( HEAP *heapPtr,   /* [in] ptr to the heap */
     {
         const ARENA_INUSE *arena = (const ARENA_INUSE *)block - 1;
 
-        if (!(subheap = HEAP_FindSubHeap( heapPtr, arena )) ||
+        if (heapPtr->lfh && find_lfh_block( heapPtr, block ))
+        {
+            if (!(ret = (arena->magic == ARENA_LFH_MAGIC)))
+            {
+                if (quiet == NOISY)
+                    ERR("Heap %p: invalid LFH arena magic %08x for %p\n", heapPtr, arena->magic, arena );
+                else if (WARN_ON(heap))
+                    WARN("Heap %p: invalid LFH arena magic %08x for %p\n", heapPtr, arena->magic, arena );
+            }
+        }
+        else if (!(subheap = HEAP_FindSubHeap( heapPtr, arena )) ||
             ((const char *)arena < (char *)subheap->base + subheap->headerSize))
         {
             if (!(large_arena = find_large_block( heapPtr, block )))
@@ -1554,6 +1901,9 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, PVOID addr, SIZE_T totalSize, SIZE_T c
 
     heap_set_debug_flags( subheap->heap );
 
+    if (!lfh_default) lfh_default = (getenv( "WINEHEAPLFH" ) && atoi( getenv( "WINEHEAPLFH" ) )) ? 1 : -1;
+    if (lfh_default > 0 && (flags & HEAP_GROWABLE)) enable_lfh( subheap->heap );
+
     /* link it into the per-process heap list */
     if (processHeap)
     {
@@ -1591,6 +1941,7 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE heap )
     ARENA_LARGE *arena, *arena_next;
     SIZE_T size;
     void *addr;
+    LONG i;
 
     TRACE("%p\n", heap );
     if (!heapPtr) return heap;
@@ -1628,6 +1979,16 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE heap )
         addr = heapPtr->pending_free;
         NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
     }
+    if (heapPtr->lfh)
+    {
+        /* the first region holds the list, release it last */
+        for (i = heapPtr->lfh->nb_regions - 1; i >= 0; i--)
+        {
+            size = 0;
+            addr = heapPtr->lfh->regions[i].base;
+            NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+        }
+    }
     size = 0;
     addr = heapPtr->subheap.base;
     NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
@@ -1673,6 +2034,16 @@ PVOID WINAPI RtlAllocateHeap( HANDLE heap, ULONG flags, SIZE_T size )
     }
     if (rounded_size < HEAP_MIN_DATA_SIZE) rounded_size = HEAP_MIN_DATA_SIZE;
 
+    if (heapPtr->lfh && size <= LFH_MAX_BLOCK_SIZE && !(flags & HEAP_LFH_DISABLED_FLAGS))
+    {
+        void *ret = lfh_alloc( heapPtr, flags, size );
+        if (ret)
+        {
+            TRACE("(%p,%08x,%08lx): returning %p\n", heap, flags, size, ret );
+            return ret;
+        }
+    }
+
     if (!(flags & HEAP_NO_SERIALIZE)) RtlEnterCriticalSection( &heapPtr->critSection );
 
     if (rounded_size >= HEAP_MIN_LARGE_BLOCK_SIZE && (flags & HEAP_GROWABLE))
@@ -1756,6 +2127,19 @@ BOOLEAN WINAPI RtlFreeHeap( HANDLE heap, ULONG flags, PVOID ptr )
 
     flags &= HEAP_NO_SERIALIZE;
     flags |= heapPtr->flags;
+
+    if (heapPtr->lfh && (pInUse = find_lfh_block( heapPtr, ptr )))
+    {
+        if (!lfh_free( heapPtr, pInUse ))
+        {
+            RtlSetLastWin32ErrorAndNtStatusFromNtStatus( STATUS_INVALID_PARAMETER );
+            TRACE("(%p,%08x,%p): returning FALSE\n", heap, flags, ptr );
+            return FALSE;
+        }
+        TRACE("(%p,%08x,%p): returning TRUE\n", heap, flags, ptr );
+        return TRUE;
+    }
+
     if (!(flags & HEAP_NO_SERIALIZE)) RtlEnterCriticalSection( &heapPtr->critSection );
 
     /* Inform valgrind we are trying to free memory, so it can throw up an error message */
@@ -1817,6 +2201,25 @@ PVOID WINAPI RtlReAllocateHeap( HANDLE heap, ULONG flags, PVOID ptr, SIZE_T size
     flags &= HEAP_GENERATE_EXCEPTIONS | HEAP_NO_SERIALIZE | HEAP_ZERO_MEMORY |
              HEAP_REALLOC_IN_PLACE_ONLY;
     flags |= heapPtr->flags;
+
+    if (heapPtr->lfh && (pArena = find_lfh_block( heapPtr, ptr )))
+    {
+        if (pArena->magic != ARENA_LFH_MAGIC)
+        {
+            WARN( "Heap %p: invalid LFH arena magic %08x for %p\n", heapPtr, pArena->magic, pArena );
+            RtlSetLastWin32ErrorAndNtStatusFromNtStatus( STATUS_INVALID_PARAMETER );
+            TRACE("(%p,%08x,%p,%08lx): returning NULL\n", heap, flags, ptr, size );
+            return NULL;
+        }
+        if (!(ret = lfh_realloc( heapPtr, flags, pArena, size )))
+        {
+            if (flags & HEAP_GENERATE_EXCEPTIONS) RtlRaiseStatus( STATUS_NO_MEMORY );
+            RtlSetLastWin32ErrorAndNtStatusFromNtStatus( STATUS_NO_MEMORY );
+        }
+        TRACE("(%p,%08x,%p,%08lx): returning %p\n", heap, flags, ptr, size, ret );
+        return ret;
+    }
+
     if (!(flags & HEAP_NO_SERIALIZE)) RtlEnterCriticalSection( &heapPtr->critSection );
 
     rounded_size = ROUND_SIZE(size) + HEAP_TAIL_EXTRA_SIZE(flags);
@@ -2026,6 +2429,20 @@ SIZE_T WINAPI RtlSizeHeap( HANDLE heap, ULONG flags, const void *ptr )
     }
     flags &= HEAP_NO_SERIALIZE;
     flags |= heapPtr->flags;
+
+    if (heapPtr->lfh && (pArena = find_lfh_block( heapPtr, ptr )))
+    {
+        if (pArena->magic == ARENA_LFH_MAGIC)
+            ret = get_lfh_block_size( pArena ) - pArena->unused_bytes;
+        else
+        {
+            RtlSetLastWin32ErrorAndNtStatusFromNtStatus( STATUS_INVALID_PARAMETER );
+            ret = ~0UL;
+        }
+        TRACE("(%p,%08x,%p): returning %08lx\n", heap, flags, ptr, ret );
+        return ret;
+    }
+
     if (!(flags & HEAP_NO_SERIALIZE)) RtlEnterCriticalSection( &heapPtr->critSection );
 
     pArena = (const ARENA_INUSE *)ptr - 1;
@@ -2092,7 +2509,7 @@ NTSTATUS WINAPI RtlWalkHeap( HANDLE heap, PVOID entry_ptr )
 
     if (!(heapPtr->flags & HEAP_NO_SERIALIZE)) RtlEnterCriticalSection( &heapPtr->critSection );
 
-    /* FIXME: enumerate large blocks too */
+    /* FIXME: enumerate large and LFH blocks too */
 
     /* set ptr to the next arena to be examined */
 
@@ -2236,6 +2653,8 @@ ULONG WINAPI RtlGetProcessHeaps( ULONG count, HANDLE *heaps )
 NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE heap, HEAP_INFORMATION_CLASS info_class,
                                          PVOID info, SIZE_T size_in, PSIZE_T size_out)
 {
+    HEAP *heapPtr;
+
     switch (info_class)
     {
     case HeapCompatibilityInformation:
@@ -2244,7 +2663,8 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE heap, HEAP_INFORMATION_CLASS inf
         if (size_in < sizeof(ULONG))
             return STATUS_BUFFER_TOO_SMALL;
 
-        *(ULONG *)info = 0; /* standard heap */
+        heapPtr = HEAP_GetPtr( heap );
+        *(ULONG *)info = (heapPtr && heapPtr->lfh) ? 2 : 0; /* low fragmentation or standard heap */
         return STATUS_SUCCESS;
 
     default:
@@ -2258,6 +2678,14 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE heap, HEAP_INFORMATION_CLASS inf
  */
 NTSTATUS WINAPI RtlSetHeapInformation( HANDLE heap, HEAP_INFORMATION_CLASS info_class, PVOID info, SIZE_T size)
 {
+    HEAP *heapPtr;
+
+    if (info_class == HeapCompatibilityInformation && size >= sizeof(ULONG) && *(ULONG *)info == 2)
+    {
+        if (!(heapPtr = HEAP_GetPtr( heap ))) return STATUS_INVALID_HANDLE;
+        return enable_lfh( heapPtr );
+    }
+
     FIXME("%p %d %p %ld stub\n", heap, info_class, info, size);
     return STATUS_SUCCESS;
 }
@@ -84,6 +84,13 @@ typedef struct _wine_modref
     LDR_MODULE            ldr;
     int                   nDeps;
     struct _wine_modref **deps;
+    DWORD                *export_hash;    /* hash table of export name indexes plus one */
+    DWORD                 export_mask;    /* size of the hash table minus one */
+    FARPROC              *forwards;       /* resolved forwarded exports, indexed by ordinal */
+    unsigned int          export_hits;    /* statistics for the export caches */
+    unsigned int          export_misses;
+    unsigned int          forward_hits;
+    unsigned int          forward_misses;
 } WINE_MODREF;
 
 /* info about the current builtin dll load */
@@ -511,7 +518,26 @@ static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY
     /* if the address falls into the export dir, it's a forward */
     if (((const char *)proc >= (const char *)exports) && 
         ((const char *)proc < (const char *)exports + exp_size))
-        return find_forwarded_export( module, (const char *)proc, load_path );
+    {
+        WINE_MODREF *wm = get_modref( module );
+
+        /* the relay and snoop thunks depend on the importing module, so don't cache them */
+        if (!wm || TRACE_ON(relay) || TRACE_ON(snoop))
+            return find_forwarded_export( module, (const char *)proc, load_path );
+
+        if (wm->forwards && wm->forwards[ordinal])
+        {
+            wm->forward_hits++;
+            return wm->forwards[ordinal];
+        }
+        wm->forward_misses++;
+        if (!(proc = find_forwarded_export( module, (const char *)proc, load_path ))) return NULL;
+        if (!wm->forwards)
+            wm->forwards = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                            exports->NumberOfFunctions * sizeof(*wm->forwards) );
+        if (wm->forwards) wm->forwards[ordinal] = proc;
+        return proc;
+    }
 
     if (TRACE_ON(snoop))
     {
@@ -527,6 +553,79 @@ static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY
 }
 
 
+/*************************************************************************
+ *		hash_export_name
+ */
+static inline DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 0;
+    while (*name) hash = hash * 65599 + (unsigned char)*name++;
+    return hash;
+}
+
+
+/*************************************************************************
+ *		build_export_hash
+ *
+ * Build the hash table used to look up the exports of a module by name.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL build_export_hash( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports )
+{
+    const DWORD *names = get_rva( wm->ldr.BaseAddress, exports->AddressOfNames );
+    DWORD i, pos, size = 16;
+
+    while (size < 2 * exports->NumberOfNames) size *= 2;
+    if (!(wm->export_hash = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                             size * sizeof(*wm->export_hash) )))
+        return FALSE;
+    wm->export_mask = size - 1;
+
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        pos = hash_export_name( get_rva( wm->ldr.BaseAddress, names[i] )) & wm->export_mask;
+        while (wm->export_hash[pos]) pos = (pos + 1) & wm->export_mask;
+        wm->export_hash[pos] = i + 1;
+    }
+    TRACE( "built export hash for %s, %u names\n",
+           debugstr_w(wm->ldr.BaseDllName.Buffer), exports->NumberOfNames );
+    return TRUE;
+}
+
+
+/*************************************************************************
+ *		dump_export_stats
+ *
+ * Trace the hit and miss counts of the export caches of a module.
+ */
+static void dump_export_stats( const WINE_MODREF *wm )
+{
+    if (!wm->export_hits && !wm->export_misses && !wm->forward_hits && !wm->forward_misses) return;
+    TRACE( "%s: exports %u hits %u misses, forwards %u hits %u misses\n",
+           debugstr_w(wm->ldr.BaseDllName.Buffer), wm->export_hits, wm->export_misses,
+           wm->forward_hits, wm->forward_misses );
+}
+
+
+/*************************************************************************
+ *		flush_forward_caches
+ *
+ * Forget the resolved forwarded exports, since they may point into a module being unloaded.
+ * The loader_section must be locked while calling this function.
+ */
+static void flush_forward_caches(void)
+{
+    PLIST_ENTRY mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList, entry;
+
+    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    {
+        WINE_MODREF *wm = CONTAINING_RECORD( entry, WINE_MODREF, ldr.InLoadOrderModuleList );
+        RtlFreeHeap( GetProcessHeap(), 0, wm->forwards );
+        wm->forwards = NULL;
+    }
+}
+
+
 /*************************************************************************
  *		find_named_export
  *
@@ -539,6 +638,7 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
     const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
     const DWORD *names = get_rva( module, exports->AddressOfNames );
     int min = 0, max = exports->NumberOfNames - 1;
+    WINE_MODREF *wm;
 
     /* first check the hint */
     if (hint >= 0 && hint <= max)
@@ -548,7 +648,26 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
             return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path );
     }
 
-    /* then do a binary search */
+    /* then use the hash table, building it on the first lookup that needs it */
+    if ((wm = get_modref( module )) && (wm->export_hash || build_export_hash( wm, exports )))
+    {
+        DWORD index, pos = hash_export_name( name ) & wm->export_mask;
+
+        while ((index = wm->export_hash[pos]))
+        {
+            char *ename = get_rva( module, names[index - 1] );
+            if (!strcmp( ename, name ))
+            {
+                wm->export_hits++;
+                return find_ordinal_export( module, exports, exp_size, ordinals[index - 1], load_path );
+            }
+            pos = (pos + 1) & wm->export_mask;
+        }
+        wm->export_misses++;
+        return NULL;
+    }
+
+    /* else do a binary search */
     while (min <= max)
     {
         int res, pos = (min + max) / 2;
@@ -946,6 +1065,13 @@ static WINE_MODREF *alloc_module( HMODULE hModule, LPCWSTR filename )
 
     wm->nDeps    = 0;
     wm->deps     = NULL;
+    wm->export_hash    = NULL;
+    wm->export_mask    = 0;
+    wm->forwards       = NULL;
+    wm->export_hits    = 0;
+    wm->export_misses  = 0;
+    wm->forward_hits   = 0;
+    wm->forward_misses = 0;
 
     wm->ldr.BaseAddress   = hModule;
     wm->ldr.EntryPoint    = NULL;
@@ -2736,6 +2862,14 @@ void WINAPI LdrShutdownProcess(void)
     TRACE("()\n");
     process_detaching = TRUE;
     process_detach();
+
+    if (TRACE_ON(module))
+    {
+        PLIST_ENTRY mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList, entry;
+
+        for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+            dump_export_stats( CONTAINING_RECORD( entry, WINE_MODREF, ldr.InLoadOrderModuleList ));
+    }
 }
 
 
@@ -2828,7 +2962,11 @@ static void free_modref( WINE_MODREF *wm )
     if (wm->ldr.Flags & LDR_WINE_INTERNAL) wine_dll_unload( wm->ldr.SectionHandle );
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.BaseAddress );
     if (cached_modref == wm) cached_modref = NULL;
+    dump_export_stats( wm );
+    flush_forward_caches();
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_hash );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->forwards );
     RtlFreeHeap( GetProcessHeap(), 0, wm->deps );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
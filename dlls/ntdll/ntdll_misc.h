@@ -94,6 +94,7 @@ extern unsigned int server_select( const select_op_t *select_op, data_size_t siz
                                    UINT flags, const LARGE_INTEGER *timeout ) DECLSPEC_HIDDEN;
 extern unsigned int server_queue_process_apc( HANDLE process, const apc_call_t *call, apc_result_t *result ) DECLSPEC_HIDDEN;
 extern int server_remove_fd_from_cache( HANDLE handle ) DECLSPEC_HIDDEN;
+extern void fast_sync_remove_from_cache( HANDLE handle ) DECLSPEC_HIDDEN;
 extern int server_get_unix_fd( HANDLE handle, unsigned int access, int *unix_fd,
                                int *needs_close, enum server_fd_type *type, unsigned int *options ) DECLSPEC_HIDDEN;
 extern int server_pipe( int fd[2] ) DECLSPEC_HIDDEN;
@@ -180,6 +181,19 @@ extern struct _KUSER_SHARED_DATA *user_shared_data DECLSPEC_HIDDEN;
 /* completion */
 extern NTSTATUS NTDLL_AddCompletion( HANDLE hFile, ULONG_PTR CompletionValue,
                                      NTSTATUS CompletionStatus, ULONG Information ) DECLSPEC_HIDDEN;
+extern NTSTATUS remove_server_completions( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info,
+                                           ULONG count, ULONG *written ) DECLSPEC_HIDDEN;
+extern void iocp_create_port( HANDLE handle ) DECLSPEC_HIDDEN;
+extern void iocp_close_handle( HANDLE handle ) DECLSPEC_HIDDEN;
+extern void iocp_set_completion_info( HANDLE handle, HANDLE port, ULONG_PTR ckey ) DECLSPEC_HIDDEN;
+extern unsigned int iocp_cancel_asyncs( HANDLE handle, const IO_STATUS_BLOCK *iosb,
+                                        BOOL only_thread ) DECLSPEC_HIDDEN;
+extern BOOL iocp_set_completion( HANDLE handle, ULONG_PTR ckey, ULONG_PTR cvalue,
+                                 NTSTATUS status, ULONG_PTR info ) DECLSPEC_HIDDEN;
+extern NTSTATUS iocp_remove_completions( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
+                                         ULONG *written, const LARGE_INTEGER *timeout,
+                                         BOOLEAN alertable ) DECLSPEC_HIDDEN;
+extern ULONG iocp_get_depth( HANDLE handle ) DECLSPEC_HIDDEN;
 
 /* code pages */
 extern int ntdll_umbstowcs(DWORD flags, const char* src, int srclen, WCHAR* dst, int dstlen) DECLSPEC_HIDDEN;
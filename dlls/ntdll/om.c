@@ -369,6 +369,8 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source,
             if (reply->closed && reply->self)
             {
                 int fd = server_remove_fd_from_cache( source );
+                fast_sync_remove_from_cache( source );
+                iocp_close_handle( source );
                 if (fd != -1) close( fd );
             }
         }
@@ -383,6 +385,8 @@ NTSTATUS close_handle( HANDLE handle )
     NTSTATUS ret;
     int fd = server_remove_fd_from_cache( handle );
 
+    fast_sync_remove_from_cache( handle );
+    iocp_close_handle( handle );
     SERVER_START_REQ( close_handle )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -768,11 +768,44 @@ NTSTATUS WINAPI NtNotifyChangeKey(
                                       ChangeBuffer, Length, Asynchronous);
 }
 
+/* retrieve several values of a key with batched server calls, storing each value at the given offset */
+static NTSTATUS get_key_values( HANDLE key, const KEY_MULTIPLE_VALUE_INFORMATION *values, ULONG count,
+                                struct __server_request_info *reqs, char *data,
+                                const ULONG *offsets, const ULONG *sizes )
+{
+    void *ptrs[__SERVER_MAX_BATCH];
+    ULONG i, j, n;
+    NTSTATUS ret;
+
+    for (i = 0; i < count; i += n)
+    {
+        n = min( count - i, __SERVER_MAX_BATCH );
+        for (j = 0; j < n; j++)
+        {
+            struct __server_request_info *req = &reqs[i + j];
+            const UNICODE_STRING *name = values[i + j].ValueName;
+
+            memset( &req->u.req, 0, sizeof(req->u.req) );
+            req->u.req.request_header.req = REQ_get_key_value;
+            req->u.req.get_key_value_request.hkey = wine_server_obj_handle( key );
+            req->data_count = 0;
+            wine_server_add_data( req, name->Buffer, name->Length );
+            wine_server_set_reply( req, data + offsets[i + j], sizes[i + j] );
+            ptrs[j] = req;
+        }
+        if ((ret = wine_server_call_batch( ptrs, n ))) return ret;
+    }
+    return STATUS_SUCCESS;
+}
+
 /******************************************************************************
  * NtQueryMultipleValueKey [NTDLL]
  * ZwQueryMultipleValueKey
+ *
+ * The values are first retrieved in equal parts of the buffer with a single
+ * round trip, and moved to their final offset. If some of them don't fit in
+ * their part, they are all retrieved again once their sizes are known.
  */
-
 NTSTATUS WINAPI NtQueryMultipleValueKey(
 	HANDLE KeyHandle,
 	PKEY_MULTIPLE_VALUE_INFORMATION ListOfValuesToQuery,
@@ -781,10 +814,86 @@ NTSTATUS WINAPI NtQueryMultipleValueKey(
 	ULONG Length,
 	PULONG  ReturnLength)
 {
-	FIXME("(%p,%p,0x%08x,%p,0x%08x,%p) stub!\n",
-	KeyHandle, ListOfValuesToQuery, NumberOfItems, MultipleValueInformation,
-	Length,ReturnLength);
-	return STATUS_SUCCESS;
+    struct __server_request_info *reqs;
+    char *data = MultipleValueInformation;
+    ULONG i, slice, pos = 0, *offsets, *sizes;
+    BOOL fits = TRUE;
+    NTSTATUS ret;
+
+    TRACE( "(%p,%p,%u,%p,%u,%p)\n", KeyHandle, ListOfValuesToQuery, NumberOfItems,
+           MultipleValueInformation, Length, ReturnLength );
+
+    if (!NumberOfItems)
+    {
+        if (ReturnLength) *ReturnLength = 0;
+        return STATUS_SUCCESS;
+    }
+    if (!(reqs = RtlAllocateHeap( GetProcessHeap(), 0,
+                                  NumberOfItems * (sizeof(*reqs) + 2 * sizeof(ULONG)) )))
+        return STATUS_NO_MEMORY;
+    offsets = (ULONG *)(reqs + NumberOfItems);
+    sizes = offsets + NumberOfItems;
+
+    slice = (Length / NumberOfItems) & ~(sizeof(ULONG) - 1);
+    for (i = 0; i < NumberOfItems; i++)
+    {
+        offsets[i] = i * slice;
+        sizes[i] = slice;
+    }
+    if ((ret = get_key_values( KeyHandle, ListOfValuesToQuery, NumberOfItems, reqs, data, offsets, sizes )))
+        goto done;
+
+    for (i = 0; i < NumberOfItems; i++)
+    {
+        const struct get_key_value_reply *reply = &reqs[i].u.reply.get_key_value_reply;
+
+        if ((ret = reply->__header.error)) goto done;
+        if (reply->total > slice) fits = FALSE;
+        pos = (pos + sizeof(ULONG) - 1) & ~(sizeof(ULONG) - 1);
+        ListOfValuesToQuery[i].DataOffset = pos;
+        ListOfValuesToQuery[i].DataLength = reply->total;
+        ListOfValuesToQuery[i].Type       = reply->type;
+        pos += reply->total;
+    }
+    if (ReturnLength) *ReturnLength = pos;
+    if (pos > Length)
+    {
+        ret = STATUS_BUFFER_OVERFLOW;
+        goto done;
+    }
+
+    if (fits)
+    {
+        /* each value can only move down, since the previous ones fit in their part */
+        for (i = 0; i < NumberOfItems; i++)
+            memmove( data + ListOfValuesToQuery[i].DataOffset, data + i * slice,
+                     ListOfValuesToQuery[i].DataLength );
+        goto done;
+    }
+
+    for (i = 0; i < NumberOfItems; i++)
+    {
+        offsets[i] = ListOfValuesToQuery[i].DataOffset;
+        sizes[i] = ListOfValuesToQuery[i].DataLength;
+    }
+    if ((ret = get_key_values( KeyHandle, ListOfValuesToQuery, NumberOfItems, reqs, data, offsets, sizes )))
+        goto done;
+    for (i = 0; i < NumberOfItems; i++)
+    {
+        const struct get_key_value_reply *reply = &reqs[i].u.reply.get_key_value_reply;
+
+        if ((ret = reply->__header.error)) break;
+        /* the value has been modified in the meantime */
+        if (reply->total != sizes[i] || reply->type != ListOfValuesToQuery[i].Type)
+        {
+            ret = STATUS_BUFFER_OVERFLOW;
+            break;
+        }
+    }
+
+done:
+    RtlFreeHeap( GetProcessHeap(), 0, reqs );
+    return ret;
 }
 
 /******************************************************************************
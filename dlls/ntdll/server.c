@@ -313,6 +313,80 @@ unsigned int wine_server_call( void *req_ptr )
 }
 
 
+/***********************************************************************
+ *           wine_server_call_batch (NTDLL.@)
+ *
+ * Perform several independent server calls in a single round trip.
+ *
+ * PARAMS
+ *     reqs  [I/O] Array of requests, filled as for wine_server_call
+ *     count [I]   Number of requests, at most __SERVER_MAX_BATCH
+ *
+ * RETURNS
+ *     STATUS_SUCCESS if all the requests have been processed, in which case
+ *     the status of each request is stored in its reply header, otherwise an
+ *     NTSTATUS code.
+ *
+ * NOTES
+ *     The requests are processed in order, but each one is processed even
+ *     if a previous one failed. Only the non-blocking registry and object
+ *     queries accepted by the server can be batched, the other requests fail
+ *     with STATUS_NOT_SUPPORTED.
+ */
+unsigned int wine_server_call_batch( void **reqs, unsigned int count )
+{
+    struct __server_request_info batch;
+    struct iovec vec[1 + __SERVER_MAX_BATCH * (__SERVER_MAX_DATA + 1)];
+    struct __server_request_info *req;
+    unsigned int i, j, nb_vec = 1, done;
+    data_size_t size = 0, reply_size = 0;
+    sigset_t old_set;
+    int ret;
+
+    if (count > __SERVER_MAX_BATCH) return STATUS_INVALID_PARAMETER;
+
+    memset( &batch.u.req, 0, sizeof(batch.u.req) );
+    batch.u.req.request_header.req = REQ_batch;
+    batch.u.req.batch_request.count = count;
+
+    for (i = 0; i < count; i++)
+    {
+        req = reqs[i];
+        vec[nb_vec].iov_base = (void *)&req->u.req;
+        vec[nb_vec++].iov_len = sizeof(req->u.req);
+        for (j = 0; j < req->data_count; j++)
+        {
+            vec[nb_vec].iov_base = (void *)req->data[j].ptr;
+            vec[nb_vec++].iov_len = req->data[j].size;
+        }
+        size += sizeof(req->u.req) + req->u.req.request_header.request_size;
+        reply_size += sizeof(req->u.reply) + req->u.req.request_header.reply_size;
+    }
+    batch.u.req.request_header.request_size = size;
+    batch.u.req.request_header.reply_size = reply_size;
+    vec[0].iov_base = (void *)&batch.u.req;
+    vec[0].iov_len = sizeof(batch.u.req);
+
+    pthread_sigmask( SIG_BLOCK, &server_block_set, &old_set );
+
+    if ((ret = writev( ntdll_get_thread_data()->request_fd, vec, nb_vec )) != size + sizeof(batch.u.req))
+    {
+        if (ret >= 0) server_protocol_error( "partial write %d\n", ret );
+        if (errno == EPIPE) abort_thread(0);
+        if (errno != EFAULT) server_protocol_perror( "write" );
+        pthread_sigmask( SIG_SETMASK, &old_set, NULL );
+        return STATUS_ACCESS_VIOLATION;
+    }
+
+    read_reply_data( &batch.u.reply, sizeof(batch.u.reply) );
+    done = batch.u.reply.batch_reply.count;
+    for (i = 0; i < done; i++) wait_reply( reqs[i] );
+
+    pthread_sigmask( SIG_SETMASK, &old_set, NULL );
+    return batch.u.reply.reply_header.error;
+}
+
+
 /***********************************************************************
  *           server_enter_uninterrupted_section
  */
@@ -166,6 +166,263 @@ NTSTATUS validate_open_object_attributes( const OBJECT_ATTRIBUTES *attr )
     return STATUS_SUCCESS;
 }
 
+/*
+ *	Fast synchronization objects
+ *
+ * When enabled in the server, the state of events and semaphores lives in a
+ * shared memory region, mapped read-only in the clients, so that queries can
+ * be done without server calls. The object of each handle is cached until
+ * the handle is closed, or until the server reports that a process closed
+ * a handle of another one. See server/fast_sync.c.
+ */
+
+union fast_sync_cache_entry
+{
+    LONG64 data;
+    struct
+    {
+        unsigned int index  : 24;  /* index of the object state in the shared region */
+        unsigned int type   : 3;   /* object type (FAST_SYNC_*) */
+        unsigned int access : 4;   /* FAST_SYNC_ACCESS_* flags */
+        unsigned int valid  : 1;   /* cache entry has been filled */
+        unsigned int max;          /* maximum count for semaphores */
+    } s;
+};
+
+C_ASSERT( sizeof(union fast_sync_cache_entry) == sizeof(LONG64) );
+
+#define FAST_SYNC_ACCESS_QUERY   0x1
+#define FAST_SYNC_ACCESS_MODIFY  0x2
+#define FAST_SYNC_ACCESS_WAIT    0x4
+
+#define FAST_SYNC_CACHE_BLOCK_SIZE  (65536 / sizeof(union fast_sync_cache_entry))
+#define FAST_SYNC_CACHE_ENTRIES     128
+
+static union fast_sync_cache_entry *fast_sync_cache[FAST_SYNC_CACHE_ENTRIES];
+static fast_sync_state_t *fast_sync_region;
+static unsigned int fast_sync_region_count;
+static unsigned int fast_sync_generation;
+static BOOL fast_sync_disabled;
+
+static RTL_CRITICAL_SECTION fast_sync_section;
+static RTL_CRITICAL_SECTION_DEBUG fast_sync_critsect_debug =
+{
+    0, 0, &fast_sync_section,
+    { &fast_sync_critsect_debug.ProcessLocksList, &fast_sync_critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": fast_sync_section") }
+};
+static RTL_CRITICAL_SECTION fast_sync_section = { &fast_sync_critsect_debug, -1, 0, 0, 0, 0 };
+
+static inline unsigned int fast_sync_handle_to_index( HANDLE handle, unsigned int *entry )
+{
+    unsigned int idx = (wine_server_obj_handle(handle) >> 2) - 1;
+    *entry = idx / FAST_SYNC_CACHE_BLOCK_SIZE;
+    return idx % FAST_SYNC_CACHE_BLOCK_SIZE;
+}
+
+static inline void set_fast_sync_cache_entry( union fast_sync_cache_entry *entry, LONG64 data )
+{
+    LONG64 old, new;
+
+    for (old = entry->data;; old = new)
+        if ((new = interlocked_cmpxchg64( &entry->data, data, old )) == old) break;
+}
+
+/* read the count of an object state, the server may change it at any time */
+static inline unsigned int fast_sync_read_count( unsigned int index )
+{
+    return *(volatile fast_sync_state_t *)&fast_sync_region[index];
+}
+
+/***********************************************************************
+ *           map_fast_sync_region
+ *
+ * Caller must hold fast_sync_section.
+ */
+static BOOL map_fast_sync_region(void)
+{
+    HANDLE handle = 0;
+    SIZE_T size = 0;
+    void *ptr = NULL;
+    NTSTATUS ret;
+
+    SERVER_START_REQ( get_fast_sync_region )
+    {
+        if (!(ret = wine_server_call( req )))
+        {
+            handle = wine_server_ptr_handle( reply->handle );
+            size = reply->size;
+        }
+    }
+    SERVER_END_REQ;
+
+    if (!ret)
+    {
+        ret = NtMapViewOfSection( handle, NtCurrentProcess(), &ptr, 0, 0, NULL, &size,
+                                  ViewShare, 0, PAGE_READONLY );
+        NtClose( handle );
+    }
+    if (ret)
+    {
+        TRACE( "fast synchronization not available (%08x)\n", ret );
+        fast_sync_disabled = TRUE;
+        return FALSE;
+    }
+    fast_sync_region_count = size / sizeof(fast_sync_state_t);
+    fast_sync_region = ptr;
+    fast_sync_generation = fast_sync_read_count( FAST_SYNC_GENERATION_INDEX );
+    return TRUE;
+}
+
+/***********************************************************************
+ *           flush_fast_sync_cache
+ *
+ * Forget all the cached objects, since the handles may have been reused.
+ */
+static void flush_fast_sync_cache(void)
+{
+    unsigned int entry, idx;
+    sigset_t sigset;
+
+    server_enter_uninterrupted_section( &fast_sync_section, &sigset );
+    /* update the generation first, so that a close happening during the flush is not missed */
+    fast_sync_generation = fast_sync_read_count( FAST_SYNC_GENERATION_INDEX );
+    for (entry = 0; entry < FAST_SYNC_CACHE_ENTRIES; entry++)
+    {
+        if (!fast_sync_cache[entry]) continue;
+        for (idx = 0; idx < FAST_SYNC_CACHE_BLOCK_SIZE; idx++)
+            if (fast_sync_cache[entry][idx].data)
+                set_fast_sync_cache_entry( &fast_sync_cache[entry][idx], 0 );
+    }
+    server_leave_uninterrupted_section( &fast_sync_section, &sigset );
+}
+
+/***********************************************************************
+ *           get_fast_sync_object
+ *
+ * Retrieve the cached fast synchronization info of a handle, querying the
+ * server on the first use. Returns FALSE if the object can't use the fast path.
+ */
+static BOOL get_fast_sync_object( HANDLE handle, union fast_sync_cache_entry *obj )
+{
+    unsigned int entry, idx = fast_sync_handle_to_index( handle, &entry );
+    union fast_sync_cache_entry cache;
+    sigset_t sigset;
+    NTSTATUS ret;
+
+    cache.data = 0;
+
+    if (fast_sync_disabled || entry >= FAST_SYNC_CACHE_ENTRIES) return FALSE;
+
+    /* a handle has been closed by another process, possibly one of ours */
+    if (fast_sync_region && fast_sync_read_count( FAST_SYNC_GENERATION_INDEX ) != fast_sync_generation)
+        flush_fast_sync_cache();
+
+    if (fast_sync_cache[entry])
+    {
+        obj->data = interlocked_cmpxchg64( &fast_sync_cache[entry][idx].data, 0, 0 );
+        if (obj->s.valid) return obj->s.type != FAST_SYNC_NONE;
+    }
+
+    server_enter_uninterrupted_section( &fast_sync_section, &sigset );
+
+    if (!fast_sync_region && !map_fast_sync_region()) goto done;
+
+    if (!fast_sync_cache[entry])  /* do we need to allocate a new block of entries? */
+    {
+        fast_sync_cache[entry] = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                                  FAST_SYNC_CACHE_BLOCK_SIZE * sizeof(cache) );
+        if (!fast_sync_cache[entry]) goto done;
+    }
+
+    SERVER_START_REQ( get_fast_sync_object )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        if (!(ret = wine_server_call( req )))
+        {
+            cache.s.valid = 1;
+            if (reply->type != FAST_SYNC_NONE && reply->index != FAST_SYNC_GENERATION_INDEX &&
+                reply->index < fast_sync_region_count)
+            {
+                cache.s.index = reply->index;
+                cache.s.type  = reply->type;
+                cache.s.max   = reply->max;
+                if (reply->access & EVENT_QUERY_STATE) cache.s.access |= FAST_SYNC_ACCESS_QUERY;
+                if (reply->access & EVENT_MODIFY_STATE) cache.s.access |= FAST_SYNC_ACCESS_MODIFY;
+                if (reply->access & SYNCHRONIZE) cache.s.access |= FAST_SYNC_ACCESS_WAIT;
+            }
+        }
+    }
+    SERVER_END_REQ;
+
+    /* don't cache invalid handles */
+    if (cache.s.valid) set_fast_sync_cache_entry( &fast_sync_cache[entry][idx], cache.data );
+
+done:
+    server_leave_uninterrupted_section( &fast_sync_section, &sigset );
+    if (!cache.s.valid || cache.s.type == FAST_SYNC_NONE) return FALSE;
+    *obj = cache;
+    return TRUE;
+}
+
+/***********************************************************************
+ *           fast_sync_remove_from_cache
+ */
+void fast_sync_remove_from_cache( HANDLE handle )
+{
+    unsigned int entry, idx = fast_sync_handle_to_index( handle, &entry );
+
+    if (entry < FAST_SYNC_CACHE_ENTRIES && fast_sync_cache[entry])
+        set_fast_sync_cache_entry( &fast_sync_cache[entry][idx], 0 );
+}
+
+/* wait for any of the objects without a server call, if possible */
+static NTSTATUS fast_sync_wait_any( DWORD count, const HANDLE *handles, BOOLEAN alertable,
+                                    const LARGE_INTEGER *timeout )
+{
+    union fast_sync_cache_entry objs[MAXIMUM_WAIT_OBJECTS];
+    DWORD i;
+
+    /* leave alertable waits to the server, which knows about the queued user APCs */
+    if (alertable) return STATUS_NOT_IMPLEMENTED;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!get_fast_sync_object( handles[i], &objs[i] )) return STATUS_NOT_IMPLEMENTED;
+        if (!(objs[i].s.access & FAST_SYNC_ACCESS_WAIT)) return STATUS_NOT_IMPLEMENTED;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (!fast_sync_read_count( objs[i].s.index )) continue;
+        /* only the server can consume the signaled state */
+        if (objs[i].s.type != FAST_SYNC_MANUAL_EVENT) return STATUS_NOT_IMPLEMENTED;
+        return STATUS_WAIT_0 + i;
+    }
+
+    /* nothing signaled, we can only avoid the server for a poll */
+    if (timeout && !timeout->QuadPart) return STATUS_TIMEOUT;
+    return STATUS_NOT_IMPLEMENTED;
+}
+
+/* skip setting or resetting an event that is already in the requested state */
+static NTSTATUS fast_sync_set_event( HANDLE handle, BOOL signaled )
+{
+    union fast_sync_cache_entry obj;
+
+    if (!get_fast_sync_object( handle, &obj )) return STATUS_NOT_IMPLEMENTED;
+    if (obj.s.type == FAST_SYNC_SEMAPHORE) return STATUS_OBJECT_TYPE_MISMATCH;
+    if (!(obj.s.access & FAST_SYNC_ACCESS_MODIFY)) return STATUS_NOT_IMPLEMENTED;
+    return fast_sync_read_count( obj.s.index ) == signaled ? STATUS_SUCCESS : STATUS_NOT_IMPLEMENTED;
+}
+
+static NTSTATUS fast_sync_query( HANDLE handle, union fast_sync_cache_entry *obj, unsigned int *count )
+{
+    if (!get_fast_sync_object( handle, obj )) return STATUS_NOT_IMPLEMENTED;
+    if (!(obj->s.access & FAST_SYNC_ACCESS_QUERY)) return STATUS_NOT_IMPLEMENTED;
+    *count = fast_sync_read_count( obj->s.index );
+    return STATUS_SUCCESS;
+}
+
 /*
  *	Semaphores
  */
@@ -234,6 +491,8 @@ NTSTATUS WINAPI NtQuerySemaphore( HANDLE handle, SEMAPHORE_INFORMATION_CLASS cla
 {
     NTSTATUS ret;
     SEMAPHORE_BASIC_INFORMATION *out = info;
+    union fast_sync_cache_entry obj;
+    unsigned int count;
 
     TRACE("(%p, %u, %p, %u, %p)\n", handle, class, info, len, ret_len);
 
@@ -245,6 +504,14 @@ NTSTATUS WINAPI NtQuerySemaphore( HANDLE handle, SEMAPHORE_INFORMATION_CLASS cla
 
     if (len != sizeof(SEMAPHORE_BASIC_INFORMATION)) return STATUS_INFO_LENGTH_MISMATCH;
 
+    if (!fast_sync_query( handle, &obj, &count ) && obj.s.type == FAST_SYNC_SEMAPHORE)
+    {
+        out->CurrentCount = count;
+        out->MaximumCount = obj.s.max;
+        if (ret_len) *ret_len = sizeof(SEMAPHORE_BASIC_INFORMATION);
+        return STATUS_SUCCESS;
+    }
+
     SERVER_START_REQ( query_semaphore )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -346,6 +613,8 @@ NTSTATUS WINAPI NtSetEvent( HANDLE handle, PULONG NumberOfThreadsReleased )
 
     /* FIXME: set NumberOfThreadsReleased */
 
+    if ((ret = fast_sync_set_event( handle, TRUE )) != STATUS_NOT_IMPLEMENTED) return ret;
+
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -366,6 +635,8 @@ NTSTATUS WINAPI NtResetEvent( HANDLE handle, PULONG NumberOfThreadsReleased )
     /* resetting an event can't release any thread... */
     if (NumberOfThreadsReleased) *NumberOfThreadsReleased = 0;
 
+    if ((ret = fast_sync_set_event( handle, FALSE )) != STATUS_NOT_IMPLEMENTED) return ret;
+
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -418,6 +689,8 @@ NTSTATUS WINAPI NtQueryEvent( HANDLE handle, EVENT_INFORMATION_CLASS class,
 {
     NTSTATUS ret;
     EVENT_BASIC_INFORMATION *out = info;
+    union fast_sync_cache_entry obj;
+    unsigned int state;
 
     TRACE("(%p, %u, %p, %u, %p)\n", handle, class, info, len, ret_len);
 
@@ -430,6 +703,14 @@ NTSTATUS WINAPI NtQueryEvent( HANDLE handle, EVENT_INFORMATION_CLASS class,
 
     if (len != sizeof(EVENT_BASIC_INFORMATION)) return STATUS_INFO_LENGTH_MISMATCH;
 
+    if (!fast_sync_query( handle, &obj, &state ) && obj.s.type != FAST_SYNC_SEMAPHORE)
+    {
+        out->EventType  = obj.s.type == FAST_SYNC_MANUAL_EVENT ? NotificationEvent : SynchronizationEvent;
+        out->EventState = state;
+        if (ret_len) *ret_len = sizeof(EVENT_BASIC_INFORMATION);
+        return STATUS_SUCCESS;
+    }
+
     SERVER_START_REQ( query_event )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -1022,9 +1303,13 @@ static NTSTATUS wait_objects( DWORD count, const HANDLE *handles,
 {
     select_op_t select_op;
     UINT i, flags = SELECT_INTERRUPTIBLE;
+    NTSTATUS ret;
 
     if (!count || count > MAXIMUM_WAIT_OBJECTS) return STATUS_INVALID_PARAMETER_1;
 
+    if (wait_any && (ret = fast_sync_wait_any( count, handles, alertable, timeout )) != STATUS_NOT_IMPLEMENTED)
+        return ret;
+
     if (alertable) flags |= SELECT_ALERTABLE;
     select_op.wait.op = wait_any ? SELECT_WAIT : SELECT_WAIT_ALL;
     for (i = 0; i < count; i++) select_op.wait.handles[i] = wine_server_obj_handle( handles[i] );
@@ -1247,6 +1532,7 @@ NTSTATUS WINAPI NtCreateIoCompletion( PHANDLE CompletionPort, ACCESS_MASK Desire
     }
     SERVER_END_REQ;
 
+    if (!status) iocp_create_port( *CompletionPort );
     RtlFreeHeap( GetProcessHeap(), 0, objattr );
     return status;
 }
@@ -1273,6 +1559,10 @@ NTSTATUS WINAPI NtSetIoCompletion( HANDLE CompletionPort, ULONG_PTR CompletionKe
     TRACE("(%p, %lx, %lx, %x, %lx)\n", CompletionPort, CompletionKey,
           CompletionValue, Status, NumberOfBytesTransferred);
 
+    if (iocp_set_completion( CompletionPort, CompletionKey, CompletionValue,
+                             Status, NumberOfBytesTransferred ))
+        return STATUS_SUCCESS;
+
     SERVER_START_REQ( add_completion )
     {
         req->handle      = wine_server_obj_handle( CompletionPort );
@@ -1304,11 +1594,22 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE CompletionPort, PULONG_PTR Completi
                                       PULONG_PTR CompletionValue, PIO_STATUS_BLOCK iosb,
                                       PLARGE_INTEGER WaitTime )
 {
+    FILE_IO_COMPLETION_INFORMATION info;
     NTSTATUS status;
+    ULONG count;
 
     TRACE("(%p, %p, %p, %p, %p)\n", CompletionPort, CompletionKey,
           CompletionValue, iosb, WaitTime);
 
+    status = iocp_remove_completions( CompletionPort, &info, 1, &count, WaitTime, FALSE );
+    if (status == STATUS_SUCCESS)
+    {
+        *CompletionKey   = info.CompletionKey;
+        *CompletionValue = info.CompletionValue;
+        *iosb            = info.IoStatusBlock;
+    }
+    if (status != STATUS_NOT_SUPPORTED) return status;
+
     for(;;)
     {
         SERVER_START_REQ( remove_completion )
@@ -1331,6 +1632,80 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE CompletionPort, PULONG_PTR Completi
     return status;
 }
 
+/* maximum number of completions retrieved with a single server request */
+#define MAX_SERVER_COMPLETIONS 64
+
+/***********************************************************************
+ *           remove_server_completions
+ *
+ * Retrieve the completions queued on a server completion object, without waiting.
+ */
+NTSTATUS remove_server_completions( HANDLE handle, FILE_IO_COMPLETION_INFORMATION *info,
+                                    ULONG count, ULONG *written )
+{
+    struct completion_entry entries[MAX_SERVER_COMPLETIONS];
+    NTSTATUS status;
+    ULONG i;
+
+    *written = 0;
+    SERVER_START_REQ( remove_completions )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        wine_server_set_reply( req, entries, min( count, MAX_SERVER_COMPLETIONS ) * sizeof(entries[0]) );
+        if (!(status = wine_server_call( req )))
+            *written = wine_server_reply_size( reply ) / sizeof(entries[0]);
+    }
+    SERVER_END_REQ;
+
+    for (i = 0; i < *written; i++)
+    {
+        info[i].CompletionKey             = entries[i].ckey;
+        info[i].CompletionValue           = entries[i].cvalue;
+        info[i].IoStatusBlock.u.Status    = entries[i].status;
+        info[i].IoStatusBlock.Information = entries[i].information;
+    }
+    return status;
+}
+
+/******************************************************************
+ *              NtRemoveIoCompletionEx (NTDLL.@)
+ *              ZwRemoveIoCompletionEx (NTDLL.@)
+ *
+ * (Wait for and) retrieve several completion messages from completion object's queue
+ *
+ * PARAMS
+ *      CompletionPort  [I] HANDLE to I/O completion object
+ *      info            [O] array of retrieved completions
+ *      count           [I] number of entries in the array
+ *      written         [O] number of retrieved completions
+ *      WaitTime        [I] optional wait time in NTDLL format
+ *      alertable       [I] whether the wait is alertable
+ *
+ */
+NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE CompletionPort, FILE_IO_COMPLETION_INFORMATION *info,
+                                        ULONG count, ULONG *written, LARGE_INTEGER *WaitTime,
+                                        BOOLEAN alertable )
+{
+    NTSTATUS status;
+
+    TRACE("(%p, %p, %u, %p, %p, %u)\n", CompletionPort, info, count, written, WaitTime, alertable);
+
+    if (!count) return STATUS_INVALID_PARAMETER;
+
+    status = iocp_remove_completions( CompletionPort, info, count, written, WaitTime, alertable );
+    if (status != STATUS_NOT_SUPPORTED) return status;
+
+    for (;;)
+    {
+        status = remove_server_completions( CompletionPort, info, count, written );
+        if (status != STATUS_PENDING) break;
+
+        status = NtWaitForSingleObject( CompletionPort, alertable, WaitTime );
+        if (status != WAIT_OBJECT_0) break;
+    }
+    return status;
+}
+
 /******************************************************************
  *              NtOpenIoCompletion (NTDLL.@)
  *              ZwOpenIoCompletion (NTDLL.@)
@@ -1402,7 +1777,7 @@ NTSTATUS WINAPI NtQueryIoCompletion( HANDLE CompletionPort, IO_COMPLETION_INFORM
                     {
                         req->handle = wine_server_obj_handle( CompletionPort );
                         if (!(status = wine_server_call( req )))
-                            *info = reply->depth;
+                            *info = reply->depth + iocp_get_depth( CompletionPort );
                     }
                     SERVER_END_REQ;
                 }
@@ -1420,6 +1795,9 @@ NTSTATUS NTDLL_AddCompletion( HANDLE hFile, ULONG_PTR CompletionValue,
 {
     NTSTATUS status;
 
+    if (!__wine_add_local_completion( hFile, CompletionValue, CompletionStatus, Information ))
+        return STATUS_SUCCESS;
+
     SERVER_START_REQ( add_fd_completion )
     {
         req->handle      = wine_server_obj_handle( hFile );
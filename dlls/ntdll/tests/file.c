@@ -73,6 +73,7 @@ static NTSTATUS (WINAPI *pNtCreateIoCompletion)(PHANDLE, ACCESS_MASK, POBJECT_AT
 static NTSTATUS (WINAPI *pNtOpenIoCompletion)(PHANDLE, ACCESS_MASK, POBJECT_ATTRIBUTES);
 static NTSTATUS (WINAPI *pNtQueryIoCompletion)(HANDLE, IO_COMPLETION_INFORMATION_CLASS, PVOID, ULONG, PULONG);
 static NTSTATUS (WINAPI *pNtRemoveIoCompletion)(HANDLE, PULONG_PTR, PULONG_PTR, PIO_STATUS_BLOCK, PLARGE_INTEGER);
+static NTSTATUS (WINAPI *pNtRemoveIoCompletionEx)(HANDLE, FILE_IO_COMPLETION_INFORMATION *, ULONG, ULONG *, LARGE_INTEGER *, BOOLEAN);
 static NTSTATUS (WINAPI *pNtSetIoCompletion)(HANDLE, ULONG_PTR, ULONG_PTR, NTSTATUS, SIZE_T);
 static NTSTATUS (WINAPI *pNtSetInformationFile)(HANDLE, PIO_STATUS_BLOCK, PVOID, ULONG, FILE_INFORMATION_CLASS);
 static NTSTATUS (WINAPI *pNtQueryInformationFile)(HANDLE, PIO_STATUS_BLOCK, PVOID, ULONG, FILE_INFORMATION_CLASS);
@@ -913,6 +914,51 @@ static void test_iocp_setcompletion(HANDLE h)
     ok( !count, "Unexpected msg count: %d\n", count );
 }
 
+static void test_iocp_removecompletions(HANDLE h)
+{
+    FILE_IO_COMPLETION_INFORMATION info[4];
+    LARGE_INTEGER timeout;
+    NTSTATUS res;
+    ULONG count, i;
+
+    if (!pNtRemoveIoCompletionEx)
+    {
+        win_skip("NtRemoveIoCompletionEx is not available\n");
+        return;
+    }
+
+    timeout.QuadPart = 0;
+    res = pNtRemoveIoCompletionEx( h, info, 4, &count, &timeout, FALSE );
+    ok( res == STATUS_TIMEOUT, "NtRemoveIoCompletionEx returned %x\n", res );
+
+    for (i = 0; i < 3; i++)
+    {
+        res = pNtSetIoCompletion( h, CKEY_FIRST + i, CVALUE_FIRST + i, STATUS_SUCCESS, i );
+        ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    }
+
+    count = 0;
+    res = pNtRemoveIoCompletionEx( h, info, 2, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %x\n", res );
+    ok( count == 2, "Unexpected count: %u\n", count );
+    for (i = 0; i < count; i++)
+    {
+        ok( info[i].CompletionKey == CKEY_FIRST + i, "%u: Invalid completion key: %lx\n", i, info[i].CompletionKey );
+        ok( info[i].CompletionValue == CVALUE_FIRST + i, "%u: Invalid completion value: %lx\n", i, info[i].CompletionValue );
+        ok( U(info[i].IoStatusBlock).Status == STATUS_SUCCESS, "%u: Invalid status: %x\n", i, U(info[i].IoStatusBlock).Status );
+        ok( info[i].IoStatusBlock.Information == i, "%u: Invalid information: %lu\n", i, info[i].IoStatusBlock.Information );
+    }
+
+    count = 0;
+    res = pNtRemoveIoCompletionEx( h, info, 4, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %x\n", res );
+    ok( count == 1, "Unexpected count: %u\n", count );
+    ok( info[0].CompletionKey == CKEY_FIRST + 2, "Invalid completion key: %lx\n", info[0].CompletionKey );
+
+    count = get_pending_msgs(h);
+    ok( !count, "Unexpected msg count: %d\n", count );
+}
+
 static void test_iocp_fileio(HANDLE h)
 {
     static const char pipe_name[] = "\\\\.\\pipe\\iocompletiontestnamedpipe";
@@ -2727,11 +2773,112 @@ static void test_iocompletion(void)
     if ( h && h != INVALID_HANDLE_VALUE)
     {
         test_iocp_setcompletion(h);
+        test_iocp_removecompletions(h);
         test_iocp_fileio(h);
         pNtClose(h);
     }
 }
 
+static DWORD WINAPI iocp_waiter_thread( void *arg )
+{
+    LARGE_INTEGER timeout;
+    ULONG_PTR key, value;
+    IO_STATUS_BLOCK io;
+    NTSTATUS res;
+
+    timeout.QuadPart = -10000000 * 5;
+    res = pNtRemoveIoCompletion( arg, &key, &value, &io, &timeout );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletion failed: %x\n", res );
+    ok( key == CKEY_FIRST, "Invalid completion key: %lx\n", key );
+    ok( value == CVALUE_FIRST, "Invalid completion value: %lx\n", value );
+    return 0;
+}
+
+/* run in a child process with WINEFASTIOCP set, so that Wine uses process-local queues */
+static void test_iocp_consumers_child(void)
+{
+    FILE_IO_COMPLETION_INFORMATION info[2];
+    LARGE_INTEGER timeout;
+    HANDLE h, dup, thread;
+    ULONG_PTR key, value;
+    IO_STATUS_BLOCK io;
+    NTSTATUS res;
+    ULONG count;
+
+    res = pNtCreateIoCompletion( &h, IO_COMPLETION_ALL_ACCESS, NULL, 0 );
+    ok( res == STATUS_SUCCESS, "NtCreateIoCompletion failed: %x\n", res );
+    DuplicateHandle( GetCurrentProcess(), h, GetCurrentProcess(), &dup, 0, FALSE, DUPLICATE_SAME_ACCESS );
+
+    /* a completion posted while a thread is blocked must not leave anything behind */
+    thread = CreateThread( NULL, 0, iocp_waiter_thread, h, 0, NULL );
+    Sleep( 100 );
+    res = pNtSetIoCompletion( h, CKEY_FIRST, CVALUE_FIRST, STATUS_SUCCESS, 0 );
+    ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    ok( !WaitForSingleObject( thread, 5000 ), "waiter thread didn't finish\n" );
+    CloseHandle( thread );
+
+    timeout.QuadPart = 0;
+    res = pNtRemoveIoCompletion( dup, &key, &value, &io, &timeout );
+    ok( res == STATUS_TIMEOUT, "NtRemoveIoCompletion returned %x, value %lx\n", res, value );
+    count = get_pending_msgs( h );
+    ok( !count, "Unexpected msg count: %d\n", count );
+
+    /* same thing with a waiter that times out before the completion is posted */
+    timeout.QuadPart = -10000 * 50;
+    res = pNtRemoveIoCompletion( h, &key, &value, &io, &timeout );
+    ok( res == STATUS_TIMEOUT, "NtRemoveIoCompletion returned %x\n", res );
+    res = pNtSetIoCompletion( h, CKEY_FIRST, CVALUE_FIRST, STATUS_SUCCESS, 0 );
+    ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    if (get_msg( h ))
+        ok( completionValue == CVALUE_FIRST, "Invalid completion value: %lx\n", completionValue );
+
+    timeout.QuadPart = 0;
+    count = 0;
+    res = pNtRemoveIoCompletionEx( dup, info, 2, &count, &timeout, FALSE );
+    ok( res == STATUS_TIMEOUT, "NtRemoveIoCompletionEx returned %x, count %u\n", res, count );
+
+    /* completions posted through the duplicated handle are seen by both */
+    res = pNtSetIoCompletion( dup, CKEY_FIRST, CVALUE_FIRST, STATUS_SUCCESS, 0 );
+    ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    res = pNtSetIoCompletion( dup, CKEY_FIRST + 1, CVALUE_FIRST + 1, STATUS_SUCCESS, 0 );
+    ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    if (get_msg( h ))
+        ok( completionValue == CVALUE_FIRST, "Invalid completion value: %lx\n", completionValue );
+    if (get_msg( dup ))
+        ok( completionValue == CVALUE_FIRST + 1, "Invalid completion value: %lx\n", completionValue );
+
+    count = get_pending_msgs( dup );
+    ok( !count, "Unexpected msg count: %d\n", count );
+    pNtClose( dup );
+    pNtClose( h );
+}
+
+static void test_iocp_consumers(void)
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH];
+    char **argv;
+    BOOL ret;
+
+    if (!pNtRemoveIoCompletionEx)
+    {
+        win_skip("NtRemoveIoCompletionEx is not available\n");
+        return;
+    }
+
+    winetest_get_mainargs( &argv );
+    sprintf( cmdline, "%s %s iocp_consumers", argv[0], argv[1] );
+    SetEnvironmentVariableA( "WINEFASTIOCP", "1" );
+    ret = CreateProcessA( NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi );
+    SetEnvironmentVariableA( "WINEFASTIOCP", NULL );
+    ok( ret, "CreateProcess failed, last error %u\n", GetLastError() );
+    if (!ret) return;
+    winetest_wait_child_process( pi.hProcess );
+    CloseHandle( pi.hProcess );
+    CloseHandle( pi.hThread );
+}
+
 static void test_file_name_information(void)
 {
     WCHAR *file_name, *volume_prefix, *expected;
@@ -4205,6 +4352,8 @@ static void test_flush_buffers_file(void)
 
 START_TEST(file)
 {
+    char **argv;
+    int argc;
     HMODULE hkernel32 = GetModuleHandleA("kernel32.dll");
     HMODULE hntdll = GetModuleHandleA("ntdll.dll");
     if (!hntdll)
@@ -4234,6 +4383,7 @@ START_TEST(file)
     pNtOpenIoCompletion     = (void *)GetProcAddress(hntdll, "NtOpenIoCompletion");
     pNtQueryIoCompletion    = (void *)GetProcAddress(hntdll, "NtQueryIoCompletion");
     pNtRemoveIoCompletion   = (void *)GetProcAddress(hntdll, "NtRemoveIoCompletion");
+    pNtRemoveIoCompletionEx = (void *)GetProcAddress(hntdll, "NtRemoveIoCompletionEx");
     pNtSetIoCompletion      = (void *)GetProcAddress(hntdll, "NtSetIoCompletion");
     pNtSetInformationFile   = (void *)GetProcAddress(hntdll, "NtSetInformationFile");
     pNtQueryInformationFile = (void *)GetProcAddress(hntdll, "NtQueryInformationFile");
@@ -4242,6 +4392,13 @@ START_TEST(file)
     pNtQueryFullAttributesFile = (void *)GetProcAddress(hntdll, "NtQueryFullAttributesFile");
     pNtFlushBuffersFile = (void *)GetProcAddress(hntdll, "NtFlushBuffersFile");
 
+    argc = winetest_get_mainargs( &argv );
+    if (argc >= 3 && !strcmp( argv[2], "iocp_consumers" ))
+    {
+        test_iocp_consumers_child();
+        return;
+    }
+
     test_read_write();
     test_NtCreateFile();
     create_file_test();
@@ -4251,6 +4408,7 @@ START_TEST(file)
     append_file_test();
     nt_mailslot_test();
     test_iocompletion();
+    test_iocp_consumers();
     test_file_basic_information();
     test_file_all_information();
     test_file_both_information();
@@ -53,7 +53,7 @@
 #include "wine/library.h"
 #include "wine/server.h"
 #include "wine/exception.h"
-#include "wine/list.h"
+#include "wine/rbtree.h"
 #include "wine/debug.h"
 #include "ntdll_misc.h"
 
@@ -67,9 +67,11 @@ WINE_DECLARE_DEBUG_CHANNEL(module);
 /* File view */
 struct file_view
 {
-    struct list   entry;       /* Entry in global view list */
+    struct wine_rb_entry entry;      /* Entry in global view tree */
+    struct wine_rb_entry free_entry; /* Entry in free ranges tree */
     void         *base;        /* Base address */
     size_t        size;        /* Size in bytes */
+    size_t        free_size;   /* Size of the free range following the view, 0 if none */
     HANDLE        mapping;     /* Handle to the file mapping */
     unsigned int  map_protect; /* Mapping protection */
     unsigned int  protect;     /* Protection for all pages at allocation time */
@@ -98,7 +100,12 @@ static const BYTE VIRTUAL_Win32Flags[16] =
     PAGE_EXECUTE_WRITECOPY      /* READ | WRITE | EXEC | WRITECOPY */
 };
 
-static struct list views_list = LIST_INIT(views_list);
+static int compare_view( const void *addr, const struct wine_rb_entry *entry );
+static int compare_free_range( const void *addr, const struct wine_rb_entry *entry );
+
+static struct wine_rb_tree views_tree = { compare_view };
+/* views that are followed by some free space, used to find free areas */
+static struct wine_rb_tree free_ranges_tree = { compare_free_range };
 
 static RTL_CRITICAL_SECTION csVirtual;
 static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
@@ -235,7 +242,7 @@ static void VIRTUAL_Dump(void)
 
     TRACE( "Dump of all virtual memory views:\n" );
     server_enter_uninterrupted_section( &csVirtual, &sigset );
-    LIST_FOR_EACH_ENTRY( view, &views_list, struct file_view, entry )
+    WINE_RB_FOR_EACH_ENTRY( view, &views_tree, struct file_view, entry )
     {
         VIRTUAL_DumpView( view );
     }
@@ -244,6 +251,36 @@ static void VIRTUAL_Dump(void)
 #endif
 
 
+/***********************************************************************
+ *           compare_view
+ *
+ * Compare function for the views tree.
+ */
+static int compare_view( const void *addr, const struct wine_rb_entry *entry )
+{
+    struct file_view *view = WINE_RB_ENTRY_VALUE( entry, struct file_view, entry );
+
+    if (addr < view->base) return -1;
+    if (addr > view->base) return 1;
+    return 0;
+}
+
+
+/***********************************************************************
+ *           compare_free_range
+ *
+ * Compare function for the free ranges tree.
+ */
+static int compare_free_range( const void *addr, const struct wine_rb_entry *entry )
+{
+    struct file_view *view = WINE_RB_ENTRY_VALUE( entry, struct file_view, free_entry );
+
+    if (addr < view->base) return -1;
+    if (addr > view->base) return 1;
+    return 0;
+}
+
+
 /***********************************************************************
  *           VIRTUAL_FindView
  *
@@ -258,15 +295,18 @@ static void VIRTUAL_Dump(void)
  */
 static struct file_view *VIRTUAL_FindView( const void *addr, size_t size )
 {
-    struct file_view *view;
+    struct wine_rb_entry *ptr = views_tree.root;
 
-    LIST_FOR_EACH_ENTRY( view, &views_list, struct file_view, entry )
+    if ((const char *)addr + size < (const char *)addr) return NULL; /* overflow */
+
+    while (ptr)
     {
-        if (view->base > addr) break;  /* no matching view */
-        if ((const char *)view->base + view->size <= (const char *)addr) continue;
-        if ((const char *)view->base + view->size < (const char *)addr + size) break;  /* size too large */
-        if ((const char *)addr + size < (const char *)addr) break; /* overflow */
-        return view;
+        struct file_view *view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+        if (view->base > addr) ptr = ptr->left;
+        else if ((const char *)view->base + view->size <= (const char *)addr) ptr = ptr->right;
+        else if ((const char *)view->base + view->size < (const char *)addr + size) break;  /* size too large */
+        else return view;
     }
     return NULL;
 }
@@ -291,17 +331,95 @@ static inline UINT_PTR get_mask( ULONG zero_bits )
  */
 static struct file_view *find_view_range( const void *addr, size_t size )
 {
-    struct file_view *view;
+    struct wine_rb_entry *ptr = views_tree.root;
 
-    LIST_FOR_EACH_ENTRY( view, &views_list, struct file_view, entry )
+    while (ptr)
     {
-        if ((const char *)view->base >= (const char *)addr + size) break;
-        if ((const char *)view->base + view->size > (const char *)addr) return view;
+        struct file_view *view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+        if ((const char *)view->base >= (const char *)addr + size) ptr = ptr->left;
+        else if ((const char *)view->base + view->size <= (const char *)addr) ptr = ptr->right;
+        else return view;
     }
     return NULL;
 }
 
 
+/***********************************************************************
+ *           find_prev_view
+ *
+ * Find the last view starting at or before the specified address.
+ * The csVirtual section must be held by caller.
+ */
+static struct file_view *find_prev_view( const void *addr )
+{
+    struct wine_rb_entry *ptr = views_tree.root;
+    struct file_view *ret = NULL;
+
+    while (ptr)
+    {
+        struct file_view *view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+        if (view->base > addr) ptr = ptr->left;
+        else
+        {
+            ret = view;
+            ptr = ptr->right;
+        }
+    }
+    return ret;
+}
+
+
+/***********************************************************************
+ *           find_free_range
+ *
+ * Find the first view followed by some free space that starts after the
+ * specified address, or the last one that starts before it if before is set.
+ * The csVirtual section must be held by caller.
+ */
+static struct file_view *find_free_range( const void *addr, int before )
+{
+    struct wine_rb_entry *ptr = free_ranges_tree.root;
+    struct file_view *ret = NULL;
+
+    while (ptr)
+    {
+        struct file_view *view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, free_entry );
+
+        if (before ? view->base < addr : view->base > addr)
+        {
+            ret = view;
+            ptr = before ? ptr->right : ptr->left;
+        }
+        else ptr = before ? ptr->left : ptr->right;
+    }
+    return ret;
+}
+
+
+/***********************************************************************
+ *           update_free_range
+ *
+ * Update the size of the free range following a view, after a view
+ * was created or deleted next to it.
+ * The csVirtual section must be held by caller.
+ */
+static void update_free_range( struct file_view *view )
+{
+    struct wine_rb_entry *next = wine_rb_next( &view->entry );
+    UINT_PTR end = (UINT_PTR)view->base + view->size;
+    size_t size;
+
+    if (next) size = (UINT_PTR)WINE_RB_ENTRY_VALUE( next, struct file_view, entry )->base - end;
+    else size = 0 - end;  /* free up to the top of the address space */
+
+    if (size && !view->free_size) wine_rb_put( &free_ranges_tree, view->base, &view->free_entry );
+    else if (!size && view->free_size) wine_rb_remove( &free_ranges_tree, &view->free_entry );
+    view->free_size = size;
+}
+
+
 /***********************************************************************
  *           find_free_area
  *
@@ -310,7 +428,8 @@ static struct file_view *find_view_range( const void *addr, size_t size )
  */
 static void *find_free_area( void *base, void *end, size_t size, size_t mask, int top_down )
 {
-    struct list *ptr;
+    struct wine_rb_entry *ptr;
+    struct file_view *view, *range;
     void *start;
 
     if (top_down)
@@ -318,32 +437,64 @@ static void *find_free_area( void *base, void *end, size_t size, size_t mask, in
         start = ROUND_ADDR( (char *)end - size, mask );
         if (start >= end || start < base) return NULL;
 
-        for (ptr = views_list.prev; ptr != &views_list; ptr = ptr->prev)
+        /* check if the area is free already */
+        if (!(view = find_prev_view( (char *)start + size - 1 ))) return start;
+        if ((char *)view->base + view->size <= (char *)start) return start;
+
+        /* otherwise look for the highest free range below that view that is large enough */
+        range = find_free_range( view->base, 1 );
+        while (range)
         {
-            struct file_view *view = LIST_ENTRY( ptr, struct file_view, entry );
+            char *range_start = (char *)range->base + range->size;
+            char *range_end = range_start + range->free_size;
 
-            if ((char *)view->base + view->size <= (char *)start) break;
-            if ((char *)view->base >= (char *)start + size) continue;
-            start = ROUND_ADDR( (char *)view->base - size, mask );
-            /* stop if remaining space is not large enough */
-            if (!start || start >= end || start < base) return NULL;
+            if (range->free_size >= size)
+            {
+                start = ROUND_ADDR( range_end - size, mask );
+                /* stop if remaining space is not large enough */
+                if (!start || start < base) return NULL;
+                if ((char *)start >= range_start) return start;
+            }
+            else if (range_end <= (char *)base) return NULL;
+            if (!(ptr = wine_rb_prev( &range->free_entry ))) break;
+            range = WINE_RB_ENTRY_VALUE( ptr, struct file_view, free_entry );
         }
+
+        /* finally try the space before the first view */
+        view = WINE_RB_ENTRY_VALUE( wine_rb_head( views_tree.root ), struct file_view, entry );
+        if ((char *)view->base < (char *)base || (char *)view->base - (char *)base < size) return NULL;
+        start = ROUND_ADDR( (char *)view->base - size, mask );
+        if (!start || start < base) return NULL;
     }
     else
     {
         start = ROUND_ADDR( (char *)base + mask, mask );
         if (start >= end || (char *)end - (char *)start < size) return NULL;
 
-        for (ptr = views_list.next; ptr != &views_list; ptr = ptr->next)
+        /* check if the area is free already */
+        if (!(view = find_prev_view( start )))
         {
-            struct file_view *view = LIST_ENTRY( ptr, struct file_view, entry );
+            if (!(ptr = wine_rb_head( views_tree.root ))) return start;
+            view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+            if ((char *)view->base - (char *)start >= size) return start;
+            range = find_free_range( start, 0 );
+        }
+        else if (view->free_size) range = view;
+        else range = find_free_range( view->base, 0 );
 
-            if ((char *)view->base >= (char *)start + size) break;
-            if ((char *)view->base + view->size <= (char *)start) continue;
-            start = ROUND_ADDR( (char *)view->base + view->size + mask, mask );
+        /* otherwise look for the lowest free range that is large enough */
+        while (range)
+        {
+            char *range_start = (char *)range->base + range->size;
+
+            if ((char *)start < range_start) start = ROUND_ADDR( range_start + mask, mask );
             /* stop if remaining space is not large enough */
             if (!start || start >= end || (char *)end - (char *)start < size) return NULL;
+            if ((char *)start - range_start + size <= range->free_size) return start;
+            if (!(ptr = wine_rb_next( &range->free_entry ))) break;
+            range = WINE_RB_ENTRY_VALUE( ptr, struct file_view, free_entry );
         }
+        return NULL;
     }
     return start;
 }
@@ -382,13 +533,18 @@ static void add_reserved_area( void *addr, size_t size )
 static void remove_reserved_area( void *addr, size_t size )
 {
     struct file_view *view;
+    struct wine_rb_entry *ptr;
 
     TRACE( "removing %p-%p\n", addr, (char *)addr + size );
     wine_mmap_remove_reserved_area( addr, size, 0 );
 
     /* unmap areas not covered by an existing view */
-    LIST_FOR_EACH_ENTRY( view, &views_list, struct file_view, entry )
+    if ((view = find_prev_view( addr ))) ptr = &view->entry;
+    else ptr = wine_rb_head( views_tree.root );
+
+    for ( ; ptr; ptr = wine_rb_next( ptr ))
     {
+        view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
         if ((char *)view->base >= (char *)addr + size)
         {
             munmap( addr, size );
@@ -438,8 +594,12 @@ static inline void unmap_area( void *addr, size_t size )
  */
 static void delete_view( struct file_view *view ) /* [in] View */
 {
+    struct wine_rb_entry *prev = wine_rb_prev( &view->entry );
+
     if (!(view->protect & VPROT_SYSTEM)) unmap_area( view->base, view->size );
-    list_remove( &view->entry );
+    if (view->free_size) wine_rb_remove( &free_ranges_tree, &view->free_entry );
+    wine_rb_remove( &views_tree, &view->entry );
+    if (prev) update_free_range( WINE_RB_ENTRY_VALUE( prev, struct file_view, entry ));
     if (view->mapping) close_handle( view->mapping );
     RtlFreeHeap( virtual_heap, 0, view );
 }
@@ -453,12 +613,24 @@ static void delete_view( struct file_view *view ) /* [in] View */
 static NTSTATUS create_view( struct file_view **view_ret, void *base, size_t size, unsigned int vprot )
 {
     struct file_view *view;
-    struct list *ptr;
+    struct wine_rb_entry *prev;
     int unix_prot = VIRTUAL_GetUnixProt( vprot );
 
     assert( !((UINT_PTR)base & page_mask) );
     assert( !(size & page_mask) );
 
+    /* Check for overlapping views. This can happen if the previous view
+     * was a system view that got unmapped behind our back. In that case
+     * we recover by simply deleting it. */
+
+    while ((view = find_view_range( base, size )))
+    {
+        TRACE( "overlapping view %p-%p for %p-%p\n",
+               view->base, (char *)view->base + view->size, base, (char *)base + size );
+        assert( view->protect & VPROT_SYSTEM );
+        delete_view( view );
+    }
+
     /* Create the view structure */
 
     if (!(view = RtlAllocateHeap( virtual_heap, 0, sizeof(*view) + (size >> page_shift) - 1 )))
@@ -469,48 +641,18 @@ static NTSTATUS create_view( struct file_view **view_ret, void *base, size_t siz
 
     view->base    = base;
     view->size    = size;
+    view->free_size = 0;
     view->mapping = 0;
     view->map_protect = 0;
     view->protect = vprot;
     memset( view->prot, vprot, size >> page_shift );
 
-    /* Insert it in the linked list */
+    /* Insert it in the tree and update the free ranges around it */
 
-    LIST_FOR_EACH( ptr, &views_list )
-    {
-        struct file_view *next = LIST_ENTRY( ptr, struct file_view, entry );
-        if (next->base > base) break;
-    }
-    list_add_before( ptr, &view->entry );
-
-    /* Check for overlapping views. This can happen if the previous view
-     * was a system view that got unmapped behind our back. In that case
-     * we recover by simply deleting it. */
-
-    if ((ptr = list_prev( &views_list, &view->entry )) != NULL)
-    {
-        struct file_view *prev = LIST_ENTRY( ptr, struct file_view, entry );
-        if ((char *)prev->base + prev->size > (char *)base)
-        {
-            TRACE( "overlapping prev view %p-%p for %p-%p\n",
-                   prev->base, (char *)prev->base + prev->size,
-                   base, (char *)base + view->size );
-            assert( prev->protect & VPROT_SYSTEM );
-            delete_view( prev );
-        }
-    }
-    if ((ptr = list_next( &views_list, &view->entry )) != NULL)
-    {
-        struct file_view *next = LIST_ENTRY( ptr, struct file_view, entry );
-        if ((char *)base + view->size > (char *)next->base)
-        {
-            TRACE( "overlapping next view %p-%p for %p-%p\n",
-                   next->base, (char *)next->base + next->size,
-                   base, (char *)base + view->size );
-            assert( next->protect & VPROT_SYSTEM );
-            delete_view( next );
-        }
-    }
+    wine_rb_put( &views_tree, view->base, &view->entry );
+    update_free_range( view );
+    if ((prev = wine_rb_prev( &view->entry )))
+        update_free_range( WINE_RB_ENTRY_VALUE( prev, struct file_view, entry ));
 
     *view_ret = view;
     VIRTUAL_DEBUG_DUMP_VIEW( view );
@@ -985,13 +1127,13 @@ static NTSTATUS allocate_dos_memory( struct file_view **view, unsigned int vprot
     void * const low_64k = (void *)0x10000;
     const size_t dosmem_size = 0x110000;
     int unix_prot = VIRTUAL_GetUnixProt( vprot );
-    struct list *ptr;
+    struct wine_rb_entry *ptr;
 
     /* check for existing view */
 
-    if ((ptr = list_head( &views_list )))
+    if ((ptr = wine_rb_head( views_tree.root )))
     {
-        struct file_view *first_view = LIST_ENTRY( ptr, struct file_view, entry );
+        struct file_view *first_view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
         if (first_view->base < (void *)dosmem_size) return STATUS_CONFLICTING_ADDRESSES;
     }
 
@@ -1753,7 +1895,7 @@ void VIRTUAL_SetForceExec( BOOL enable )
     {
         force_exec_prot = enable;
 
-        LIST_FOR_EACH_ENTRY( view, &views_list, struct file_view, entry )
+        WINE_RB_FOR_EACH_ENTRY( view, &views_tree, struct file_view, entry )
         {
             UINT i, count;
             char *addr = view->base;
@@ -2254,8 +2396,8 @@ NTSTATUS WINAPI NtQueryVirtualMemory( HANDLE process, LPCVOID addr,
                                       SIZE_T len, SIZE_T *res_len )
 {
     struct file_view *view;
-    char *base, *alloc_base = 0;
-    struct list *ptr;
+    char *base, *alloc_base = 0, *alloc_end = working_set_limit;
+    struct wine_rb_entry *ptr;
     SIZE_T size = 0;
     MEMORY_BASIC_INFORMATION *info = buffer;
     sigset_t sigset;
@@ -2311,31 +2453,31 @@ NTSTATUS WINAPI NtQueryVirtualMemory( HANDLE process, LPCVOID addr,
     /* Find the view containing the address */
 
     server_enter_uninterrupted_section( &csVirtual, &sigset );
-    ptr = list_head( &views_list );
-    for (;;)
+    ptr = views_tree.root;
+    view = NULL;
+    while (ptr)
     {
-        if (!ptr)
+        struct file_view *cur = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+
+        if ((char *)cur->base > base)
         {
-            size = (char *)working_set_limit - alloc_base;
-            view = NULL;
-            break;
+            alloc_end = cur->base;
+            ptr = ptr->left;
         }
-        view = LIST_ENTRY( ptr, struct file_view, entry );
-        if ((char *)view->base > base)
+        else if ((char *)cur->base + cur->size <= base)
         {
-            size = (char *)view->base - alloc_base;
-            view = NULL;
-            break;
+            alloc_base = (char *)cur->base + cur->size;
+            ptr = ptr->right;
         }
-        if ((char *)view->base + view->size > base)
+        else
         {
+            view = cur;
             alloc_base = view->base;
-            size = view->size;
+            alloc_end = (char *)view->base + view->size;
             break;
         }
-        alloc_base = (char *)view->base + view->size;
-        ptr = list_next( &views_list, ptr );
     }
+    size = alloc_end - alloc_base;
 
     /* Fill the info structure */
 
@@ -422,6 +422,7 @@ SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
  */
 DWORD WINAPI GetQueueStatus( UINT flags )
 {
+    const volatile struct queue_shm *shm = get_user_thread_info()->queue_shm;
     DWORD ret;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
@@ -432,6 +433,9 @@ DWORD WINAPI GetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    /* no need to ask the server if there are no changed bits to clear */
+    if (shm && !(shm->changed_bits & flags)) return MAKELONG( 0, shm->wake_bits & flags );
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -448,10 +452,13 @@ DWORD WINAPI GetQueueStatus( UINT flags )
  */
 BOOL WINAPI GetInputState(void)
 {
+    const volatile struct queue_shm *shm = get_user_thread_info()->queue_shm;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    if (shm) return shm->wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
@@ -284,6 +284,13 @@ struct send_message_info
 /* Message class descriptor */
 static const WCHAR messageW[] = {'M','e','s','s','a','g','e',0};
 
+/* maximum time between two get_message server calls, so that the server
+ * keeps considering the thread as responsive even if it never finds a message */
+#define MAX_QUEUE_SHM_IDLE 1000
+
+static const struct queue_shm *queue_shm_region;  /* shared region holding the queue states */
+static unsigned int queue_shm_count;               /* number of entries in the region */
+
 const struct builtin_class_descr MESSAGE_builtin_class =
 {
     messageW,             /* name */
@@ -2723,6 +2730,96 @@ static inline void call_sendmsg_callback( SENDASYNCPROC callback, HWND hwnd, UIN
 }
 
 
+/***********************************************************************
+ *           map_queue_shm_region
+ *
+ * Map the shared region holding the queue states, if the server provides it.
+ */
+static BOOL map_queue_shm_region(void)
+{
+    HANDLE handle = 0;
+    SIZE_T size = 0;
+    void *ptr;
+    NTSTATUS ret;
+
+    if (queue_shm_region) return TRUE;
+
+    SERVER_START_REQ( get_queue_shm_region )
+    {
+        if (!(ret = wine_server_call( req )))
+        {
+            handle = wine_server_ptr_handle( reply->handle );
+            size = reply->size;
+        }
+    }
+    SERVER_END_REQ;
+    if (ret) return FALSE;
+
+    ptr = MapViewOfFile( handle, FILE_MAP_READ, 0, 0, size );
+    CloseHandle( handle );
+    if (!ptr) return FALSE;
+
+    queue_shm_count = size / sizeof(struct queue_shm);
+    if (InterlockedCompareExchangePointer( (void **)&queue_shm_region, ptr, NULL ))
+        UnmapViewOfFile( ptr );  /* another thread mapped it first */
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           get_server_queue_handle
+ *
+ * Get a handle to the server message queue for the current thread.
+ */
+static HANDLE get_server_queue_handle(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    HANDLE ret;
+
+    if (!(ret = thread_info->server_queue))
+    {
+        int shm_index = -1;
+
+        SERVER_START_REQ( get_msg_queue )
+        {
+            wine_server_call( req );
+            ret = wine_server_ptr_handle( reply->handle );
+            shm_index = reply->shm_index;
+        }
+        SERVER_END_REQ;
+        thread_info->server_queue = ret;
+        if (!ret) ERR( "Cannot get server thread queue\n" );
+        else if (shm_index != -1 && map_queue_shm_region() && shm_index < queue_shm_count)
+            thread_info->queue_shm = &queue_shm_region[shm_index];
+    }
+    return ret;
+}
+
+
+/***********************************************************************
+ *           queue_shm_is_empty
+ *
+ * Check in the shared queue state if a get_message call would find nothing.
+ * This is only reliable if the server already has the same wake masks, since
+ * the server doesn't get a chance to update them here.
+ */
+static BOOL queue_shm_is_empty( struct user_thread_info *thread_info, UINT flags, UINT changed_mask )
+{
+    const volatile struct queue_shm *shm = thread_info->queue_shm;
+    unsigned int filter = flags >> 16, bits;
+
+    if (!shm) return FALSE;
+    if (thread_info->wake_mask != (changed_mask & (QS_SENDMESSAGE | QS_SMRESULT))) return FALSE;
+    if (thread_info->changed_mask != changed_mask) return FALSE;
+    if (GetTickCount() - thread_info->last_get_msg >= MAX_QUEUE_SHM_IDLE) return FALSE;
+
+    if (!filter) filter = QS_ALLINPUT;
+    bits = filter | QS_SENDMESSAGE;
+    if (filter & QS_POSTMESSAGE) bits |= QS_ALLPOSTMESSAGE | QS_HOTKEY | QS_TIMER;
+    return !((shm->wake_bits | shm->changed_bits) & bits);
+}
+
+
 /***********************************************************************
  *           peek_message
  *
@@ -2738,6 +2835,8 @@ static BOOL peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags
     void *buffer;
     size_t buffer_size = 256;
 
+    if (queue_shm_is_empty( thread_info, flags, changed_mask )) return FALSE;
+
     if (!(buffer = HeapAlloc( GetProcessHeap(), 0, buffer_size ))) return FALSE;
 
     if (!first && !last) last = ~0;
@@ -2776,6 +2875,7 @@ static BOOL peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags
             else buffer_size = reply->total;
         }
         SERVER_END_REQ;
+        thread_info->last_get_msg = GetTickCount();
 
         if (res)
         {
@@ -2784,6 +2884,8 @@ static BOOL peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags
             {
                 thread_info->wake_mask = changed_mask & (QS_SENDMESSAGE | QS_SMRESULT);
                 thread_info->changed_mask = changed_mask;
+                /* make sure the shared queue state is available for the next call */
+                if (!thread_info->server_queue) get_server_queue_handle();
             }
             if (res != STATUS_BUFFER_OVERFLOW) return FALSE;
             if (!(buffer = HeapAlloc( GetProcessHeap(), 0, buffer_size ))) return FALSE;
@@ -2975,31 +3077,6 @@ static inline void process_sent_messages(void)
 }
 
 
-/***********************************************************************
- *           get_server_queue_handle
- *
- * Get a handle to the server message queue for the current thread.
- */
-static HANDLE get_server_queue_handle(void)
-{
-    struct user_thread_info *thread_info = get_user_thread_info();
-    HANDLE ret;
-
-    if (!(ret = thread_info->server_queue))
-    {
-        SERVER_START_REQ( get_msg_queue )
-        {
-            wine_server_call( req );
-            ret = wine_server_ptr_handle( reply->handle );
-        }
-        SERVER_END_REQ;
-        thread_info->server_queue = ret;
-        if (!ret) ERR( "Cannot get server thread queue\n" );
-    }
-    return ret;
-}
-
-
 /***********************************************************************
  *           wait_message_reply
  *
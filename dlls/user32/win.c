@@ -47,6 +47,10 @@ static DWORD process_layout = ~0u;
 
 static struct list window_surfaces = LIST_INIT( window_surfaces );
 
+static const struct window_shm *window_shm_region;  /* shared region holding the window states */
+static unsigned int window_shm_count;               /* number of entries in the region */
+static BOOL window_shm_disabled;                    /* the server doesn't provide the region */
+
 static CRITICAL_SECTION surfaces_section;
 static CRITICAL_SECTION_DEBUG critsect_debug =
 {
@@ -629,6 +633,165 @@ WND *WIN_GetPtr( HWND hwnd )
 }
 
 
+/***********************************************************************
+ *           map_window_shm_region
+ *
+ * Map the shared region holding the window states, if the server provides it.
+ */
+static BOOL map_window_shm_region(void)
+{
+    HANDLE handle = 0;
+    SIZE_T size = 0;
+    void *ptr;
+    NTSTATUS ret;
+
+    if (window_shm_region) return TRUE;
+    if (window_shm_disabled) return FALSE;
+
+    SERVER_START_REQ( get_window_shm_region )
+    {
+        if (!(ret = wine_server_call( req )))
+        {
+            handle = wine_server_ptr_handle( reply->handle );
+            size = reply->size;
+        }
+    }
+    SERVER_END_REQ;
+
+    if (ret || !(ptr = MapViewOfFile( handle, FILE_MAP_READ, 0, 0, size )))
+    {
+        if (handle) CloseHandle( handle );
+        window_shm_disabled = TRUE;
+        return FALSE;
+    }
+    CloseHandle( handle );
+
+    window_shm_count = size / sizeof(struct window_shm);
+    if (InterlockedCompareExchangePointer( (void **)&window_shm_region, ptr, NULL ))
+        UnmapViewOfFile( ptr );  /* another thread mapped it first */
+    return TRUE;
+}
+
+
+/* make sure that the shared entry is read between the two sequence counter reads */
+static inline void shared_read_barrier(void)
+{
+#ifdef __GNUC__
+    __sync_synchronize();
+#endif
+}
+
+
+/***********************************************************************
+ *           get_shared_window
+ *
+ * Retrieve the state of a window of another thread or process from the
+ * region shared with the server. Return FALSE if the region isn't available;
+ * otherwise info->handle is set to 0 if the handle isn't a valid window.
+ */
+static BOOL get_shared_window( HWND hwnd, struct window_shm *info )
+{
+    const volatile struct window_shm *shm;
+    user_handle_t handle = wine_server_user_handle( hwnd );
+    unsigned int index = (LOWORD(handle) - FIRST_USER_HANDLE) >> 1;
+    unsigned int seq;
+
+    if (!map_window_shm_region()) return FALSE;
+
+    info->handle = 0;
+    if (LOWORD(handle) < FIRST_USER_HANDLE || index >= window_shm_count) return TRUE;
+
+    shm = &window_shm_region[index];
+    for (;;)
+    {
+        if (!((seq = shm->seq) & 1))
+        {
+            shared_read_barrier();
+            *info = *(const struct window_shm *)shm;
+            shared_read_barrier();
+            if (shm->seq == seq) break;
+        }
+        SwitchToThread();  /* the server is updating the entry */
+    }
+
+    /* same validation as the server for handles with a generation */
+    if (HIWORD(handle) && HIWORD(handle) != 0xffff && handle != info->handle) info->handle = 0;
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           get_shared_window_rects
+ *
+ * Compute the window rectangles from the shared window states, like the
+ * get_window_rectangles server request. Return FALSE if it can't be done.
+ */
+static BOOL get_shared_window_rects( const struct window_shm *info, enum coords_relative relative,
+                                     RECT *rectWindow, RECT *rectClient )
+{
+    RECT window_rect, client_rect, parent_client;
+    struct window_shm parent;
+    user_handle_t handle;
+    int depth = 0;
+
+    SetRect( &window_rect, info->window.left, info->window.top, info->window.right, info->window.bottom );
+    SetRect( &client_rect, info->client.left, info->client.top, info->client.right, info->client.bottom );
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        OffsetRect( &window_rect, -info->client.left, -info->client.top );
+        OffsetRect( &client_rect, -info->client.left, -info->client.top );
+        if (info->ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &parent_client, info->client.left, info->client.top,
+                     info->client.right, info->client.bottom );
+            mirror_rect( &parent_client, &window_rect );
+        }
+        break;
+    case COORDS_WINDOW:
+        OffsetRect( &window_rect, -info->window.left, -info->window.top );
+        OffsetRect( &client_rect, -info->window.left, -info->window.top );
+        if (info->ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &parent_client, info->window.left, info->window.top,
+                     info->window.right, info->window.bottom );
+            mirror_rect( &parent_client, &client_rect );
+        }
+        break;
+    case COORDS_PARENT:
+        if (!info->parent) break;
+        if (!get_shared_window( wine_server_ptr_handle( info->parent ), &parent ) || !parent.handle)
+            return FALSE;
+        if (parent.ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &parent_client, parent.client.left, parent.client.top,
+                     parent.client.right, parent.client.bottom );
+            mirror_rect( &parent_client, &window_rect );
+            mirror_rect( &parent_client, &client_rect );
+        }
+        break;
+    case COORDS_SCREEN:
+        for (handle = info->parent; handle; handle = parent.parent)
+        {
+            /* the tree may be modified while we walk it, let the server handle that */
+            if (++depth > 256) return FALSE;
+            if (!get_shared_window( wine_server_ptr_handle( handle ), &parent ) || !parent.handle)
+                return FALSE;
+            if (!parent.parent) break;  /* desktop window */
+            OffsetRect( &window_rect, parent.client.left, parent.client.top );
+            OffsetRect( &client_rect, parent.client.left, parent.client.top );
+        }
+        break;
+    default:
+        return FALSE;
+    }
+    if (rectWindow) *rectWindow = window_rect;
+    if (rectClient) *rectClient = client_rect;
+    return TRUE;
+}
+
+
 /***********************************************************************
  *           WIN_IsCurrentProcess
  *
@@ -710,6 +873,14 @@ HWND WIN_GetFullHandle( HWND hwnd )
     }
     else  /* may belong to another process */
     {
+        struct window_shm info;
+
+        if (get_shared_window( hwnd, &info ))
+        {
+            if (info.handle) hwnd = wine_server_ptr_handle( info.handle );
+            else SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+            return hwnd;
+        }
         SERVER_START_REQ( get_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -915,6 +1086,20 @@ BOOL WIN_GetRectangles( HWND hwnd, enum coords_relative relative, RECT *rectWind
     }
 
 other_process:
+    {
+        struct window_shm info;
+
+        if (get_shared_window( hwnd, &info ))
+        {
+            if (!info.handle)
+            {
+                SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+                return FALSE;
+            }
+            if (get_shared_window_rects( &info, relative, rectWindow, rectClient )) return TRUE;
+        }
+    }
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -2253,11 +2438,31 @@ static LONG_PTR WIN_GetWindowLong( HWND hwnd, INT offset, UINT size, BOOL unicod
 
     if (wndPtr == WND_OTHER_PROCESS)
     {
+        struct window_shm info;
+
         if (offset == GWLP_WNDPROC)
         {
             SetLastError( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if (offset < 0 && get_shared_window( hwnd, &info ))
+        {
+            if (!info.handle)
+            {
+                SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+                return 0;
+            }
+            switch(offset)
+            {
+            case GWL_STYLE:      return info.style;
+            case GWL_EXSTYLE:    return info.ex_style;
+            case GWLP_ID:        return info.id;
+            case GWLP_HINSTANCE: return (ULONG_PTR)wine_server_get_ptr( info.instance );
+            case GWLP_USERDATA:  return info.user_data;
+            }
+            SetLastError( ERROR_INVALID_INDEX );
+            return 0;
+        }
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -2844,6 +3049,7 @@ INT WINAPI GetWindowTextLengthW( HWND hwnd )
  */
 BOOL WINAPI IsWindow( HWND hwnd )
 {
+    struct window_shm info;
     WND *ptr;
     BOOL ret;
 
@@ -2857,6 +3063,11 @@ BOOL WINAPI IsWindow( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_shared_window( hwnd, &info ))
+    {
+        if (!info.handle) SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+        return info.handle != 0;
+    }
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -2872,6 +3083,7 @@ BOOL WINAPI IsWindow( HWND hwnd )
  */
 DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
 {
+    struct window_shm info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -2891,6 +3103,16 @@ DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
     }
 
     /* check other processes */
+    if (get_shared_window( hwnd, &info ))
+    {
+        if (!info.handle)
+        {
+            SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+            return 0;
+        }
+        if (process) *process = info.pid;
+        return info.tid;
+    }
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -2910,6 +3132,7 @@ DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
  */
 HWND WINAPI GetParent( HWND hwnd )
 {
+    struct window_shm info;
     WND *wndPtr;
     HWND retvalue = 0;
 
@@ -2919,7 +3142,13 @@ HWND WINAPI GetParent( HWND hwnd )
         return 0;
     }
     if (wndPtr == WND_DESKTOP) return 0;
-    if (wndPtr == WND_OTHER_PROCESS)
+    if (wndPtr == WND_OTHER_PROCESS && get_shared_window( hwnd, &info ))
+    {
+        if (!info.handle) SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+        else if (info.style & WS_POPUP) retvalue = wine_server_ptr_handle( info.owner );
+        else if (info.style & WS_CHILD) retvalue = wine_server_ptr_handle( info.parent );
+    }
+    else if (wndPtr == WND_OTHER_PROCESS)
     {
         LONG style = GetWindowLongW( hwnd, GWL_STYLE );
         if (style & (WS_POPUP | WS_CHILD))
@@ -2951,6 +3180,7 @@ HWND WINAPI GetParent( HWND hwnd )
  */
 HWND WINAPI GetAncestor( HWND hwnd, UINT type )
 {
+    struct window_shm info;
     WND *win;
     HWND *list, ret = 0;
 
@@ -2968,6 +3198,11 @@ HWND WINAPI GetAncestor( HWND hwnd, UINT type )
             ret = win->parent;
             WIN_ReleasePtr( win );
         }
+        else if (get_shared_window( hwnd, &info ))
+        {
+            if (info.handle) ret = wine_server_ptr_handle( info.parent );
+            else SetLastError( ERROR_INVALID_WINDOW_HANDLE );
+        }
         else /* need to query the server */
         {
             SERVER_START_REQ( get_window_tree )
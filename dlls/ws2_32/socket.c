@@ -64,6 +64,9 @@
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
+#ifdef HAVE_SYS_SENDFILE_H
+# include <sys/sendfile.h>
+#endif
 #ifdef HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
 #endif
@@ -502,6 +505,7 @@ struct ws2_async
     DWORD                               flags;
     DWORD                              *lpFlags;
     WSABUF                             *control;
+    int                                 batch_result; /* result retrieved by a batch function, or -1 */
     unsigned int                        n_iovecs;
     unsigned int                        first_iovec;
     struct iovec                        iovec[1];
@@ -529,6 +533,7 @@ struct ws2_transmitfile_async
     DWORD                 file_read;
     DWORD                 file_bytes;
     DWORD                 bytes_per_send;
+    BOOL                  use_sendfile;
     TRANSMIT_FILE_BUFFERS buffers;
     DWORD                 flags;
     LARGE_INTEGER         offset;
@@ -604,6 +609,23 @@ typedef struct          /* WSAAsyncSelect() control struct */
 #define WS_MAX_UDP_DATAGRAM             1024
 static INT WINAPI WSA_DefaultBlockingHook( FARPROC x );
 
+/* cached state of a socket used in select() */
+struct poll_cache_entry
+{
+    SOCKET       socket;
+    int          fd;
+    LONG         generation;
+    unsigned int flags;
+};
+
+#define POLL_CACHE_BOUND      0x01  /* socket is bound */
+#define POLL_CACHE_TYPE_KNOWN 0x02  /* socket type has been retrieved */
+#define POLL_CACHE_DGRAM      0x04  /* socket is a datagram socket */
+#define POLL_CACHE_OOB_KNOWN  0x08  /* SO_OOBINLINE has been retrieved */
+#define POLL_CACHE_OOBINLINE  0x10  /* SO_OOBINLINE is set */
+
+#define POLL_CACHE_GENERATIONS 1024  /* number of socket handle generation counters */
+
 /* hostent's, servent's and protent's are stored in one buffer per thread,
  * as documented on MSDN for the functions that return any of the buffers */
 struct per_thread_data
@@ -614,6 +636,9 @@ struct per_thread_data
     struct WS_protoent *pe_buffer;
     struct pollfd *fd_cache;
     unsigned int fd_count;
+    struct poll_cache_entry *poll_cache;
+    unsigned int poll_cache_size;
+    unsigned int poll_cache_used;
     int he_len;
     int se_len;
     int pe_len;
@@ -628,8 +653,23 @@ struct route {
 };
 
 static INT num_startup;          /* reference counter */
+/* generation counters of the socket handles, incremented to invalidate the poll
+ * cache entries of a handle when a socket appears with it, since it may reuse the
+ * handle and fd of a closed one; handles are spread over the counters by value */
+static LONG poll_cache_generations[POLL_CACHE_GENERATIONS];
 static FARPROC blocking_hook = (FARPROC)WSA_DefaultBlockingHook;
 
+static inline LONG *get_poll_cache_generation( SOCKET s )
+{
+    return &poll_cache_generations[(s >> 2) & (POLL_CACHE_GENERATIONS - 1)];
+}
+
+/* discard the poll state cached for a socket handle */
+static inline void invalidate_poll_cache( SOCKET s )
+{
+    InterlockedIncrement( get_poll_cache_generation( s ));
+}
+
 /* function prototypes */
 static struct WS_hostent *WS_create_he(char *name, int aliases, int aliases_size, int addresses, int address_length);
 static struct WS_hostent *WS_dup_he(const struct hostent* p_he);
@@ -1302,6 +1342,7 @@ static void free_per_thread_data(void)
     HeapFree( GetProcessHeap(), 0, ptb->se_buffer );
     HeapFree( GetProcessHeap(), 0, ptb->pe_buffer );
     HeapFree( GetProcessHeap(), 0, ptb->fd_cache );
+    HeapFree( GetProcessHeap(), 0, ptb->poll_cache );
 
     HeapFree( GetProcessHeap(), 0, ptb );
     NtCurrentTeb()->WinSockData = NULL;
@@ -2404,6 +2445,13 @@ static NTSTATUS WS2_async_recv( void *user, IO_STATUS_BLOCK *iosb, NTSTATUS stat
     struct ws2_async *wsa = user;
     int result = 0, fd;
 
+    if (wsa->batch_result >= 0)
+    {
+        /* the data has already been received by WS2_async_recv_batch */
+        result = wsa->batch_result;
+        status = STATUS_SUCCESS;
+    }
+
     switch (status)
     {
     case STATUS_ALERTED:
@@ -2442,6 +2490,60 @@ static NTSTATUS WS2_async_recv( void *user, IO_STATUS_BLOCK *iosb, NTSTATUS stat
     return status;
 }
 
+/* maximum number of messages transferred by a batch function */
+#define MAX_BATCH_MESSAGES 64
+
+/***********************************************************************
+ *              WS2_async_recv_batch    (INTERNAL)
+ *
+ * Receive the datagrams of several queued overlapped recv() operations
+ * with a single system call.
+ */
+static void CDECL WS2_async_recv_batch( int fd, void **users, unsigned int count )
+{
+#ifdef HAVE_RECVMMSG
+    union generic_unix_sockaddr addrs[MAX_BATCH_MESSAGES];
+    struct mmsghdr msgs[MAX_BATCH_MESSAGES];
+    struct ws2_async *wsa;
+    unsigned int i;
+    int n;
+
+    if (_get_fd_type( fd ) != SOCK_DGRAM) return;
+
+    for (i = 0; i < count && i < MAX_BATCH_MESSAGES; i++)
+    {
+        wsa = users[i];
+        /* flags and control headers are left to WS2_recv */
+        if (wsa->flags || wsa->control) break;
+
+        memset( &msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr) );
+        if (wsa->addr)
+        {
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        }
+        msgs[i].msg_hdr.msg_iov = wsa->iovec + wsa->first_iovec;
+        msgs[i].msg_hdr.msg_iovlen = wsa->n_iovecs - wsa->first_iovec;
+    }
+    if (i < 2) return;
+
+    while ((n = recvmmsg( fd, msgs, i, MSG_DONTWAIT, NULL )) == -1)
+    {
+        /* errors are reported by WS2_recv for the first operation */
+        if (errno != EINTR) return;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        wsa = users[i];
+        if (wsa->addr && msgs[i].msg_hdr.msg_namelen)
+            ws_sockaddr_u2ws( &addrs[i].addr, wsa->addr, wsa->addrlen.ptr );
+        wsa->batch_result = msgs[i].msg_len;
+    }
+    if (n) _enable_event( wsa->hSocket, FD_READ, 0, 0 );
+#endif
+}
+
 /***********************************************************************
  *              WS2_async_accept_recv            (INTERNAL)
  *
@@ -2485,6 +2587,8 @@ static NTSTATUS WS2_async_accept( void *user, IO_STATUS_BLOCK *iosb, NTSTATUS st
             status = wine_server_call( req );
         }
         SERVER_END_REQ;
+        /* the accepting socket now uses a different unix socket */
+        if (!status) invalidate_poll_cache( HANDLE2SOCKET( wsa->accept_socket ));
 
         if (status == STATUS_CANT_WAIT)
             return STATUS_PENDING;
@@ -2617,6 +2721,13 @@ static NTSTATUS WS2_async_send( void *user, IO_STATUS_BLOCK *iosb, NTSTATUS stat
     struct ws2_async *wsa = user;
     int result = 0, fd;
 
+    if (wsa->batch_result >= 0)
+    {
+        /* the data has already been sent by WS2_async_send_batch */
+        iosb->Information += wsa->batch_result;
+        status = STATUS_SUCCESS;
+    }
+
     switch (status)
     {
     case STATUS_ALERTED:
@@ -2661,6 +2772,58 @@ static NTSTATUS WS2_async_send( void *user, IO_STATUS_BLOCK *iosb, NTSTATUS stat
     return status;
 }
 
+/***********************************************************************
+ *              WS2_async_send_batch    (INTERNAL)
+ *
+ * Send the datagrams of several queued overlapped send() operations
+ * with a single system call.
+ */
+static void CDECL WS2_async_send_batch( int fd, void **users, unsigned int count )
+{
+#ifdef HAVE_SENDMMSG
+    union generic_unix_sockaddr addrs[MAX_BATCH_MESSAGES];
+    struct mmsghdr msgs[MAX_BATCH_MESSAGES];
+    struct ws2_async *wsa, *first = users[0];
+    unsigned int i;
+    int n;
+
+    if (_get_fd_type( fd ) != SOCK_DGRAM) return;
+
+    for (i = 0; i < count && i < MAX_BATCH_MESSAGES; i++)
+    {
+        wsa = users[i];
+        if (wsa->flags != first->flags || wsa->first_iovec >= wsa->n_iovecs) break;
+
+        memset( &msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr) );
+        if (wsa->addr)
+        {
+            /* IPX needs the packet type set by WS2_send */
+            if (wsa->addr->sa_family == WS_AF_IPX) break;
+            if (!(msgs[i].msg_hdr.msg_namelen = ws_sockaddr_ws2u( wsa->addr, wsa->addrlen.val, &addrs[i] )))
+                break;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+        }
+        msgs[i].msg_hdr.msg_iov = wsa->iovec + wsa->first_iovec;
+        msgs[i].msg_hdr.msg_iovlen = wsa->n_iovecs - wsa->first_iovec;
+    }
+    if (i < 2) return;
+
+    while ((n = sendmmsg( fd, msgs, i, convert_flags( first->flags ) | MSG_DONTWAIT )) == -1)
+    {
+        /* errors are reported by WS2_send for the first operation */
+        if (errno != EINTR) return;
+    }
+
+    /* datagrams are sent as a whole */
+    for (i = 0; i < n; i++)
+    {
+        wsa = users[i];
+        wsa->first_iovec = wsa->n_iovecs;
+        wsa->batch_result = msgs[i].msg_len;
+    }
+#endif
+}
+
 /***********************************************************************
  *              WS2_async_shutdown      (INTERNAL)
  *
@@ -2747,6 +2910,7 @@ SOCKET WINAPI WS_accept(SOCKET s, struct WS_sockaddr *addr, int *addrlen32)
         SERVER_END_REQ;
         if (!status)
         {
+            invalidate_poll_cache( as );
             if (addr && addrlen32 && WS_getpeername(as, addr, addrlen32))
             {
                 WS_closesocket(as);
@@ -2853,6 +3017,7 @@ static BOOL WINAPI WS2_AcceptEx(SOCKET listener, SOCKET acceptor, PVOID dest, DW
         wsa->read->addr        = NULL;
         wsa->read->addrlen.ptr = NULL;
         wsa->read->control     = NULL;
+        wsa->read->batch_result = -1;
         wsa->read->n_iovecs    = 1;
         wsa->read->first_iovec = 0;
         wsa->read->completion_func = NULL;
@@ -2920,6 +3085,64 @@ static NTSTATUS WS2_ReadFile(HANDLE hFile, PIO_STATUS_BLOCK io_status, char* buf
     return status;
 }
 
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+/***********************************************************************
+ *     WS2_transmitfile_sendfile        (INTERNAL)
+ *
+ * Send the file data directly from the file with sendfile(), without
+ * copying it through the transfer buffer.
+ * Returns STATUS_NOT_SUPPORTED if the buffer must be used instead.
+ */
+static NTSTATUS WS2_transmitfile_sendfile( int fd, struct ws2_transmitfile_async *wsa )
+{
+    IO_STATUS_BLOCK *iosb = (IO_STATUS_BLOCK *)wsa->write.user_overlapped;
+    size_t count = 0x7ffff000;  /* max size of a single sendfile() transfer on Linux */
+    off_t offset, *poffset = NULL;
+    ssize_t n;
+    int file_fd;
+
+    if (wine_server_handle_to_fd( wsa->file, FILE_READ_DATA, &file_fd, NULL ))
+    {
+        wsa->use_sendfile = FALSE;
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    /* when the size of the transfer is limited ensure that we don't go past that limit */
+    if (wsa->file_bytes != 0)
+        count = min(count, wsa->file_bytes - wsa->file_read);
+    if (wsa->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+    {
+        offset = wsa->offset.QuadPart;
+        poffset = &offset;
+    }
+    while ((n = sendfile( fd, file_fd, poffset, count )) == -1 && errno == EINTR);
+    wine_server_release_fd( wsa->file, file_fd );
+
+    if (n > 0)
+    {
+        if (poffset) wsa->offset.QuadPart += n;
+        if (iosb) iosb->Information += n;
+        wsa->file_read += n;
+        if (wsa->file_bytes != 0 && wsa->file_read >= wsa->file_bytes)
+            wsa->file = NULL;
+        return STATUS_PENDING;
+    }
+    if (!n)
+    {
+        wsa->file = NULL; /* continue on to the footer */
+        return STATUS_SUCCESS;
+    }
+    if (errno == EAGAIN) return STATUS_PENDING;
+    if (errno == EINVAL || errno == ENOSYS)
+    {
+        /* the file doesn't support sendfile(), fall back to reading it */
+        wsa->use_sendfile = FALSE;
+        return STATUS_NOT_SUPPORTED;
+    }
+    return wsaErrStatus();
+}
+#endif
+
 /***********************************************************************
  *     WS2_transmitfile_getbuffer       (INTERNAL)
  *
@@ -2942,6 +3165,15 @@ static NTSTATUS WS2_transmitfile_getbuffer( int fd, struct ws2_transmitfile_asyn
         return STATUS_PENDING;
     }
 
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    if (wsa->file && wsa->use_sendfile)
+    {
+        NTSTATUS status = WS2_transmitfile_sendfile( fd, wsa );
+        if (status != STATUS_SUCCESS && status != STATUS_NOT_SUPPORTED)
+            return status;
+    }
+#endif
+
     /* process the main file */
     if (wsa->file)
     {
@@ -3002,7 +3234,7 @@ static NTSTATUS WS2_transmitfile_base( int fd, struct ws2_transmitfile_async *ws
     NTSTATUS status;
 
     status = WS2_transmitfile_getbuffer( fd, wsa );
-    if (status == STATUS_PENDING)
+    if (status == STATUS_PENDING && wsa->write.first_iovec < wsa->write.n_iovecs)
     {
         IO_STATUS_BLOCK *iosb = (IO_STATUS_BLOCK *)wsa->write.user_overlapped;
         int n;
@@ -3104,6 +3336,7 @@ static BOOL WINAPI WS2_TransmitFile( SOCKET s, HANDLE h, DWORD file_bytes, DWORD
     wsa->file_read             = 0;
     wsa->file_bytes            = file_bytes;
     wsa->bytes_per_send        = bytes_per_send;
+    wsa->use_sendfile          = TRUE;
     wsa->flags                 = flags;
     wsa->offset.QuadPart       = FILE_USE_FILE_POINTER_POSITION;
     wsa->write.hSocket         = SOCKET2HANDLE(s);
@@ -3574,6 +3807,7 @@ static BOOL WINAPI WS2_ConnectEx(SOCKET s, const struct WS_sockaddr* name, int n
             wsa->flags       = 0;
             wsa->lpFlags     = &wsa->flags;
             wsa->control     = NULL;
+            wsa->batch_result = -1;
             wsa->n_iovecs    = sendBuf ? 1 : 0;
             wsa->first_iovec = 0;
             wsa->completion_func = NULL;
@@ -5150,6 +5384,105 @@ int WINAPI WS_recvfrom(SOCKET s, char *buf, INT len, int flags,
         return n;
 }
 
+/* make sure the per-thread poll array can hold count descriptors */
+static struct pollfd *get_poll_array( struct per_thread_data *ptb, unsigned int count )
+{
+    struct pollfd *fds;
+
+    if (ptb->fd_count >= count) return ptb->fd_cache;
+
+    if (!(fds = HeapAlloc( GetProcessHeap(), 0, count * sizeof(fds[0]) ))) return NULL;
+    HeapFree( GetProcessHeap(), 0, ptb->fd_cache );
+    ptb->fd_cache = fds;
+    ptb->fd_count = count;
+    return fds;
+}
+
+static inline unsigned int hash_poll_socket( SOCKET s )
+{
+    return (unsigned int)(s >> 2) * 0x9e3779b1;
+}
+
+/* find the poll cache entry of a socket, creating it if needed */
+/* returns NULL only on allocation failure, in which case nothing is cached */
+static struct poll_cache_entry *get_poll_cache_entry( struct per_thread_data *ptb, SOCKET s, int fd )
+{
+    LONG generation = *get_poll_cache_generation( s );
+    struct poll_cache_entry *entry;
+    unsigned int i, mask;
+
+    if ((ptb->poll_cache_used + 1) * 2 > ptb->poll_cache_size)
+    {
+        unsigned int size = max( 64, ptb->poll_cache_size * 2 );
+        struct poll_cache_entry *cache;
+
+        if (!(cache = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size * sizeof(*cache) ))) return NULL;
+        for (i = 0; i < ptb->poll_cache_size; i++)
+        {
+            unsigned int j;
+
+            if (!ptb->poll_cache[i].socket) continue;
+            for (j = hash_poll_socket( ptb->poll_cache[i].socket ) & (size - 1);
+                 cache[j].socket; j = (j + 1) & (size - 1)) ;
+            cache[j] = ptb->poll_cache[i];
+        }
+        HeapFree( GetProcessHeap(), 0, ptb->poll_cache );
+        ptb->poll_cache = cache;
+        ptb->poll_cache_size = size;
+    }
+
+    mask = ptb->poll_cache_size - 1;
+    for (i = hash_poll_socket( s ) & mask;; i = (i + 1) & mask)
+    {
+        entry = &ptb->poll_cache[i];
+        if (entry->socket == s) break;
+        if (entry->socket) continue;
+        entry->socket = s;
+        entry->flags = 0;
+        ptb->poll_cache_used++;
+        break;
+    }
+    if (entry->fd != fd || entry->generation != generation)
+    {
+        /* a socket was created with this handle since the entry was filled */
+        entry->fd = fd;
+        entry->generation = generation;
+        entry->flags = 0;
+    }
+    return entry;
+}
+
+/* check if a socket is bound; only a positive result is cached, since it can't change back */
+static BOOL poll_cache_is_bound( struct poll_cache_entry *entry, int fd )
+{
+    if (entry && (entry->flags & POLL_CACHE_BOUND)) return TRUE;
+    if (is_fd_bound( fd, NULL, NULL ) != 1) return FALSE;
+    if (entry) entry->flags |= POLL_CACHE_BOUND;
+    return TRUE;
+}
+
+static BOOL poll_cache_is_dgram( struct poll_cache_entry *entry, int fd )
+{
+    if (!entry) return _get_fd_type( fd ) == SOCK_DGRAM;
+    if (!(entry->flags & POLL_CACHE_TYPE_KNOWN))
+    {
+        entry->flags |= POLL_CACHE_TYPE_KNOWN;
+        if (_get_fd_type( fd ) == SOCK_DGRAM) entry->flags |= POLL_CACHE_DGRAM;
+    }
+    return (entry->flags & POLL_CACHE_DGRAM) != 0;
+}
+
+static BOOL poll_cache_is_oobinline( struct poll_cache_entry *entry, int fd )
+{
+    int oob_inlined = 0;
+    socklen_t olen = sizeof(oob_inlined);
+
+    if (entry && (entry->flags & POLL_CACHE_OOB_KNOWN)) return (entry->flags & POLL_CACHE_OOBINLINE) != 0;
+    getsockopt( fd, SOL_SOCKET, SO_OOBINLINE, (char *)&oob_inlined, &olen );
+    if (entry) entry->flags |= POLL_CACHE_OOB_KNOWN | (oob_inlined ? POLL_CACHE_OOBINLINE : 0);
+    return oob_inlined != 0;
+}
+
 /* allocate a poll array for the corresponding fd sets */
 static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set *writefds,
                                        const WS_fd_set *exceptfds, int *count_ptr )
@@ -5157,6 +5490,7 @@ static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set
     unsigned int i, j = 0, count = 0;
     struct pollfd *fds;
     struct per_thread_data *ptb = get_per_thread_data();
+    struct poll_cache_entry *entry;
 
     if (readfds) count += readfds->fd_count;
     if (writefds) count += writefds->fd_count;
@@ -5169,19 +5503,11 @@ static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set
     }
 
     /* check if the cache can hold all descriptors, if not do the resizing */
-    if (ptb->fd_count < count)
+    if (!(fds = get_poll_array( ptb, count )))
     {
-        if (!(fds = HeapAlloc(GetProcessHeap(), 0, count * sizeof(fds[0]))))
-        {
-            SetLastError( ERROR_NOT_ENOUGH_MEMORY );
-            return NULL;
-        }
-        HeapFree(GetProcessHeap(), 0, ptb->fd_cache);
-        ptb->fd_cache = fds;
-        ptb->fd_count = count;
+        SetLastError( ERROR_NOT_ENOUGH_MEMORY );
+        return NULL;
     }
-    else
-        fds = ptb->fd_cache;
 
     if (readfds)
         for (i = 0; i < readfds->fd_count; i++, j++)
@@ -5189,7 +5515,8 @@ static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set
             fds[j].fd = get_sock_fd( readfds->fd_array[i], FILE_READ_DATA, NULL );
             if (fds[j].fd == -1) goto failed;
             fds[j].revents = 0;
-            if (is_fd_bound(fds[j].fd, NULL, NULL) == 1)
+            entry = get_poll_cache_entry( ptb, readfds->fd_array[i], fds[j].fd );
+            if (poll_cache_is_bound( entry, fds[j].fd ))
             {
                 fds[j].events = POLLIN;
             }
@@ -5206,8 +5533,8 @@ static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set
             fds[j].fd = get_sock_fd( writefds->fd_array[i], FILE_WRITE_DATA, NULL );
             if (fds[j].fd == -1) goto failed;
             fds[j].revents = 0;
-            if (is_fd_bound(fds[j].fd, NULL, NULL) == 1 ||
-                _get_fd_type(fds[j].fd) == SOCK_DGRAM)
+            entry = get_poll_cache_entry( ptb, writefds->fd_array[i], fds[j].fd );
+            if (poll_cache_is_bound( entry, fds[j].fd ) || poll_cache_is_dgram( entry, fds[j].fd ))
             {
                 fds[j].events = POLLOUT;
             }
@@ -5224,16 +5551,13 @@ static struct pollfd *fd_sets_to_poll( const WS_fd_set *readfds, const WS_fd_set
             fds[j].fd = get_sock_fd( exceptfds->fd_array[i], 0, NULL );
             if (fds[j].fd == -1) goto failed;
             fds[j].revents = 0;
-            if (is_fd_bound(fds[j].fd, NULL, NULL) == 1)
+            entry = get_poll_cache_entry( ptb, exceptfds->fd_array[i], fds[j].fd );
+            if (poll_cache_is_bound( entry, fds[j].fd ))
             {
-                int oob_inlined = 0;
-                socklen_t olen = sizeof(oob_inlined);
-
                 fds[j].events = POLLHUP;
 
                 /* Check if we need to test for urgent data or not */
-                getsockopt(fds[j].fd, SOL_SOCKET, SO_OOBINLINE, (char*) &oob_inlined, &olen);
-                if (!oob_inlined)
+                if (!poll_cache_is_oobinline( entry, fds[j].fd ))
                     fds[j].events |= POLLPRI;
             }
             else
@@ -5411,7 +5735,7 @@ int WINAPI WSAPoll(WSAPOLLFD *wfds, ULONG count, int timeout)
         return SOCKET_ERROR;
     }
 
-    if (!(ufds = HeapAlloc(GetProcessHeap(), 0, count * sizeof(ufds[0]))))
+    if (!(ufds = get_poll_array( get_per_thread_data(), count )))
     {
         SetLastError(WSAENOBUFS);
         return SOCKET_ERROR;
@@ -5450,7 +5774,6 @@ int WINAPI WSAPoll(WSAPOLLFD *wfds, ULONG count, int timeout)
             wfds[i].revents = WS_POLLNVAL;
     }
 
-    HeapFree(GetProcessHeap(), 0, ufds);
     return ret;
 }
 
@@ -5458,6 +5781,9 @@ int WINAPI WSAPoll(WSAPOLLFD *wfds, ULONG count, int timeout)
 static void WS_AddCompletion( SOCKET sock, ULONG_PTR CompletionValue, NTSTATUS CompletionStatus,
                               ULONG Information )
 {
+    if (!__wine_add_local_completion( SOCKET2HANDLE(sock), CompletionValue, CompletionStatus, Information ))
+        return;
+
     SERVER_START_REQ( add_fd_completion )
     {
         req->handle      = wine_server_obj_handle( SOCKET2HANDLE(sock) );
@@ -5556,6 +5882,7 @@ static int WS2_sendto( SOCKET s, LPWSABUF lpBuffers, DWORD dwBufferCount,
     wsa->flags       = dwFlags;
     wsa->lpFlags     = &wsa->flags;
     wsa->control     = NULL;
+    wsa->batch_result = -1;
     wsa->n_iovecs    = dwBufferCount;
     wsa->first_iovec = 0;
     for ( i = 0; i < dwBufferCount; i++ )
@@ -5590,7 +5917,9 @@ static int WS2_sendto( SOCKET s, LPWSABUF lpBuffers, DWORD dwBufferCount,
             if (wsa->completion_func)
                 err = register_async( ASYNC_TYPE_WRITE, wsa->hSocket, &wsa->io, NULL,
                                       ws2_async_apc, wsa, iosb );
-            else
+            else if ((err = __wine_queue_local_async( wsa->hSocket, ASYNC_TYPE_WRITE, &wsa->io, iosb,
+                                                      lpOverlapped->hEvent, cvalue,
+                                                      WS2_async_send_batch )) == STATUS_NOT_SUPPORTED)
                 err = register_async( ASYNC_TYPE_WRITE, wsa->hSocket, &wsa->io, lpOverlapped->hEvent,
                                       NULL, (void *)cvalue, iosb );
 
@@ -5786,6 +6115,12 @@ int WINAPI WS_setsockopt(SOCKET s, int level, int optname,
             optlen = sizeof(struct linger);
             break;
 
+        case WS_SO_OOBINLINE:
+            /* select() caches the option */
+            invalidate_poll_cache( s );
+            convert_sockopt(&level, &optname);
+            break;
+
         case WS_SO_RCVBUF:
             if (*(const int*)optval < 2048)
             {
@@ -5801,7 +6136,6 @@ int WINAPI WS_setsockopt(SOCKET s, int level, int optname,
         case WS_SO_BROADCAST:
         case WS_SO_ERROR:
         case WS_SO_KEEPALIVE:
-        case WS_SO_OOBINLINE:
         /* BSD socket SO_REUSEADDR is not 100% compatible to winsock semantics.
          * however, using it the BSD way fixes bug 8513 and seems to be what
          * most programmers assume, anyway */
@@ -7235,6 +7569,7 @@ SOCKET WINAPI WSASocketW(int af, int type, int protocol,
     if (lpProtocolInfo && lpProtocolInfo->dwServiceFlags4 == 0xff00ff00) {
       ret = lpProtocolInfo->dwServiceFlags3;
       TRACE("\tgot duplicate %04lx\n", ret);
+      invalidate_poll_cache( ret );
       return ret;
     }
 
@@ -7333,6 +7668,7 @@ SOCKET WINAPI WSASocketW(int af, int type, int protocol,
     if (ret)
     {
         TRACE("\tcreated %04lx\n", ret );
+        invalidate_poll_cache( ret );
         if (ipxptype > 0)
             set_ipx_packettype(ret, ipxptype);
 
@@ -7717,6 +8053,7 @@ static int WS2_recv_base( SOCKET s, LPWSABUF lpBuffers, DWORD dwBufferCount,
     wsa->addr        = lpFrom;
     wsa->addrlen.ptr = lpFromlen;
     wsa->control     = lpControlBuffer;
+    wsa->batch_result = -1;
     wsa->n_iovecs    = dwBufferCount;
     wsa->first_iovec = 0;
     for (i = 0; i < dwBufferCount; i++)
@@ -7768,7 +8105,9 @@ static int WS2_recv_base( SOCKET s, LPWSABUF lpBuffers, DWORD dwBufferCount,
                 if (wsa->completion_func)
                     err = register_async( ASYNC_TYPE_READ, wsa->hSocket, &wsa->io, NULL,
                                           ws2_async_apc, wsa, iosb );
-                else
+                else if ((err = __wine_queue_local_async( wsa->hSocket, ASYNC_TYPE_READ, &wsa->io, iosb,
+                                                          lpOverlapped->hEvent, cvalue,
+                                                          WS2_async_recv_batch )) == STATUS_NOT_SUPPORTED)
                     err = register_async( ASYNC_TYPE_READ, wsa->hSocket, &wsa->io, lpOverlapped->hEvent,
                                           NULL, (void *)cvalue, iosb );
 
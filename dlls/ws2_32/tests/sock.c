@@ -3751,6 +3751,36 @@ static void test_listen(void)
 
 #define FD_ZERO_ALL() { FD_ZERO(&readfds); FD_ZERO(&writefds); FD_ZERO(&exceptfds); }
 #define FD_SET_ALL(s) { FD_SET(s, &readfds); FD_SET(s, &writefds); FD_SET(s, &exceptfds); }
+static void test_select_reused_handle(void)
+{
+    struct timeval select_timeout;
+    fd_set writefds;
+    SOCKET s;
+    int ret;
+
+    /* an unbound datagram socket is writable */
+    s = socket(AF_INET, SOCK_DGRAM, 0);
+    ok(s != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    FD_ZERO(&writefds);
+    FD_SET(s, &writefds);
+    select_timeout.tv_sec = 0;
+    select_timeout.tv_usec = 0;
+    ret = select(0, NULL, &writefds, NULL, &select_timeout);
+    ok(ret == 1, "expected 1, got %d\n", ret);
+    ok(FD_ISSET(s, &writefds), "FD should be set\n");
+    closesocket(s);
+
+    /* the state of the closed socket must not be reused, even if the handle is */
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    ok(s != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    FD_ZERO(&writefds);
+    FD_SET(s, &writefds);
+    ret = select(0, NULL, &writefds, NULL, &select_timeout);
+    ok(ret == 0, "expected 0, got %d\n", ret);
+    ok(!FD_ISSET(s, &writefds), "FD should not be set\n");
+    closesocket(s);
+}
+
 static void test_select(void)
 {
     static char tmp_buf[1024];
@@ -6841,6 +6871,216 @@ end:
         WSACloseEvent(event);
 }
 
+static void test_WSARecvFrom_queued(void)
+{
+    static const char *messages[] = { "msg0", "msg1", "msg2", "msg3" };
+    struct sockaddr_in addr, from[4];
+    WSAOVERLAPPED ov[4], *povl;
+    int fromlen[4], iret, i, addrlen;
+    char buffers[4][16];
+    SOCKET src, dest;
+    DWORD flags[4], bytes;
+    ULONG_PTR key;
+    WSABUF bufs[4];
+    HANDLE io_port;
+    BOOL bret;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    src = socket(AF_INET, SOCK_DGRAM, 0);
+    ok(src != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    dest = socket(AF_INET, SOCK_DGRAM, 0);
+    ok(dest != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    iret = bind(dest, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!iret, "bind failed: %d\n", WSAGetLastError());
+    addrlen = sizeof(addr);
+    iret = getsockname(dest, (struct sockaddr *)&addr, &addrlen);
+    ok(!iret, "getsockname failed: %d\n", WSAGetLastError());
+
+    io_port = CreateIoCompletionPort((HANDLE)dest, NULL, 125, 0);
+    ok(io_port != NULL, "failed to create completion port %u\n", GetLastError());
+
+    for (i = 0; i < 4; i++)
+    {
+        memset(&ov[i], 0, sizeof(ov[i]));
+        memset(buffers[i], 0, sizeof(buffers[i]));
+        bufs[i].len = sizeof(buffers[i]);
+        bufs[i].buf = buffers[i];
+        flags[i] = 0;
+        fromlen[i] = sizeof(from[i]);
+        iret = WSARecvFrom(dest, &bufs[i], 1, NULL, &flags[i], (struct sockaddr *)&from[i], &fromlen[i],
+                           &ov[i], NULL);
+        ok(iret == SOCKET_ERROR && GetLastError() == ERROR_IO_PENDING,
+           "WSARecvFrom failed - %d error %d\n", iret, GetLastError());
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        iret = sendto(src, messages[i], strlen(messages[i]) + 1, 0, (struct sockaddr *)&addr, sizeof(addr));
+        ok(iret == strlen(messages[i]) + 1, "sendto returned %d, error %d\n", iret, WSAGetLastError());
+    }
+
+    /* the pending requests are satisfied in order */
+    for (i = 0; i < 4; i++)
+    {
+        povl = NULL;
+        bret = GetQueuedCompletionStatus(io_port, &bytes, &key, &povl, 1000);
+        ok(bret, "GetQueuedCompletionStatus failed: %u\n", GetLastError());
+        ok(key == 125, "key is %lu\n", key);
+        ok(bytes == strlen(messages[i]) + 1, "bytes is %u\n", bytes);
+        ok(povl == &ov[i], "got overlapped %p, expected %p\n", povl, &ov[i]);
+        ok(!strcmp(buffers[i], messages[i]), "got %s, expected %s\n", buffers[i], messages[i]);
+    }
+
+    CloseHandle(io_port);
+    closesocket(src);
+    closesocket(dest);
+}
+
+#define QUEUED_COUNT 8
+#define QUEUED_SIZE  2000
+
+/* run in a child process with WINEFASTIOCP set, so that queued datagrams are
+ * transferred by the process-local async queue with recvmmsg and sendmmsg */
+static void test_queued_datagrams_child(void)
+{
+    static char send_data[QUEUED_COUNT][QUEUED_SIZE], recv_data[QUEUED_COUNT][QUEUED_SIZE + 16];
+    WSAOVERLAPPED recv_ov[QUEUED_COUNT], send_ov[QUEUED_COUNT], *povl;
+    struct sockaddr_in addr, from[QUEUED_COUNT];
+    int fromlen[QUEUED_COUNT], iret, i, j, addrlen, size, recv_done, send_done, send_queued;
+    BOOL received[QUEUED_COUNT], sent[QUEUED_COUNT];
+    DWORD recv_flags[QUEUED_COUNT], bytes;
+    WSABUF recv_bufs[QUEUED_COUNT], send_bufs[QUEUED_COUNT];
+    SOCKET src, dest;
+    ULONG_PTR key;
+    HANDLE io_port;
+    BOOL bret;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    src = WSASocketA(AF_INET, SOCK_DGRAM, 0, NULL, 0, WSA_FLAG_OVERLAPPED);
+    ok(src != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    dest = WSASocketA(AF_INET, SOCK_DGRAM, 0, NULL, 0, WSA_FLAG_OVERLAPPED);
+    ok(dest != INVALID_SOCKET, "socket failed unexpectedly: %d\n", WSAGetLastError());
+    iret = bind(dest, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!iret, "bind failed: %d\n", WSAGetLastError());
+    addrlen = sizeof(addr);
+    iret = getsockname(dest, (struct sockaddr *)&addr, &addrlen);
+    ok(!iret, "getsockname failed: %d\n", WSAGetLastError());
+
+    /* make room for all the datagrams, and make sends more likely to be queued */
+    size = 256 * 1024;
+    setsockopt(dest, SOL_SOCKET, SO_RCVBUF, (char *)&size, sizeof(size));
+    size = QUEUED_SIZE;
+    setsockopt(src, SOL_SOCKET, SO_SNDBUF, (char *)&size, sizeof(size));
+
+    io_port = CreateIoCompletionPort((HANDLE)dest, NULL, 125, 0);
+    ok(io_port != NULL, "failed to create completion port %u\n", GetLastError());
+    ok(CreateIoCompletionPort((HANDLE)src, io_port, 126, 0) == io_port,
+       "failed to associate socket %u\n", GetLastError());
+
+    for (i = 0; i < QUEUED_COUNT; i++)
+    {
+        memset(&recv_ov[i], 0, sizeof(recv_ov[i]));
+        memset(recv_data[i], 0, sizeof(recv_data[i]));
+        recv_bufs[i].len = sizeof(recv_data[i]);
+        recv_bufs[i].buf = recv_data[i];
+        recv_flags[i] = 0;
+        fromlen[i] = sizeof(from[i]);
+        iret = WSARecvFrom(dest, &recv_bufs[i], 1, NULL, &recv_flags[i], (struct sockaddr *)&from[i],
+                           &fromlen[i], &recv_ov[i], NULL);
+        ok(iret == SOCKET_ERROR && GetLastError() == ERROR_IO_PENDING,
+           "WSARecvFrom failed - %d error %d\n", iret, GetLastError());
+    }
+
+    /* send the datagrams back to back, some of them are queued if the send buffer is full */
+    send_queued = 0;
+    for (i = 0; i < QUEUED_COUNT; i++)
+    {
+        memset(send_data[i], 'a' + i, QUEUED_SIZE);
+        memset(&send_ov[i], 0, sizeof(send_ov[i]));
+        send_bufs[i].len = QUEUED_SIZE - i;
+        send_bufs[i].buf = send_data[i];
+        iret = WSASendTo(src, &send_bufs[i], 1, NULL, 0, (struct sockaddr *)&addr, sizeof(addr),
+                         &send_ov[i], NULL);
+        if (iret == SOCKET_ERROR && GetLastError() == ERROR_IO_PENDING) send_queued++;
+        else ok(!iret, "WSASendTo failed - %d error %d\n", iret, GetLastError());
+    }
+    trace("%d sends queued\n", send_queued);
+
+    /* each operation completes once with its own size, and the receives in the order they were posted */
+    recv_done = send_done = 0;
+    memset(received, 0, sizeof(received));
+    memset(sent, 0, sizeof(sent));
+    for (i = 0; i < 2 * QUEUED_COUNT; i++)
+    {
+        povl = NULL;
+        bret = GetQueuedCompletionStatus(io_port, &bytes, &key, &povl, 2000);
+        ok(bret, "GetQueuedCompletionStatus failed: %u\n", GetLastError());
+        if (!bret) break;
+        if (key == 125)
+        {
+            ok(recv_done < QUEUED_COUNT, "too many receive completions\n");
+            if (recv_done >= QUEUED_COUNT) break;
+            ok(povl == &recv_ov[recv_done], "got overlapped %p, expected %p\n", povl, &recv_ov[recv_done]);
+            ok(bytes > QUEUED_SIZE - QUEUED_COUNT && bytes <= QUEUED_SIZE,
+               "receive %d: bytes is %u\n", recv_done, bytes);
+            if (bytes <= QUEUED_SIZE - QUEUED_COUNT || bytes > QUEUED_SIZE) break;
+            /* the size identifies the datagram */
+            j = QUEUED_SIZE - bytes;
+            ok(!received[j], "receive %d: datagram %d received twice\n", recv_done, j);
+            received[j] = TRUE;
+            /* sends that complete immediately may overtake queued ones */
+            if (!send_queued) ok(j == recv_done, "receive %d: got datagram %d\n", recv_done, j);
+            ok(from[recv_done].sin_family == AF_INET, "receive %d: wrong address family %d\n",
+               recv_done, from[recv_done].sin_family);
+            ok(!memcmp(recv_data[recv_done], send_data[j], bytes), "receive %d: wrong data\n", recv_done);
+            recv_done++;
+        }
+        else
+        {
+            ok(key == 126, "key is %lu\n", key);
+            j = povl - send_ov;
+            ok(j >= 0 && j < QUEUED_COUNT, "got overlapped %p\n", povl);
+            if (j < 0 || j >= QUEUED_COUNT) break;
+            ok(!sent[j], "send %d completed twice\n", j);
+            sent[j] = TRUE;
+            ok(bytes == QUEUED_SIZE - j, "send %d: bytes is %u\n", j, bytes);
+            send_done++;
+        }
+    }
+    ok(recv_done == QUEUED_COUNT, "got %d receive completions\n", recv_done);
+    ok(send_done == QUEUED_COUNT, "got %d send completions\n", send_done);
+
+    CloseHandle(io_port);
+    closesocket(src);
+    closesocket(dest);
+}
+
+static void test_queued_datagrams(void)
+{
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    char cmdline[MAX_PATH];
+    char **argv;
+    BOOL ret;
+
+    winetest_get_mainargs( &argv );
+    sprintf( cmdline, "%s %s queued_datagrams", argv[0], argv[1] );
+    SetEnvironmentVariableA( "WINEFASTIOCP", "1" );
+    ret = CreateProcessA( NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi );
+    SetEnvironmentVariableA( "WINEFASTIOCP", NULL );
+    ok( ret, "CreateProcess failed, last error %u\n", GetLastError() );
+    if (!ret) return;
+    winetest_wait_child_process( pi.hProcess );
+    CloseHandle( pi.hProcess );
+    CloseHandle( pi.hThread );
+}
+
 #define POLL_CLEAR() ix = 0
 #define POLL_SET(s, ev) {fds[ix].fd = s; fds[ix++].events = ev;}
 #define POLL_ISSET(s, rev) poll_isset(fds, ix, s, rev)
@@ -10240,8 +10480,17 @@ todo_wine
 
 START_TEST( sock )
 {
+    char **argv;
     int i;
 
+    if (winetest_get_mainargs( &argv ) >= 3 && !strcmp( argv[2], "queued_datagrams" ))
+    {
+        Init();
+        test_queued_datagrams_child();
+        Exit();
+        return;
+    }
+
 /* Leave these tests at the beginning. They depend on WSAStartup not having been
  * called, which is done by Init() below. */
     test_WithoutWSAStartup();
@@ -10279,6 +10528,7 @@ START_TEST( sock )
     test_errors();
     test_listen();
     test_select();
+    test_select_reused_handle();
     test_accept();
     test_getpeername();
     test_getsockname();
@@ -10317,6 +10567,8 @@ START_TEST( sock )
     test_WSAAsyncGetServByName();
 
     test_completion_port();
+    test_WSARecvFrom_queued();
+    test_queued_datagrams();
     test_address_list_query();
 
     /* this is an io heavy test, do it at the end so the kernel doesn't start dropping packets */
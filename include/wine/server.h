@@ -36,6 +36,7 @@ struct __server_iovec
 };
 
 #define __SERVER_MAX_DATA 5
+#define __SERVER_MAX_BATCH 16
 
 struct __server_request_info
 {
@@ -50,10 +51,16 @@ struct __server_request_info
 };
 
 extern unsigned int wine_server_call( void *req_ptr );
+extern unsigned int wine_server_call_batch( void **reqs, unsigned int count );
 extern void CDECL wine_server_send_fd( int fd );
 extern int CDECL wine_server_fd_to_handle( int fd, unsigned int access, unsigned int attributes, HANDLE *handle );
 extern int CDECL wine_server_handle_to_fd( HANDLE handle, unsigned int access, int *unix_fd, unsigned int *options );
 extern void CDECL wine_server_release_fd( HANDLE handle, int unix_fd );
+extern NTSTATUS CDECL __wine_add_local_completion( HANDLE handle, ULONG_PTR cvalue, NTSTATUS status,
+                                                   ULONG_PTR info );
+typedef void (CDECL *local_async_batch_func)( int unix_fd, void **users, unsigned int count );
+extern NTSTATUS CDECL __wine_queue_local_async( HANDLE handle, int type, void *user, IO_STATUS_BLOCK *iosb,
+                                                HANDLE event, ULONG_PTR cvalue, local_async_batch_func batch );
 
 /* do a server call and set the last error code */
 static inline unsigned int wine_server_call_err( void *req_ptr )
@@ -195,6 +195,27 @@ typedef __int64 timeout_t;
 #define TIMEOUT_INFINITE (((timeout_t)0x7fffffff) << 32 | 0xffffffff)
 
 
+enum fast_sync_type
+{
+    FAST_SYNC_NONE,
+    FAST_SYNC_AUTO_EVENT,
+    FAST_SYNC_MANUAL_EVENT,
+    FAST_SYNC_SEMAPHORE
+};
+
+
+typedef unsigned int fast_sync_state_t;
+
+#define FAST_SYNC_GENERATION_INDEX 0
+
+
+struct queue_shm
+{
+    unsigned int wake_bits;
+    unsigned int changed_bits;
+};
+
+
 typedef struct
 {
     unsigned int debug_flags;
@@ -248,6 +269,25 @@ typedef struct
 } rectangle_t;
 
 
+struct window_shm
+{
+    unsigned int   seq;
+    user_handle_t  handle;
+    user_handle_t  parent;
+    user_handle_t  owner;
+    thread_id_t    tid;
+    process_id_t   pid;
+    unsigned int   style;
+    unsigned int   ex_style;
+    unsigned int   id;
+    int            __pad;
+    mod_handle_t   instance;
+    lparam_t       user_data;
+    rectangle_t    window;
+    rectangle_t    client;
+};
+
+
 typedef struct
 {
     obj_handle_t    handle;
@@ -1390,6 +1430,37 @@ struct open_semaphore_reply
 
 
 
+struct get_fast_sync_region_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_fast_sync_region_reply
+{
+    struct reply_header __header;
+    mem_size_t   size;
+    obj_handle_t handle;
+    char __pad_20[4];
+};
+
+
+
+struct get_fast_sync_object_request
+{
+    struct request_header __header;
+    obj_handle_t handle;
+};
+struct get_fast_sync_object_reply
+{
+    struct reply_header __header;
+    unsigned int index;
+    unsigned int access;
+    int          type;
+    unsigned int max;
+};
+
+
+
 struct create_file_request
 {
     struct request_header __header;
@@ -2895,8 +2966,23 @@ struct get_msg_queue_reply
 {
     struct reply_header __header;
     obj_handle_t handle;
+    int          shm_index;
+};
+
+
+
+struct get_queue_shm_region_request
+{
+    struct request_header __header;
     char __pad_12[4];
 };
+struct get_queue_shm_region_reply
+{
+    struct reply_header __header;
+    mem_size_t   size;
+    obj_handle_t handle;
+    char __pad_20[4];
+};
 
 
 
@@ -3481,6 +3567,21 @@ struct set_window_info_reply
 
 
 
+struct get_window_shm_region_request
+{
+    struct request_header __header;
+    char __pad_12[4];
+};
+struct get_window_shm_region_reply
+{
+    struct reply_header __header;
+    mem_size_t   size;
+    obj_handle_t handle;
+    char __pad_20[4];
+};
+
+
+
 struct set_parent_request
 {
     struct request_header __header;
@@ -5235,6 +5336,28 @@ struct remove_completion_reply
 };
 
 
+struct completion_entry
+{
+    apc_param_t   ckey;
+    apc_param_t   cvalue;
+    apc_param_t   information;
+    unsigned int  status;
+    int           __pad;
+};
+
+
+struct remove_completions_request
+{
+    struct request_header __header;
+    obj_handle_t handle;
+};
+struct remove_completions_reply
+{
+    struct reply_header __header;
+    /* VARARG(entries,completion_entries); */
+};
+
+
 
 struct query_completion_request
 {
@@ -5542,6 +5665,23 @@ struct terminate_job_reply
 };
 
 
+
+
+struct batch_request
+{
+    struct request_header __header;
+    unsigned int count;
+    /* VARARG(requests,bytes); */
+};
+struct batch_reply
+{
+    struct reply_header __header;
+    unsigned int count;
+    /* VARARG(replies,bytes); */
+    char __pad_12[4];
+};
+
+
 enum request
 {
     REQ_new_process,
@@ -5584,6 +5724,8 @@ enum request
     REQ_release_semaphore,
     REQ_query_semaphore,
     REQ_open_semaphore,
+    REQ_get_fast_sync_region,
+    REQ_get_fast_sync_object,
     REQ_create_file,
     REQ_open_file_object,
     REQ_alloc_file_handle,
@@ -5670,6 +5812,7 @@ enum request
     REQ_empty_atom_table,
     REQ_init_atom_table,
     REQ_get_msg_queue,
+    REQ_get_queue_shm_region,
     REQ_set_queue_fd,
     REQ_set_queue_mask,
     REQ_get_queue_status,
@@ -5702,6 +5845,7 @@ enum request
     REQ_set_window_owner,
     REQ_get_window_info,
     REQ_set_window_info,
+    REQ_get_window_shm_region,
     REQ_set_parent,
     REQ_get_window_parents,
     REQ_get_window_children,
@@ -5807,6 +5951,7 @@ enum request
     REQ_open_completion,
     REQ_add_completion,
     REQ_remove_completion,
+    REQ_remove_completions,
     REQ_query_completion,
     REQ_set_completion_info,
     REQ_add_fd_completion,
@@ -5827,6 +5972,7 @@ enum request
     REQ_set_job_limits,
     REQ_set_job_completion_port,
     REQ_terminate_job,
+    REQ_batch,
     REQ_NB_REQUESTS
 };
 
@@ -5874,6 +6020,8 @@ union generic_request
     struct release_semaphore_request release_semaphore_request;
     struct query_semaphore_request query_semaphore_request;
     struct open_semaphore_request open_semaphore_request;
+    struct get_fast_sync_region_request get_fast_sync_region_request;
+    struct get_fast_sync_object_request get_fast_sync_object_request;
     struct create_file_request create_file_request;
     struct open_file_object_request open_file_object_request;
     struct alloc_file_handle_request alloc_file_handle_request;
@@ -5960,6 +6108,7 @@ union generic_request
     struct empty_atom_table_request empty_atom_table_request;
     struct init_atom_table_request init_atom_table_request;
     struct get_msg_queue_request get_msg_queue_request;
+    struct get_queue_shm_region_request get_queue_shm_region_request;
     struct set_queue_fd_request set_queue_fd_request;
     struct set_queue_mask_request set_queue_mask_request;
     struct get_queue_status_request get_queue_status_request;
@@ -5992,6 +6141,7 @@ union generic_request
     struct set_window_owner_request set_window_owner_request;
     struct get_window_info_request get_window_info_request;
     struct set_window_info_request set_window_info_request;
+    struct get_window_shm_region_request get_window_shm_region_request;
     struct set_parent_request set_parent_request;
     struct get_window_parents_request get_window_parents_request;
     struct get_window_children_request get_window_children_request;
@@ -6097,6 +6247,7 @@ union generic_request
     struct open_completion_request open_completion_request;
     struct add_completion_request add_completion_request;
     struct remove_completion_request remove_completion_request;
+    struct remove_completions_request remove_completions_request;
     struct query_completion_request query_completion_request;
     struct set_completion_info_request set_completion_info_request;
     struct add_fd_completion_request add_fd_completion_request;
@@ -6117,6 +6268,7 @@ union generic_request
     struct set_job_limits_request set_job_limits_request;
     struct set_job_completion_port_request set_job_completion_port_request;
     struct terminate_job_request terminate_job_request;
+    struct batch_request batch_request;
 };
 union generic_reply
 {
@@ -6162,6 +6314,8 @@ union generic_reply
     struct release_semaphore_reply release_semaphore_reply;
     struct query_semaphore_reply query_semaphore_reply;
     struct open_semaphore_reply open_semaphore_reply;
+    struct get_fast_sync_region_reply get_fast_sync_region_reply;
+    struct get_fast_sync_object_reply get_fast_sync_object_reply;
     struct create_file_reply create_file_reply;
     struct open_file_object_reply open_file_object_reply;
     struct alloc_file_handle_reply alloc_file_handle_reply;
@@ -6248,6 +6402,7 @@ union generic_reply
     struct empty_atom_table_reply empty_atom_table_reply;
     struct init_atom_table_reply init_atom_table_reply;
     struct get_msg_queue_reply get_msg_queue_reply;
+    struct get_queue_shm_region_reply get_queue_shm_region_reply;
     struct set_queue_fd_reply set_queue_fd_reply;
     struct set_queue_mask_reply set_queue_mask_reply;
     struct get_queue_status_reply get_queue_status_reply;
@@ -6280,6 +6435,7 @@ union generic_reply
     struct set_window_owner_reply set_window_owner_reply;
     struct get_window_info_reply get_window_info_reply;
     struct set_window_info_reply set_window_info_reply;
+    struct get_window_shm_region_reply get_window_shm_region_reply;
     struct set_parent_reply set_parent_reply;
     struct get_window_parents_reply get_window_parents_reply;
     struct get_window_children_reply get_window_children_reply;
@@ -6385,6 +6541,7 @@ union generic_reply
     struct open_completion_reply open_completion_reply;
     struct add_completion_reply add_completion_reply;
     struct remove_completion_reply remove_completion_reply;
+    struct remove_completions_reply remove_completions_reply;
     struct query_completion_reply query_completion_reply;
     struct set_completion_info_reply set_completion_info_reply;
     struct add_fd_completion_reply add_fd_completion_reply;
@@ -6405,8 +6562,9 @@ union generic_reply
     struct set_job_limits_reply set_job_limits_reply;
     struct set_job_completion_port_reply set_job_completion_port_reply;
     struct terminate_job_reply terminate_job_reply;
+    struct batch_reply batch_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 527
+#define SERVER_PROTOCOL_VERSION 536
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -38,9 +38,11 @@
 
 struct event
 {
-    struct object  obj;             /* object header */
-    int            manual_reset;    /* is it a manual reset event? */
-    int            signaled;        /* event has been signaled */
+    struct object      obj;             /* object header */
+    int                manual_reset;    /* is it a manual reset event? */
+    int                fast_index;      /* index in the fast synchronization region, or -1 */
+    fast_sync_state_t *state;           /* signaled state, either shared or private */
+    fast_sync_state_t  private_state;   /* private state when not using the shared region */
 };
 
 static void event_dump( struct object *obj, int verbose );
@@ -49,6 +51,7 @@ static int event_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static unsigned int event_map_access( struct object *obj, unsigned int access );
 static int event_signal( struct object *obj, unsigned int access);
+static void event_destroy( struct object *obj );
 
 static const struct object_ops event_ops =
 {
@@ -69,7 +72,7 @@ static const struct object_ops event_ops =
     default_unlink_name,       /* unlink_name */
     no_open_file,              /* open_file */
     no_close_handle,           /* close_handle */
-    no_destroy                 /* destroy */
+    event_destroy              /* destroy */
 };
 
 
@@ -117,8 +120,13 @@ struct event *create_event( struct object *root, const struct unicode_str *name,
         if (get_error() != STATUS_OBJECT_NAME_EXISTS)
         {
             /* initialize it if it didn't already exist */
-            event->manual_reset = manual_reset;
-            event->signaled     = initial_state;
+            event->manual_reset  = manual_reset;
+            event->private_state = 0;
+            if ((event->fast_index = alloc_fast_sync_index()) != -1)
+                event->state = get_fast_sync_state( event->fast_index );
+            else
+                event->state = &event->private_state;
+            fast_sync_set_count( event->state, initial_state != 0 );
         }
     }
     return event;
@@ -131,22 +139,32 @@ struct event *get_event_obj( struct process *process, obj_handle_t handle, unsig
 
 void pulse_event( struct event *event )
 {
-    event->signaled = 1;
+    fast_sync_set_count( event->state, 1 );
     /* wake up all waiters if manual reset, a single one otherwise */
     wake_up( &event->obj, !event->manual_reset );
-    event->signaled = 0;
+    fast_sync_set_count( event->state, 0 );
 }
 
 void set_event( struct event *event )
 {
-    event->signaled = 1;
+    fast_sync_set_count( event->state, 1 );
     /* wake up all waiters if manual reset, a single one otherwise */
     wake_up( &event->obj, !event->manual_reset );
 }
 
 void reset_event( struct event *event )
 {
-    event->signaled = 0;
+    fast_sync_set_count( event->state, 0 );
+}
+
+/* return the fast synchronization type and index of an event object */
+int get_event_fast_sync( struct object *obj, int *index )
+{
+    struct event *event = (struct event *)obj;
+
+    if (obj->ops != &event_ops || event->fast_index == -1) return FAST_SYNC_NONE;
+    *index = event->fast_index;
+    return event->manual_reset ? FAST_SYNC_MANUAL_EVENT : FAST_SYNC_AUTO_EVENT;
 }
 
 static void event_dump( struct object *obj, int verbose )
@@ -154,7 +172,7 @@ static void event_dump( struct object *obj, int verbose )
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
     fprintf( stderr, "Event manual=%d signaled=%d\n",
-             event->manual_reset, event->signaled );
+             event->manual_reset, fast_sync_get_count( event->state ) );
 }
 
 static struct object_type *event_get_type( struct object *obj )
@@ -168,7 +186,7 @@ static int event_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
-    return event->signaled;
+    return fast_sync_get_count( event->state ) != 0;
 }
 
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry )
@@ -176,7 +194,7 @@ static void event_satisfied( struct object *obj, struct wait_queue_entry *entry
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
     /* Reset if it's an auto-reset event */
-    if (!event->manual_reset) event->signaled = 0;
+    if (!event->manual_reset) fast_sync_set_count( event->state, 0 );
 }
 
 static unsigned int event_map_access( struct object *obj, unsigned int access )
@@ -202,6 +220,13 @@ static int event_signal( struct object *obj, unsigned int access )
     return 1;
 }
 
+static void event_destroy( struct object *obj )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    free_fast_sync_index( event->fast_index );
+}
+
 struct keyed_event *create_keyed_event( struct object *root, const struct unicode_str *name,
                                         unsigned int attr, const struct security_descriptor *sd )
 {
@@ -337,7 +362,7 @@ DECL_HANDLER(query_event)
     if (!(event = get_event_obj( current->process, req->handle, EVENT_QUERY_STATE ))) return;
 
     reply->manual_reset = event->manual_reset;
-    reply->state = event->signaled;
+    reply->state = fast_sync_get_count( event->state ) != 0;
 
     release_object( event );
 }
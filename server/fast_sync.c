@@ -0,0 +1,170 @@
+/*
+ * Server-side support for fast synchronization objects
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * When the WINEFASTSYNC environment variable is set, the state of events
+ * and semaphores is stored in a memory region shared with all the client
+ * processes. The clients map it read-only, and only use it to query objects
+ * and to check for signaled manual-reset events without a server round trip.
+ * Only the server modifies the states, so it remains responsible for waking
+ * up waiting threads.
+ *
+ * The clients cache the object of each handle. A handle closed by another
+ * process bumps the generation stored in the first entry of the region, so
+ * that the clients can flush their cache.
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+
+#include "file.h"
+#include "handle.h"
+#include "thread.h"
+#include "request.h"
+
+#define MAX_FAST_SYNC_OBJECTS 65536
+
+static struct mapping *fast_sync_mapping;   /* mapping of the shared region */
+static fast_sync_state_t *fast_sync_states; /* server view of the shared region */
+static unsigned int nb_fast_sync_used;      /* number of entries used so far */
+static unsigned int *fast_sync_free_list;   /* stack of freed entries */
+static unsigned int nb_fast_sync_free;      /* number of entries in the free stack */
+
+/* create the shared region if fast synchronization is enabled */
+void init_fast_sync(void)
+{
+    const char *env = getenv( "WINEFASTSYNC" );
+
+    if (!env || !atoi( env )) return;
+
+    if (!(fast_sync_free_list = mem_alloc( MAX_FAST_SYNC_OBJECTS * sizeof(*fast_sync_free_list) )))
+        return;
+    if (!(fast_sync_mapping = create_shared_mapping( MAX_FAST_SYNC_OBJECTS * sizeof(fast_sync_state_t),
+                                                     (void **)&fast_sync_states )))
+    {
+        free( fast_sync_free_list );
+        fast_sync_free_list = NULL;
+        clear_error();
+        return;
+    }
+    make_object_static( (struct object *)fast_sync_mapping );
+    nb_fast_sync_used = FAST_SYNC_GENERATION_INDEX + 1;
+    if (debug_level) fprintf( stderr, "wineserver: fast synchronization enabled\n" );
+}
+
+/* allocate an entry in the shared region, return -1 if none available */
+int alloc_fast_sync_index(void)
+{
+    unsigned int index;
+
+    if (!fast_sync_mapping) return -1;
+    if (nb_fast_sync_free) index = fast_sync_free_list[--nb_fast_sync_free];
+    else if (nb_fast_sync_used < MAX_FAST_SYNC_OBJECTS) index = nb_fast_sync_used++;
+    else return -1;
+    fast_sync_states[index] = 0;
+    return index;
+}
+
+/* free an entry of the shared region */
+void free_fast_sync_index( int index )
+{
+    if (index == -1) return;
+    fast_sync_states[index] = 0;
+    fast_sync_free_list[nb_fast_sync_free++] = index;
+}
+
+/* notify the clients that a handle has been closed behind the back of its process */
+void fast_sync_handle_closed(void)
+{
+    if (fast_sync_mapping) fast_sync_states[FAST_SYNC_GENERATION_INDEX]++;
+}
+
+/* retrieve the state of an entry of the shared region */
+fast_sync_state_t *get_fast_sync_state( int index )
+{
+    return &fast_sync_states[index];
+}
+
+/* return the current count of a fast synchronization state */
+unsigned int fast_sync_get_count( fast_sync_state_t *state )
+{
+    return *state;
+}
+
+/* set the count of a fast synchronization state, return the previous count */
+unsigned int fast_sync_set_count( fast_sync_state_t *state, unsigned int count )
+{
+    unsigned int old = *state;
+
+    *state = count;
+    return old;
+}
+
+/* add to the count of a fast synchronization state without exceeding max */
+int fast_sync_add_count( fast_sync_state_t *state, unsigned int count, unsigned int max,
+                         unsigned int *prev )
+{
+    unsigned int cur = *state;
+
+    if (prev) *prev = cur;
+    if (cur + count < cur || cur + count > max) return 0;
+    *state = cur + count;
+    return 1;
+}
+
+/* decrement the count of a fast synchronization state, which must be non-zero */
+void fast_sync_dec_count( fast_sync_state_t *state )
+{
+    --*state;
+}
+
+/* retrieve the shared region holding the state of fast synchronization objects */
+DECL_HANDLER(get_fast_sync_region)
+{
+    if (!fast_sync_mapping)
+    {
+        set_error( STATUS_NOT_IMPLEMENTED );
+        return;
+    }
+    reply->size   = MAX_FAST_SYNC_OBJECTS * sizeof(fast_sync_state_t);
+    reply->handle = alloc_handle( current->process, fast_sync_mapping, SECTION_QUERY | SECTION_MAP_READ, 0 );
+}
+
+/* retrieve the fast synchronization state of an object */
+DECL_HANDLER(get_fast_sync_object)
+{
+    struct object *obj;
+    int index = -1;
+
+    if (!(obj = get_handle_obj( current->process, req->handle, 0, NULL ))) return;
+
+    if ((reply->type = get_event_fast_sync( obj, &index )) == FAST_SYNC_NONE)
+        reply->type = get_semaphore_fast_sync( obj, &index, &reply->max );
+    if (reply->type != FAST_SYNC_NONE) reply->index = index;
+    reply->access = get_handle_access( current->process, req->handle );
+    release_object( obj );
+}
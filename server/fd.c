@@ -358,13 +358,17 @@ static file_pos_t max_unix_offset = OFF_T_MAX;
 
 struct timeout_user
 {
-    struct list           entry;      /* entry in sorted timeout list */
+    struct list           entry;      /* entry in expired timeout list */
+    int                   index;      /* index in the timeout heap, -1 once expired */
     timeout_t             when;       /* timeout expiry (absolute time) */
     timeout_callback      callback;   /* callback function */
     void                 *private;    /* callback private data */
 };
 
-static struct list timeout_list = LIST_INIT(timeout_list);   /* sorted timeouts list */
+static struct timeout_user **timeout_heap;  /* binary min-heap of pending timeouts */
+static int nb_timeouts;                     /* number of entries in the heap */
+static int allocated_timeouts;              /* allocated size of the heap array */
+static unsigned int timeouts_processed;     /* timeouts expired in the current main loop iteration */
 timeout_t current_time;
 
 static inline void set_current_time(void)
@@ -375,32 +379,95 @@ static inline void set_current_time(void)
     current_time = (timeout_t)now.tv_sec * TICKS_PER_SEC + now.tv_usec * 10 + ticks_1601_to_1970;
 }
 
+static inline void set_timeout_heap_entry( int index, struct timeout_user *user )
+{
+    timeout_heap[index] = user;
+    user->index = index;
+}
+
+/* move a heap entry towards the root until the heap property holds */
+static void timeout_heap_up( int index )
+{
+    struct timeout_user *user = timeout_heap[index];
+
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (timeout_heap[parent]->when <= user->when) break;
+        set_timeout_heap_entry( index, timeout_heap[parent] );
+        index = parent;
+    }
+    set_timeout_heap_entry( index, user );
+}
+
+/* move a heap entry towards the leaves until the heap property holds */
+static void timeout_heap_down( int index )
+{
+    struct timeout_user *user = timeout_heap[index];
+
+    for (;;)
+    {
+        int child = 2 * index + 1;
+        if (child >= nb_timeouts) break;
+        if (child + 1 < nb_timeouts && timeout_heap[child + 1]->when < timeout_heap[child]->when) child++;
+        if (user->when <= timeout_heap[child]->when) break;
+        set_timeout_heap_entry( index, timeout_heap[child] );
+        index = child;
+    }
+    set_timeout_heap_entry( index, user );
+}
+
+/* remove an entry from the timeout heap */
+static void timeout_heap_remove( struct timeout_user *user )
+{
+    int index = user->index;
+    struct timeout_user *last = timeout_heap[--nb_timeouts];
+
+    user->index = -1;
+    if (index == nb_timeouts) return;
+    set_timeout_heap_entry( index, last );
+    if (index > 0 && timeout_heap[(index - 1) / 2]->when > last->when)
+        timeout_heap_up( index );
+    else
+        timeout_heap_down( index );
+}
+
 /* add a timeout user */
 struct timeout_user *add_timeout_user( timeout_t when, timeout_callback func, void *private )
 {
     struct timeout_user *user;
-    struct list *ptr;
+
+    if (nb_timeouts == allocated_timeouts)
+    {
+        struct timeout_user **new_heap;
+        int new_count = allocated_timeouts ? (allocated_timeouts + allocated_timeouts / 2) : 64;
+
+        if (!(new_heap = realloc( timeout_heap, new_count * sizeof(*new_heap) )))
+        {
+            set_error( STATUS_NO_MEMORY );
+            return NULL;
+        }
+        timeout_heap = new_heap;
+        allocated_timeouts = new_count;
+    }
 
     if (!(user = mem_alloc( sizeof(*user) ))) return NULL;
     user->when     = (when > 0) ? when : current_time - when;
     user->callback = func;
     user->private  = private;
 
-    /* Now insert it in the linked list */
+    /* Now insert it in the heap */
 
-    LIST_FOR_EACH( ptr, &timeout_list )
-    {
-        struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
-        if (timeout->when >= user->when) break;
-    }
-    list_add_before( ptr, &user->entry );
+    timeout_heap[nb_timeouts] = user;
+    timeout_heap_up( nb_timeouts++ );
     return user;
 }
 
 /* remove a timeout user */
 void remove_timeout_user( struct timeout_user *user )
 {
-    list_remove( &user->entry );
+    if (user->index == -1) list_remove( &user->entry );  /* already expired */
+    else timeout_heap_remove( user );
     free( user );
 }
 
@@ -846,23 +913,20 @@ static void remove_poll_user( struct fd *fd, int user )
 /* process pending timeouts and return the time until the next timeout, in milliseconds */
 static int get_next_timeout(void)
 {
-    if (!list_empty( &timeout_list ))
+    timeouts_processed = 0;
+
+    if (nb_timeouts)
     {
         struct list expired_list, *ptr;
 
-        /* first remove all expired timers from the list */
+        /* first remove all expired timers from the heap */
 
         list_init( &expired_list );
-        while ((ptr = list_head( &timeout_list )) != NULL)
+        while (nb_timeouts && timeout_heap[0]->when <= current_time)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
-
-            if (timeout->when <= current_time)
-            {
-                list_remove( &timeout->entry );
-                list_add_tail( &expired_list, &timeout->entry );
-            }
-            else break;
+            struct timeout_user *timeout = timeout_heap[0];
+            timeout_heap_remove( timeout );
+            list_add_tail( &expired_list, &timeout->entry );
         }
 
         /* now call the callback for all the removed timers */
@@ -873,12 +937,16 @@ static int get_next_timeout(void)
             list_remove( &timeout->entry );
             timeout->callback( timeout->private );
             free( timeout );
+            timeouts_processed++;
         }
 
-        if ((ptr = list_head( &timeout_list )) != NULL)
+        if (debug_level > 1 && timeouts_processed)
+            fprintf( stderr, "wineserver: processed %u timeouts, %d pending\n",
+                     timeouts_processed, nb_timeouts );
+
+        if (nb_timeouts)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
-            int diff = (timeout->when - current_time + 9999) / 10000;
+            int diff = (timeout_heap[0]->when - current_time + 9999) / 10000;
             if (diff < 0) diff = 0;
             return diff;
         }
@@ -295,10 +295,74 @@ static int file_get_poll_events( struct fd *fd )
     return events;
 }
 
+struct flush_work
+{
+    int            unix_fd;  /* duplicated unix fd to flush */
+    int            error;    /* errno value of the fsync call */
+    struct async  *async;    /* async waiting for the flush to complete */
+};
+
+/* called in a worker thread, must not access any server object */
+static void flush_work_func( void *arg )
+{
+    struct flush_work *work = arg;
+    work->error = (fsync( work->unix_fd ) == -1) ? errno : 0;
+}
+
+/* called from the main loop once the flush is done */
+static void flush_work_callback( void *arg )
+{
+    struct flush_work *work = arg;
+    unsigned int status = STATUS_SUCCESS;
+
+    if (work->error)
+    {
+        errno = work->error;
+        file_set_error();
+        status = get_error();
+        clear_error();
+    }
+    close( work->unix_fd );
+    async_terminate( work->async, status );
+    release_object( work->async );
+    free( work );
+}
+
 static obj_handle_t file_flush( struct fd *fd, struct async *async )
 {
+    struct file *file = get_fd_user( fd );
+    struct flush_work *work;
+    obj_handle_t handle;
     int unix_fd = get_unix_fd( fd );
-    if (unix_fd != -1 && fsync( unix_fd ) == -1) file_set_error();
+
+    if (unix_fd == -1) return 0;
+
+    /* let a worker thread wait for the data of a regular file to reach the disk if possible */
+    if (S_ISREG( file->mode ) && have_workers() && async_is_blocking( async ) &&
+        (work = mem_alloc( sizeof(*work) )))
+    {
+        if ((work->unix_fd = dup( unix_fd )) != -1 &&
+            (handle = alloc_handle( current->process, async, SYNCHRONIZE, 0 )))
+        {
+            if (fd_queue_async( fd, async, ASYNC_TYPE_WAIT ))
+            {
+                work->async = (struct async *)grab_object( async );
+                if (!queue_work( flush_work_func, flush_work_callback, work ))
+                {
+                    flush_work_func( work );
+                    flush_work_callback( work );
+                }
+                set_error( STATUS_PENDING );
+                return handle;
+            }
+            close_handle( current->process, handle );
+        }
+        if (work->unix_fd != -1) close( work->unix_fd );
+        free( work );
+        clear_error();
+    }
+
+    if (fsync( unix_fd ) == -1) file_set_error();
     return 0;
 }
 
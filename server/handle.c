@@ -654,6 +654,7 @@ DECL_HANDLER(dup_handle)
         if ((req->options & DUP_HANDLE_CLOSE_SOURCE) && (src != dst || req->src_handle != reply->handle))
             reply->closed = !close_handle( src, req->src_handle );
         reply->self = (src == current->process);
+        if (reply->closed && !reply->self) fast_sync_handle_closed();
         release_object( src );
     }
 }
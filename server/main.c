@@ -145,6 +145,11 @@ int main( int argc, char *argv[] )
     init_signals();
     init_directories();
     init_registry();
+    init_fast_sync();
+    init_queue_shm();
+    init_mouse_coalescing();
+    init_window_shm();
+    init_workers();
     main_loop();
     return 0;
 }
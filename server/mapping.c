@@ -615,6 +615,29 @@ struct mapping *get_mapping_obj( struct process *process, obj_handle_t handle, u
     return (struct mapping *)get_handle_obj( process, handle, access, &mapping_ops );
 }
 
+/* create an anonymous mapping that is also mapped read-write in the server address space */
+struct mapping *create_shared_mapping( mem_size_t size, void **ptr )
+{
+    struct mapping *mapping;
+    int unix_fd;
+
+    if (!(mapping = (struct mapping *)create_mapping( NULL, NULL, 0, size, SEC_COMMIT,
+                                                      VPROT_READ | VPROT_WRITE, 0, NULL )))
+        return NULL;
+
+    if ((unix_fd = get_unix_fd( mapping->fd )) == -1) goto error;
+    if ((*ptr = mmap( NULL, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, unix_fd, 0 )) == MAP_FAILED)
+    {
+        file_set_error();
+        goto error;
+    }
+    return mapping;
+
+ error:
+    release_object( mapping );
+    return NULL;
+}
+
 /* open a new file handle to the file backing the mapping */
 obj_handle_t open_mapping_file( struct process *process, struct mapping *mapping,
                                 unsigned int access, unsigned int sharing )
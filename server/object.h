@@ -185,6 +185,37 @@ extern struct keyed_event *get_keyed_event_obj( struct process *process, obj_han
 extern void pulse_event( struct event *event );
 extern void set_event( struct event *event );
 extern void reset_event( struct event *event );
+extern int get_event_fast_sync( struct object *obj, int *index );
+
+/* semaphore functions */
+
+extern int get_semaphore_fast_sync( struct object *obj, int *index, unsigned int *max );
+
+/* fast synchronization functions */
+
+extern void init_fast_sync(void);
+extern int alloc_fast_sync_index(void);
+extern void free_fast_sync_index( int index );
+extern void fast_sync_handle_closed(void);
+extern fast_sync_state_t *get_fast_sync_state( int index );
+extern unsigned int fast_sync_get_count( fast_sync_state_t *state );
+extern unsigned int fast_sync_set_count( fast_sync_state_t *state, unsigned int count );
+extern int fast_sync_add_count( fast_sync_state_t *state, unsigned int count, unsigned int max,
+                                unsigned int *prev );
+extern void fast_sync_dec_count( fast_sync_state_t *state );
+
+/* shared user state functions */
+
+extern void init_queue_shm(void);
+extern void init_mouse_coalescing(void);
+extern void init_window_shm(void);
+
+/* worker thread functions */
+
+typedef void (*work_func)( void *arg );
+extern void init_workers(void);
+extern int have_workers(void);
+extern int queue_work( work_func func, work_func callback, void *arg );
 
 /* mutex functions */
 
@@ -140,6 +140,7 @@ struct msg_queue
     struct thread_input   *input;           /* thread input descriptor */
     struct hook_table     *hooks;           /* hook table */
     timeout_t              last_get_msg;    /* time of last get message call */
+    int                    shm_index;       /* index of the state in the shared region, or -1 */
 };
 
 struct hotkey
@@ -152,6 +153,28 @@ struct hotkey
     unsigned int        flags;        /* key modifiers */
 };
 
+/* When the WINEFASTQUEUE environment variable is set, the wake and changed
+ * bits of the message queues are mirrored in a memory region mapped read-only
+ * in the client processes, so that they can check for an empty queue without
+ * a server round trip. */
+
+#define MAX_SHARED_QUEUES 16384
+
+static struct mapping *queue_shm_mapping;   /* mapping of the shared region */
+static struct queue_shm *queue_shm_states;  /* server view of the shared region */
+static unsigned int nb_queue_shm_used;      /* number of entries used so far */
+static int *queue_shm_free_list;            /* stack of freed entries */
+static unsigned int nb_queue_shm_free;      /* number of entries in the free stack */
+
+/* When the WINEMOUSECOALESCE environment variable is set to a number of
+ * messages, a new mouse move is also merged with the last pending mouse move
+ * of an input queue holding at least that many hardware messages, even if
+ * keyboard messages were queued in the meantime. Raw input messages are
+ * never merged, so they are still all delivered. */
+
+static unsigned int coalesce_watermark;     /* pending messages above which moves are coalesced */
+static unsigned int coalesced_moves;        /* number of mouse moves merged across keyboard input */
+
 static void msg_queue_dump( struct object *obj, int verbose );
 static int msg_queue_add_queue( struct object *obj, struct wait_queue_entry *entry );
 static void msg_queue_remove_queue( struct object *obj, struct wait_queue_entry *entry );
@@ -268,6 +291,66 @@ static struct thread_input *create_thread_input( struct thread *thread )
     return input;
 }
 
+/* create the shared region if enabled */
+void init_queue_shm(void)
+{
+    const char *env = getenv( "WINEFASTQUEUE" );
+
+    if (!env || !atoi( env )) return;
+
+    if (!(queue_shm_free_list = mem_alloc( MAX_SHARED_QUEUES * sizeof(*queue_shm_free_list) ))) return;
+    if (!(queue_shm_mapping = create_shared_mapping( MAX_SHARED_QUEUES * sizeof(*queue_shm_states),
+                                                     (void **)&queue_shm_states )))
+    {
+        free( queue_shm_free_list );
+        queue_shm_free_list = NULL;
+        clear_error();
+        return;
+    }
+    make_object_static( (struct object *)queue_shm_mapping );
+    if (debug_level) fprintf( stderr, "wineserver: shared queue state enabled\n" );
+}
+
+/* read the mouse move coalescing settings */
+void init_mouse_coalescing(void)
+{
+    const char *env = getenv( "WINEMOUSECOALESCE" );
+    int watermark;
+
+    if (!env || (watermark = atoi( env )) <= 0) return;
+    coalesce_watermark = watermark;
+    if (debug_level) fprintf( stderr, "wineserver: coalescing mouse moves above %u messages\n",
+                              coalesce_watermark );
+}
+
+/* allocate an entry in the shared region, return -1 if none available */
+static int alloc_queue_shm_index(void)
+{
+    int index;
+
+    if (!queue_shm_mapping) return -1;
+    if (nb_queue_shm_free) index = queue_shm_free_list[--nb_queue_shm_free];
+    else if (nb_queue_shm_used < MAX_SHARED_QUEUES) index = nb_queue_shm_used++;
+    else return -1;
+    queue_shm_states[index].wake_bits = queue_shm_states[index].changed_bits = 0;
+    return index;
+}
+
+/* free an entry of the shared region */
+static void free_queue_shm_index( int index )
+{
+    if (index == -1) return;
+    queue_shm_free_list[nb_queue_shm_free++] = index;
+}
+
+/* publish the queue bits in the shared region */
+static inline void update_queue_shm( struct msg_queue *queue )
+{
+    if (queue->shm_index == -1) return;
+    queue_shm_states[queue->shm_index].wake_bits    = queue->wake_bits;
+    queue_shm_states[queue->shm_index].changed_bits = queue->changed_bits;
+}
+
 /* create a message queue object */
 static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_input *input )
 {
@@ -298,6 +381,7 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->input           = (struct thread_input *)grab_object( input );
         queue->hooks           = NULL;
         queue->last_get_msg    = current_time;
+        queue->shm_index       = alloc_queue_shm_index();
         list_init( &queue->send_result );
         list_init( &queue->callback_result );
         list_init( &queue->pending_timers );
@@ -440,6 +524,7 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
 {
     queue->wake_bits |= bits;
     queue->changed_bits |= bits;
+    update_queue_shm( queue );
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
@@ -448,6 +533,7 @@ static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits
 {
     queue->wake_bits &= ~bits;
     queue->changed_bits &= ~bits;
+    update_queue_shm( queue );
 }
 
 /* check whether msg is a keyboard message */
@@ -502,17 +588,33 @@ static inline unsigned int get_unique_id(void)
     return id;
 }
 
+/* check if the input queue holds enough messages to coalesce mouse moves */
+static int is_input_congested( struct thread_input *input )
+{
+    unsigned int count = 0;
+    struct list *ptr;
+
+    if (!coalesce_watermark) return 0;
+    LIST_FOR_EACH( ptr, &input->msg_list ) if (++count >= coalesce_watermark) return 1;
+    return 0;
+}
+
 /* try to merge a message with the last in the list; return 1 if successful */
 static int merge_message( struct thread_input *input, const struct message *msg )
 {
     struct message *prev;
     struct list *ptr;
+    int coalesce, skipped = 0;
 
     if (msg->msg != WM_MOUSEMOVE) return 0;
+    coalesce = is_input_congested( input );
     for (ptr = list_tail( &input->msg_list ); ptr; ptr = list_prev( &input->msg_list, ptr ))
     {
         prev = LIST_ENTRY( ptr, struct message, entry );
-        if (prev->msg != WM_INPUT) break;
+        if (prev->msg == WM_INPUT) continue;
+        /* keyboard input doesn't depend on the mouse position */
+        if (!coalesce || !is_keyboard_msg( prev )) break;
+        skipped = 1;
     }
     if (!ptr) return 0;
     if (prev->result) return 0;
@@ -533,6 +635,8 @@ static int merge_message( struct thread_input *input, const struct message *msg
     }
     list_remove( ptr );
     list_add_tail( &input->msg_list, ptr );
+    if (skipped && !(++coalesced_moves % 1000) && debug_level)
+        fprintf( stderr, "wineserver: %u mouse moves coalesced\n", coalesced_moves );
     return 1;
 }
 
@@ -995,6 +1099,7 @@ static void msg_queue_destroy( struct object *obj )
     release_object( queue->input );
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
+    free_queue_shm_index( queue->shm_index );
 }
 
 static void msg_queue_poll_event( struct fd *fd, int event )
@@ -2218,7 +2323,25 @@ DECL_HANDLER(get_msg_queue)
     struct msg_queue *queue = get_current_queue();
 
     reply->handle = 0;
-    if (queue) reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+    reply->shm_index = -1;
+    if (queue)
+    {
+        reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+        reply->shm_index = queue->shm_index;
+    }
+}
+
+
+/* retrieve the shared region holding the state of the message queues */
+DECL_HANDLER(get_queue_shm_region)
+{
+    if (!queue_shm_mapping)
+    {
+        set_error( STATUS_NOT_IMPLEMENTED );
+        return;
+    }
+    reply->size   = MAX_SHARED_QUEUES * sizeof(*queue_shm_states);
+    reply->handle = alloc_handle( current->process, queue_shm_mapping, SECTION_QUERY | SECTION_MAP_READ, 0 );
 }
 
 
@@ -2277,6 +2400,7 @@ DECL_HANDLER(get_queue_status)
         reply->wake_bits    = queue->wake_bits;
         reply->changed_bits = queue->changed_bits;
         queue->changed_bits &= ~req->clear_bits;
+        update_queue_shm( queue );
     }
     else reply->wake_bits = reply->changed_bits = 0;
 }
@@ -2452,6 +2576,7 @@ DECL_HANDLER(get_message)
     }
     if (filter & QS_INPUT) queue->changed_bits &= ~QS_INPUT;
     if (filter & QS_PAINT) queue->changed_bits &= ~QS_PAINT;
+    update_queue_shm( queue );
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
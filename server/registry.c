@@ -36,6 +36,9 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -72,9 +75,16 @@ struct key
     int               last_subkey; /* last in use subkey */
     int               nb_subkeys;  /* count of allocated subkeys */
     struct key      **subkeys;     /* subkeys array */
+    int               sorted_subkeys; /* count of sorted subkeys at the start of the array */
+    int              *subkey_hash; /* hash table of subkey indices (for large keys) */
+    unsigned int      subkey_hash_size; /* number of buckets in the subkey hash table */
+    int               hash_next;   /* index of the next subkey in the parent hash bucket */
     int               last_value;  /* last in use value */
     int               nb_values;   /* count of allocated values in array */
     struct key_value *values;      /* values array */
+    int               sorted_values; /* count of sorted values at the start of the array */
+    int              *value_hash;  /* hash table of value indices (for large keys) */
+    unsigned int      value_hash_size; /* number of buckets in the value hash table */
     unsigned int      flags;       /* flags */
     timeout_t         modif;       /* last modification time */
     struct list       notify_list; /* list of notifications */
@@ -96,10 +106,12 @@ struct key_value
     unsigned int      type;    /* value type */
     data_size_t       len;     /* value data length in bytes */
     void             *data;    /* pointer to value data */
+    int               hash_next; /* index of the next value in the hash bucket */
 };
 
 #define MIN_SUBKEYS  8   /* min. number of allocated subkeys per key */
 #define MIN_VALUES   8   /* min. number of allocated values per key */
+#define MIN_HASHED   128 /* min. number of subkeys or values to use a hash table */
 
 #define MAX_NAME_LEN  256    /* max. length of a key name */
 #define MAX_VALUE_LEN 16383  /* max. length of a value name */
@@ -119,17 +131,33 @@ static const struct unicode_str symlink_str = { symlink_value, sizeof(symlink_va
 
 static void set_periodic_save_timer(void);
 static struct key_value *find_value( const struct key *key, const struct unicode_str *name, int *index );
+static void sort_subkeys( struct key *key );
+static void sort_values( struct key *key );
+static void journal_delete_key( const struct key *key );
 
 /* information about where to save a registry branch */
 struct save_branch_info
 {
     struct key  *key;
     const char  *path;
+    /* the following fields are only used with binary hives */
+    char        *hive_path;    /* binary hive file name */
+    char        *journal_path; /* journal file name */
+    unsigned int generation;   /* generation of the current hive file */
+    file_pos_t   hive_size;    /* size of the current hive file */
+    file_pos_t   journal_size; /* size of the current journal file */
+    int          full_save;    /* the whole hive must be saved again */
+    struct list  deleted;      /* deleted keys not yet written to the journal */
 };
 
 #define MAX_SAVE_BRANCH_INFO 3
 static int save_branch_count;
 static struct save_branch_info save_branch_info[MAX_SAVE_BRANCH_INFO];
+static int use_registry_hive;  /* save the registry branches to binary hives */
+static int loading_journal;    /* the journal is being replayed */
+
+static void init_branch_hive( struct save_branch_info *branch );
+static int load_hive( struct save_branch_info *branch );
 
 
 /* information about a file being loaded */
@@ -256,11 +284,13 @@ static void dump_value( const struct key_value *value, FILE *f )
 }
 
 /* save a registry and all its subkeys to a text file */
-static void save_subkeys( const struct key *key, const struct key *base, FILE *f )
+static void save_subkeys( struct key *key, const struct key *base, FILE *f )
 {
     int i;
 
     if (key->flags & KEY_VOLATILE) return;
+    sort_subkeys( key );
+    sort_values( key );
     /* save key if it has either some values or no subkeys, or needs special options */
     /* keys with no values but subkeys are saved implicitly by saving the subkeys */
     if ((key->last_value >= 0) || (key->last_subkey == -1) || key->class || (key->flags & KEY_SYMLINK))
@@ -418,12 +448,14 @@ static void key_destroy( struct object *obj )
         free( key->values[i].data );
     }
     free( key->values );
+    free( key->value_hash );
     for (i = 0; i <= key->last_subkey; i++)
     {
         key->subkeys[i]->parent = NULL;
         release_object( key->subkeys[i] );
     }
     free( key->subkeys );
+    free( key->subkey_hash );
     /* unconditionally notify everything waiting on this key */
     while ((ptr = list_head( &key->notify_list )))
     {
@@ -487,9 +519,16 @@ static struct key *alloc_key( const struct unicode_str *name, timeout_t modif )
         key->last_subkey = -1;
         key->nb_subkeys  = 0;
         key->subkeys     = NULL;
+        key->sorted_subkeys   = 0;
+        key->subkey_hash      = NULL;
+        key->subkey_hash_size = 0;
+        key->hash_next   = -1;
         key->nb_values   = 0;
         key->last_value  = -1;
         key->values      = NULL;
+        key->sorted_values    = 0;
+        key->value_hash       = NULL;
+        key->value_hash_size  = 0;
         key->modif       = modif;
         key->parent      = NULL;
         list_init( &key->notify_list );
@@ -551,6 +590,118 @@ static void touch_key( struct key *key, unsigned int change )
         check_notify( k, change & ~REG_NOTIFY_CHANGE_LAST_SET, 0 );
 }
 
+/* compare two key or value names, using the sort order of the subkeys and values arrays */
+static int compare_names( const WCHAR *name1, data_size_t len1, const WCHAR *name2, data_size_t len2 )
+{
+    int res = memicmpW( name1, name2, min( len1, len2 ) / sizeof(WCHAR) );
+    if (!res) res = len1 - len2;
+    return res;
+}
+
+/* case-insensitive hash of a key or value name */
+static unsigned int hash_name( const WCHAR *name, data_size_t len )
+{
+    unsigned int i, hash = 0;
+
+    for (i = 0; i < len / sizeof(WCHAR); i++) hash = hash * 33 + tolowerW( name[i] );
+    return hash;
+}
+
+/* allocate a hash table big enough for count entries; return NULL on error */
+static int *alloc_hash_table( int *table, unsigned int *size, int count )
+{
+    unsigned int new_size = 2 * count + 1;
+
+    if (!(table = realloc( table, new_size * sizeof(*table) ))) return NULL;
+    *size = new_size;
+    return table;
+}
+
+/* add a subkey to the hash table of its parent */
+static void hash_subkey( struct key *parent, int index )
+{
+    struct key *key = parent->subkeys[index];
+    unsigned int bucket = hash_name( key->name, key->namelen ) % parent->subkey_hash_size;
+
+    key->hash_next = parent->subkey_hash[bucket];
+    parent->subkey_hash[bucket] = index;
+}
+
+/* remove a subkey from the hash table of its parent */
+static void unhash_subkey( struct key *parent, int index )
+{
+    struct key *key = parent->subkeys[index];
+    int *ptr = &parent->subkey_hash[hash_name( key->name, key->namelen ) % parent->subkey_hash_size];
+
+    while (*ptr != index) ptr = &parent->subkeys[*ptr]->hash_next;
+    *ptr = key->hash_next;
+}
+
+/* update the hash table after the subkeys following index have been moved down by one */
+static void shift_subkey_hash( struct key *parent, int index )
+{
+    unsigned int i;
+    int j;
+
+    for (i = 0; i < parent->subkey_hash_size; i++)
+        if (parent->subkey_hash[i] > index) parent->subkey_hash[i]--;
+    for (j = 0; j <= parent->last_subkey; j++)
+        if (parent->subkeys[j]->hash_next > index) parent->subkeys[j]->hash_next--;
+}
+
+/* rebuild the subkeys hash table of a key, growing it if needed */
+static void rehash_subkeys( struct key *key )
+{
+    unsigned int i;
+    int j, *table;
+
+    if (!key->subkey_hash && key->last_subkey + 1 < MIN_HASHED) return;
+    if (key->subkey_hash_size < (key->last_subkey + 1) * 2 &&
+        (table = alloc_hash_table( key->subkey_hash, &key->subkey_hash_size, key->last_subkey + 1 )))
+        key->subkey_hash = table;
+    if (!key->subkey_hash) return;  /* keep using the sorted array */
+
+    for (i = 0; i < key->subkey_hash_size; i++) key->subkey_hash[i] = -1;
+    for (j = 0; j <= key->last_subkey; j++) hash_subkey( key, j );
+}
+
+static int subkey_compare( const void *p1, const void *p2 )
+{
+    const struct key *key1 = *(struct key * const *)p1;
+    const struct key *key2 = *(struct key * const *)p2;
+
+    return compare_names( key1->name, key1->namelen, key2->name, key2->namelen );
+}
+
+/* merge the subkeys appended at the end of the array into the sorted part */
+/* this must be done before accessing the subkeys by index */
+static void sort_subkeys( struct key *key )
+{
+    int i, j, k, count = key->last_subkey + 1 - key->sorted_subkeys;
+    struct key **tail;
+
+    if (!count) return;
+    qsort( key->subkeys + key->sorted_subkeys, count, sizeof(*key->subkeys), subkey_compare );
+    if ((tail = malloc( count * sizeof(*tail) )))
+    {
+        memcpy( tail, key->subkeys + key->sorted_subkeys, count * sizeof(*tail) );
+        i = key->sorted_subkeys - 1;
+        j = count - 1;
+        for (k = key->last_subkey; j >= 0; k--)
+        {
+            if (i >= 0 && subkey_compare( &key->subkeys[i], &tail[j] ) > 0)
+                key->subkeys[k] = key->subkeys[i--];
+            else
+                key->subkeys[k] = tail[j--];
+        }
+        free( tail );
+    }
+    else qsort( key->subkeys, key->last_subkey + 1, sizeof(*key->subkeys), subkey_compare );
+
+    key->sorted_subkeys = key->last_subkey + 1;
+    rehash_subkeys( key );
+}
+
 /* try to grow the array of subkeys; return 1 if OK, 0 on error */
 static int grow_subkeys( struct key *key )
 {
@@ -581,7 +732,6 @@ static struct key *alloc_subkey( struct key *parent, const struct unicode_str *n
                                  int index, timeout_t modif )
 {
     struct key *key;
-    int i;
 
     if (name->len > MAX_NAME_LEN * sizeof(WCHAR))
     {
@@ -596,9 +746,22 @@ static struct key *alloc_subkey( struct key *parent, const struct unicode_str *n
     if ((key = alloc_key( name, modif )) != NULL)
     {
         key->parent = parent;
-        for (i = ++parent->last_subkey; i > index; i--)
-            parent->subkeys[i] = parent->subkeys[i-1];
-        parent->subkeys[index] = key;
+        if (parent->subkey_hash)
+        {
+            /* new subkeys are appended and sorted when enumerated */
+            assert( index == parent->last_subkey + 1 );
+            parent->subkeys[++parent->last_subkey] = key;
+            if (parent->subkey_hash_size < (parent->last_subkey + 1) * 2) rehash_subkeys( parent );
+            else hash_subkey( parent, index );
+        }
+        else
+        {
+            memmove( parent->subkeys + index + 1, parent->subkeys + index,
+                     (++parent->last_subkey - index) * sizeof(*parent->subkeys) );
+            parent->subkeys[index] = key;
+            parent->sorted_subkeys++;
+            if (parent->last_subkey + 1 >= MIN_HASHED) rehash_subkeys( parent );
+        }
         if (is_wow6432node( key->name, key->namelen ) && !is_wow6432node( parent->name, parent->namelen ))
             parent->flags |= KEY_WOW64;
     }
@@ -609,14 +772,19 @@ static struct key *alloc_subkey( struct key *parent, const struct unicode_str *n
 static void free_subkey( struct key *parent, int index )
 {
     struct key *key;
-    int i, nb_subkeys;
+    int nb_subkeys;
 
     assert( index >= 0 );
     assert( index <= parent->last_subkey );
 
     key = parent->subkeys[index];
-    for (i = index; i < parent->last_subkey; i++) parent->subkeys[i] = parent->subkeys[i + 1];
+    if (parent->subkey_hash) unhash_subkey( parent, index );
+    memmove( parent->subkeys + index, parent->subkeys + index + 1,
+             (parent->last_subkey - index) * sizeof(*parent->subkeys) );
     parent->last_subkey--;
+    if (index < parent->sorted_subkeys) parent->sorted_subkeys--;
+    /* the following subkeys have been moved, their hash entries need to be updated */
+    if (parent->subkey_hash && index <= parent->last_subkey) shift_subkey_hash( parent, index );
     key->flags |= KEY_DELETED;
     key->parent = NULL;
     if (is_wow6432node( key->name, key->namelen )) parent->flags &= ~KEY_WOW64;
@@ -639,16 +807,27 @@ static void free_subkey( struct key *parent, int index )
 static struct key *find_subkey( const struct key *key, const struct unicode_str *name, int *index )
 {
     int i, min, max, res;
-    data_size_t len;
+
+    if (key->subkey_hash)
+    {
+        i = key->subkey_hash[hash_name( name->str, name->len ) % key->subkey_hash_size];
+        for ( ; i != -1; i = key->subkeys[i]->hash_next)
+        {
+            if (compare_names( key->subkeys[i]->name, key->subkeys[i]->namelen, name->str, name->len ))
+                continue;
+            *index = i;
+            return key->subkeys[i];
+        }
+        *index = key->last_subkey + 1;  /* new subkeys are appended to the array */
+        return NULL;
+    }
 
     min = 0;
     max = key->last_subkey;
     while (min <= max)
     {
         i = (min + max) / 2;
-        len = min( key->subkeys[i]->namelen, name->len );
-        res = memicmpW( key->subkeys[i]->name, name->str, len / sizeof(WCHAR) );
-        if (!res) res = key->subkeys[i]->namelen - name->len;
+        res = compare_names( key->subkeys[i]->name, key->subkeys[i]->namelen, name->str, name->len );
         if (!res)
         {
             *index = i;
@@ -877,7 +1056,7 @@ static struct key *create_key_recursive( struct key *key, const struct unicode_s
 }
 
 /* query information about a key or a subkey */
-static void enum_key( const struct key *key, int index, int info_class,
+static void enum_key( struct key *key, int index, int info_class,
                       struct enum_key_reply *reply )
 {
     static const WCHAR backslash[] = { '\\' };
@@ -895,6 +1074,7 @@ static void enum_key( const struct key *key, int index, int info_class,
             set_error( STATUS_NO_MORE_ENTRIES );
             return;
         }
+        sort_subkeys( key );
         key = key->subkeys[index];
     }
 
@@ -986,7 +1166,8 @@ static void enum_key( const struct key *key, int index, int info_class,
 static int delete_key( struct key *key, int recurse )
 {
     int index;
-    struct key *parent = key->parent;
+    struct key *parent = key->parent, *subkey;
+    struct unicode_str name;
 
     /* must find parent and index */
     if (key == root_key)
@@ -1000,9 +1181,10 @@ static int delete_key( struct key *key, int recurse )
         if (0 > delete_key(key->subkeys[key->last_subkey], 1))
             return -1;
 
-    for (index = 0; index <= parent->last_subkey; index++)
-        if (parent->subkeys[index] == key) break;
-    assert( index <= parent->last_subkey );
+    name.str = key->name;
+    name.len = key->namelen;
+    subkey = find_subkey( parent, &name, &index );
+    assert( subkey == key );
 
     /* we can only delete a key that has no subkeys */
     if (key->last_subkey >= 0)
@@ -1012,6 +1194,7 @@ static int delete_key( struct key *key, int recurse )
     }
 
     if (debug_level > 1) dump_operation( key, NULL, "Delete" );
+    journal_delete_key( key );
     free_subkey( parent, index );
     touch_key( parent, REG_NOTIFY_CHANGE_NAME );
     return 0;
@@ -1042,20 +1225,116 @@ static int grow_values( struct key *key )
     return 1;
 }
 
+/* add a value to the hash table of its key */
+static void hash_value( struct key *key, int index )
+{
+    struct key_value *value = &key->values[index];
+    unsigned int bucket = hash_name( value->name, value->namelen ) % key->value_hash_size;
+
+    value->hash_next = key->value_hash[bucket];
+    key->value_hash[bucket] = index;
+}
+
+/* remove a value from the hash table of its key */
+static void unhash_value( struct key *key, int index )
+{
+    struct key_value *value = &key->values[index];
+    int *ptr = &key->value_hash[hash_name( value->name, value->namelen ) % key->value_hash_size];
+
+    while (*ptr != index) ptr = &key->values[*ptr].hash_next;
+    *ptr = value->hash_next;
+}
+
+/* update the hash table after the values following index have been moved down by one */
+static void shift_value_hash( struct key *key, int index )
+{
+    unsigned int i;
+    int j;
+
+    for (i = 0; i < key->value_hash_size; i++)
+        if (key->value_hash[i] > index) key->value_hash[i]--;
+    for (j = 0; j <= key->last_value; j++)
+        if (key->values[j].hash_next > index) key->values[j].hash_next--;
+}
+
+/* rebuild the values hash table of a key, growing it if needed */
+static void rehash_values( struct key *key )
+{
+    unsigned int i;
+    int j, *table;
+
+    if (!key->value_hash && key->last_value + 1 < MIN_HASHED) return;
+    if (key->value_hash_size < (key->last_value + 1) * 2 &&
+        (table = alloc_hash_table( key->value_hash, &key->value_hash_size, key->last_value + 1 )))
+        key->value_hash = table;
+    if (!key->value_hash) return;  /* keep using the sorted array */
+
+    for (i = 0; i < key->value_hash_size; i++) key->value_hash[i] = -1;
+    for (j = 0; j <= key->last_value; j++) hash_value( key, j );
+}
+
+static int value_compare( const void *p1, const void *p2 )
+{
+    const struct key_value *value1 = p1;
+    const struct key_value *value2 = p2;
+
+    return compare_names( value1->name, value1->namelen, value2->name, value2->namelen );
+}
+
+/* merge the values appended at the end of the array into the sorted part */
+/* this must be done before accessing the values by index */
+static void sort_values( struct key *key )
+{
+    int i, j, k, count = key->last_value + 1 - key->sorted_values;
+    struct key_value *tail;
+
+    if (!count) return;
+    qsort( key->values + key->sorted_values, count, sizeof(*key->values), value_compare );
+    if ((tail = malloc( count * sizeof(*tail) )))
+    {
+        memcpy( tail, key->values + key->sorted_values, count * sizeof(*tail) );
+        i = key->sorted_values - 1;
+        j = count - 1;
+        for (k = key->last_value; j >= 0; k--)
+        {
+            if (i >= 0 && value_compare( &key->values[i], &tail[j] ) > 0)
+                key->values[k] = key->values[i--];
+            else
+                key->values[k] = tail[j--];
+        }
+        free( tail );
+    }
+    else qsort( key->values, key->last_value + 1, sizeof(*key->values), value_compare );
+
+    key->sorted_values = key->last_value + 1;
+    rehash_values( key );
+}
+
 /* find the named value of a given key and return its index in the array */
 static struct key_value *find_value( const struct key *key, const struct unicode_str *name, int *index )
 {
     int i, min, max, res;
-    data_size_t len;
+
+    if (key->value_hash)
+    {
+        i = key->value_hash[hash_name( name->str, name->len ) % key->value_hash_size];
+        for ( ; i != -1; i = key->values[i].hash_next)
+        {
+            if (compare_names( key->values[i].name, key->values[i].namelen, name->str, name->len ))
+                continue;
+            *index = i;
+            return &key->values[i];
+        }
+        *index = key->last_value + 1;  /* new values are appended to the array */
+        return NULL;
+    }
 
     min = 0;
     max = key->last_value;
     while (min <= max)
     {
         i = (min + max) / 2;
-        len = min( key->values[i].namelen, name->len );
-        res = memicmpW( key->values[i].name, name->str, len / sizeof(WCHAR) );
-        if (!res) res = key->values[i].namelen - name->len;
+        res = compare_names( key->values[i].name, key->values[i].namelen, name->str, name->len );
         if (!res)
         {
             *index = i;
@@ -1073,7 +1352,6 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
 {
     struct key_value *value;
     WCHAR *new_name = NULL;
-    int i;
 
     if (name->len > MAX_VALUE_LEN * sizeof(WCHAR))
     {
@@ -1085,12 +1363,21 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
         if (!grow_values( key )) return NULL;
     }
     if (name->len && !(new_name = memdup( name->str, name->len ))) return NULL;
-    for (i = ++key->last_value; i > index; i--) key->values[i] = key->values[i - 1];
+    if (!key->value_hash)
+    {
+        memmove( key->values + index + 1, key->values + index,
+                 (key->last_value + 1 - index) * sizeof(*key->values) );
+        key->sorted_values++;
+    }
+    else assert( index == key->last_value + 1 );  /* new values are sorted when enumerated */
+    key->last_value++;
     value = &key->values[index];
     value->name    = new_name;
     value->namelen = name->len;
     value->len     = 0;
     value->data    = NULL;
+    if (key->value_hash_size < (key->last_value + 1) * 2) rehash_values( key );
+    else hash_value( key, index );
     return value;
 }
 
@@ -1173,6 +1460,7 @@ static void enum_value( struct key *key, int i, int info_class, struct enum_key_
         void *data;
         data_size_t namelen, maxlen;
 
+        sort_values( key );
         value = &key->values[i];
         reply->type = value->type;
         namelen = value->namelen;
@@ -1217,7 +1505,7 @@ static void enum_value( struct key *key, int i, int info_class, struct enum_key_
 static void delete_value( struct key *key, const struct unicode_str *name )
 {
     struct key_value *value;
-    int i, index, nb_values;
+    int index, nb_values;
 
     if (!(value = find_value( key, name, &index )))
     {
@@ -1225,10 +1513,14 @@ static void delete_value( struct key *key, const struct unicode_str *name )
         return;
     }
     if (debug_level > 1) dump_operation( key, value, "Delete" );
+    if (key->value_hash) unhash_value( key, index );
     free( value->name );
     free( value->data );
-    for (i = index; i < key->last_value; i++) key->values[i] = key->values[i + 1];
+    memmove( key->values + index, key->values + index + 1,
+             (key->last_value - index) * sizeof(*key->values) );
     key->last_value--;
+    if (index < key->sorted_values) key->sorted_values--;
+    if (key->value_hash && index <= key->last_value) shift_value_hash( key, index );
     touch_key( key, REG_NOTIFY_CHANGE_LAST_SET );
 
     /* try to shrink the array */
@@ -1717,25 +2009,43 @@ static void load_registry( struct key *key, obj_handle_t handle )
 /* load one of the initial registry files */
 static int load_init_registry_from_file( const char *filename, struct key *key )
 {
-    FILE *f;
+    struct save_branch_info *info;
+    FILE *f = NULL;
+    int loaded = 0;
+
+    assert( save_branch_count < MAX_SAVE_BRANCH_INFO );
+
+    info = &save_branch_info[save_branch_count];
+    info->path = filename;
+    info->key  = key;
+    if (use_registry_hive)
+    {
+        init_branch_hive( info );
+        loaded = load_hive( info );
+        info->full_save = !loaded;
+    }
 
-    if ((f = fopen( filename, "r" )))
+    if (!loaded && (f = fopen( filename, "r" )))
     {
         load_keys( key, filename, f, 0 );
         fclose( f );
         if (get_error() == STATUS_NOT_REGISTRY_FILE)
         {
             fprintf( stderr, "%s is not a valid registry file\n", filename );
+            if (use_registry_hive)
+            {
+                free( info->hive_path );
+                free( info->journal_path );
+            }
             return 1;
         }
+        loaded = 1;
     }
 
-    assert( save_branch_count < MAX_SAVE_BRANCH_INFO );
-
-    save_branch_info[save_branch_count].path = filename;
-    save_branch_info[save_branch_count++].key = (struct key *)grab_object( key );
+    save_branch_count++;
+    grab_object( key );
     make_object_static( &key->obj );
-    return (f != NULL);
+    return loaded;
 }
 
 static WCHAR *format_user_registry_path( const SID *sid, struct unicode_str *path )
@@ -1811,6 +2121,8 @@ void init_registry(void)
 
     if (fchdir( config_dir_fd ) == -1) fatal_error( "chdir to config dir: %s\n", strerror( errno ));
 
+    if ((p = getenv( "WINEREGISTRYHIVE" ))) use_registry_hive = atoi( p );
+
     /* create the root key */
     root_key = alloc_key( &root_name, current_time );
     assert( root_key );
@@ -1916,19 +2228,37 @@ static void save_registry( struct key *key, obj_handle_t handle )
     }
 }
 
-/* save a registry branch to a file */
-static int save_branch( struct key *key, const char *path )
+/* create a temp file in the same directory as a given file */
+static int create_temp_file( const char *path, char **tmp_ret )
 {
-    struct stat st;
-    char *p, *tmp = NULL;
-    int fd, count = 0, ret = 0;
-    FILE *f;
+    char *p, *tmp;
+    int fd, count = 0;
 
-    if (!(key->flags & KEY_DIRTY))
+    if (!(tmp = malloc( strlen(path) + 20 ))) return -1;
+    strcpy( tmp, path );
+    if ((p = strrchr( tmp, '/' ))) p++;
+    else p = tmp;
+    for (;;)
     {
-        if (debug_level > 1) dump_operation( key, NULL, "Not saving clean" );
-        return 1;
+        sprintf( p, "reg%lx%04x.tmp", (long) getpid(), count++ );
+        if ((fd = open( tmp, O_CREAT | O_EXCL | O_WRONLY, 0666 )) != -1) break;
+        if (errno != EEXIST)
+        {
+            free( tmp );
+            return -1;
+        }
     }
+    *tmp_ret = tmp;
+    return fd;
+}
+
+/* save a registry branch to a text file */
+static int save_text_file( struct key *key, const char *path )
+{
+    struct stat st;
+    char *tmp = NULL;
+    int fd, ret = 0;
+    FILE *f;
 
     /* test the file type */
 
@@ -1946,17 +2276,7 @@ static int save_branch( struct key *key, const char *path )
 
     /* create a temp file in the same directory */
 
-    if (!(tmp = malloc( strlen(path) + 20 ))) goto done;
-    strcpy( tmp, path );
-    if ((p = strrchr( tmp, '/' ))) p++;
-    else p = tmp;
-    for (;;)
-    {
-        sprintf( p, "reg%lx%04x.tmp", (long) getpid(), count++ );
-        if ((fd = open( tmp, O_CREAT | O_EXCL | O_WRONLY, 0666 )) != -1) break;
-        if (errno != EEXIST) goto done;
-        close( fd );
-    }
+    if ((fd = create_temp_file( path, &tmp )) == -1) goto done;
 
     /* now save to it */
 
@@ -1986,10 +2306,711 @@ static int save_branch( struct key *key, const char *path )
 
 done:
     free( tmp );
-    if (ret) make_clean( key );
     return ret;
 }
 
+/* save a registry branch to its file if it has been modified */
+static int save_branch( struct key *key, const char *path )
+{
+    if (!(key->flags & KEY_DIRTY))
+    {
+        if (debug_level > 1) dump_operation( key, NULL, "Not saving clean" );
+        return 1;
+    }
+    if (!save_text_file( key, path )) return 0;
+    make_clean( key );
+    return 1;
+}
+
+/* binary registry hives
+ *
+ * When the WINEREGISTRYHIVE environment variable is set, the registry
+ * branches are also saved in binary hives that can be loaded without any
+ * parsing. A hive contains a hive_header followed by the branch key, saved
+ * as a hive_key structure followed by the key name, class and values, and
+ * then recursively by its subkeys. Each value is saved as a hive_value
+ * structure followed by the value name and data (padded to an even size).
+ *
+ * Between two full saves, the modified keys are appended to a journal. It
+ * contains a journal_header followed by journal_record structures, each of
+ * them followed by the key path relative to the branch key and, for
+ * JOURNAL_KEY records, by the key saved without its subkeys. Each batch of
+ * records ends with a JOURNAL_SYNC record followed by a journal_sync
+ * structure describing the text file saved along with it.
+ *
+ * The hive and its journal are the reference: the periodic saves only append
+ * to the journal, and the text file is only written along with a new hive,
+ * when the journal has grown too large. The hive is only loaded if the text
+ * file is still the one recorded by the hive header and the journal, so that
+ * a text file modified by another program takes precedence.
+ */
+
+#define HIVE_VERSION    2
+#define MAX_HIVE_DEPTH  512
+
+static const char hive_magic[8] = "WINEHIV";
+static const char journal_magic[8] = "WINEJNL";
+
+struct hive_header
+{
+    char          magic[8];     /* hive_magic */
+    unsigned int  version;      /* HIVE_VERSION */
+    unsigned int  arch;         /* prefix type */
+    unsigned int  generation;   /* incremented on every full save */
+    unsigned int  reserved;
+    timeout_t     text_mtime;   /* modification time of the text file when the hive was saved */
+    file_pos_t    text_size;    /* size of the text file when the hive was saved */
+};
+
+struct hive_key
+{
+    timeout_t     modif;        /* last modification time */
+    unsigned int  flags;        /* key flags (only KEY_SYMLINK is saved) */
+    unsigned int  namelen;      /* length of the key name in bytes */
+    unsigned int  classlen;     /* length of the key class in bytes */
+    unsigned int  nb_values;    /* number of values */
+    unsigned int  nb_subkeys;   /* number of subkeys */
+    unsigned int  reserved;
+};
+
+struct hive_value
+{
+    unsigned int  type;         /* value type */
+    unsigned int  namelen;      /* length of the value name in bytes */
+    data_size_t   len;          /* length of the value data in bytes */
+};
+
+struct journal_header
+{
+    char          magic[8];     /* journal_magic */
+    unsigned int  version;      /* HIVE_VERSION */
+    unsigned int  generation;   /* generation of the hive the journal applies to */
+};
+
+enum journal_type
+{
+    JOURNAL_KEY,                /* key created or modified */
+    JOURNAL_DELETE,             /* key deleted */
+    JOURNAL_SYNC                /* text file saved */
+};
+
+struct journal_record
+{
+    unsigned int  type;         /* record type */
+    data_size_t   pathlen;      /* length of the key path in bytes */
+};
+
+struct journal_sync
+{
+    timeout_t     text_mtime;   /* modification time of the text file once saved */
+    file_pos_t    text_size;    /* size of the text file once saved */
+};
+
+struct deleted_key
+{
+    struct list   entry;        /* entry in the deleted list of the branch */
+    data_size_t   len;          /* length of the key path in bytes */
+    WCHAR         path[1];      /* key path relative to the branch key */
+};
+
+struct hive_reader
+{
+    const char   *ptr;          /* current position */
+    const char   *end;          /* end of the data */
+};
+
+/* return the saved branch containing a key */
+static struct save_branch_info *get_key_branch( const struct key *key )
+{
+    int i;
+
+    for ( ; key; key = key->parent)
+        for (i = 0; i < save_branch_count; i++)
+            if (save_branch_info[i].key == key) return &save_branch_info[i];
+    return NULL;
+}
+
+/* return the length of the path of a key relative to a base key */
+static data_size_t get_relative_path_len( const struct key *key, const struct key *base )
+{
+    data_size_t len = 0;
+
+    for ( ; key != base; key = key->parent) len += key->namelen + sizeof(WCHAR);
+    return len ? len - sizeof(WCHAR) : 0;
+}
+
+/* remember a deleted key so that its deletion gets written to the journal */
+static void journal_delete_key( const struct key *key )
+{
+    struct save_branch_info *branch;
+    struct deleted_key *deleted;
+    const struct key *k;
+    data_size_t len;
+    WCHAR *p;
+
+    if (!use_registry_hive || loading_journal || (key->flags & KEY_VOLATILE)) return;
+    if (!(branch = get_key_branch( key )) || branch->key == key) return;
+
+    len = get_relative_path_len( key, branch->key );
+    if (!(deleted = mem_alloc( offsetof( struct deleted_key, path[len / sizeof(WCHAR)] ))))
+    {
+        branch->full_save = 1;
+        clear_error();
+        return;
+    }
+    deleted->len = len;
+    p = deleted->path + len / sizeof(WCHAR);
+    for (k = key; k != branch->key; k = k->parent)
+    {
+        p -= k->namelen / sizeof(WCHAR);
+        memcpy( p, k->name, k->namelen );
+        if (p > deleted->path) *--p = '\\';
+    }
+    list_add_tail( &branch->deleted, &deleted->entry );
+}
+
+/* free the deleted keys of a branch once they have been saved */
+static void free_deleted_keys( struct save_branch_info *branch )
+{
+    struct deleted_key *deleted, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( deleted, next, &branch->deleted, struct deleted_key, entry )
+    {
+        list_remove( &deleted->entry );
+        free( deleted );
+    }
+}
+
+/* free all the values of a key */
+static void clear_values( struct key *key )
+{
+    int i;
+
+    for (i = 0; i <= key->last_value; i++)
+    {
+        free( key->values[i].name );
+        free( key->values[i].data );
+    }
+    key->last_value = -1;
+    key->sorted_values = 0;
+    if (key->value_hash) rehash_values( key );
+}
+
+/* map a whole file in memory */
+static void *map_file( const char *path, size_t *size )
+{
+    struct stat st;
+    void *ptr = NULL;
+    int fd;
+
+    if ((fd = open( path, O_RDONLY )) == -1) return NULL;
+    if (!fstat( fd, &st ) && st.st_size > 0 && st.st_size == (size_t)st.st_size)
+    {
+        ptr = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if (ptr == MAP_FAILED) ptr = NULL;
+        else *size = st.st_size;
+    }
+    close( fd );
+    return ptr;
+}
+
+/* get the next bytes from a hive, return NULL if not enough data */
+static const void *read_hive_data( struct hive_reader *reader, size_t size )
+{
+    const char *ret = reader->ptr;
+
+    if (size > (size_t)(reader->end - reader->ptr)) return NULL;
+    reader->ptr += size;
+    return ret;
+}
+
+/* load the class, values and subkeys of a key from a hive; return 0 on error */
+static int load_hive_key( struct key *key, const struct hive_key *hdr, struct hive_reader *reader, int depth )
+{
+    struct hive_key subkey_hdr;
+    struct hive_value value_hdr;
+    struct key_value *value;
+    struct unicode_str name;
+    struct key *subkey;
+    const void *ptr, *data;
+    unsigned int i;
+    int index;
+
+    if (depth > MAX_HIVE_DEPTH) return 0;
+    if (!(ptr = read_hive_data( reader, hdr->classlen ))) return 0;
+    if (hdr->classlen)
+    {
+        free( key->class );
+        key->classlen = 0;
+        if (!(key->class = memdup( ptr, hdr->classlen ))) return 0;
+        key->classlen = hdr->classlen;
+    }
+    key->flags |= hdr->flags & KEY_SYMLINK;
+    key->modif = hdr->modif;
+
+    for (i = 0; i < hdr->nb_values; i++)
+    {
+        if (!(ptr = read_hive_data( reader, sizeof(value_hdr) ))) return 0;
+        memcpy( &value_hdr, ptr, sizeof(value_hdr) );
+        if (value_hdr.namelen & 1) return 0;
+        if (!(name.str = read_hive_data( reader, value_hdr.namelen ))) return 0;
+        name.len = value_hdr.namelen;
+        if (!(data = read_hive_data( reader, (size_t)value_hdr.len + (value_hdr.len & 1) ))) return 0;
+
+        if (!(value = find_value( key, &name, &index )) && !(value = insert_value( key, &name, index )))
+            return 0;
+        free( value->data );
+        value->type = value_hdr.type;
+        value->len  = 0;
+        value->data = NULL;
+        if (value_hdr.len && !(value->data = memdup( data, value_hdr.len ))) return 0;
+        value->len  = value_hdr.len;
+    }
+
+    for (i = 0; i < hdr->nb_subkeys; i++)
+    {
+        if (!(ptr = read_hive_data( reader, sizeof(subkey_hdr) ))) return 0;
+        memcpy( &subkey_hdr, ptr, sizeof(subkey_hdr) );
+        if ((subkey_hdr.namelen | subkey_hdr.classlen) & 1) return 0;
+        if (!(name.str = read_hive_data( reader, subkey_hdr.namelen ))) return 0;
+        name.len = subkey_hdr.namelen;
+
+        if (!(subkey = find_subkey( key, &name, &index )) &&
+            !(subkey = alloc_subkey( key, &name, index, subkey_hdr.modif )))
+            return 0;
+        if (!load_hive_key( subkey, &subkey_hdr, reader, depth + 1 )) return 0;
+    }
+    return 1;
+}
+
+/* find the key of a journal record, optionally creating it */
+static struct key *get_journal_key( struct key *key, const WCHAR *path, data_size_t len, int create )
+{
+    struct unicode_str name;
+    struct key *subkey;
+    data_size_t i, start = 0;
+    int index;
+
+    len /= sizeof(WCHAR);
+    for (i = 0; i <= len; i++)
+    {
+        if (i < len && path[i] != '\\') continue;
+        name.str = path + start;
+        name.len = (i - start) * sizeof(WCHAR);
+        start = i + 1;
+        if (!name.len) continue;
+        if (!(subkey = find_subkey( key, &name, &index )))
+        {
+            if (!create) return NULL;
+            if (!(subkey = alloc_subkey( key, &name, index, current_time ))) return NULL;
+        }
+        key = subkey;
+    }
+    return key;
+}
+
+/* apply the modifications saved in the journal of a branch to the keys loaded from its hive */
+/* return 1 if the text file hasn't been modified since the journal was written */
+static int replay_journal( struct save_branch_info *branch, struct key *branch_key,
+                           int synced, const struct stat *st )
+{
+    struct journal_header header;
+    struct journal_record record;
+    struct journal_sync sync;
+    struct hive_reader reader;
+    struct hive_key hdr;
+    const WCHAR *path;
+    const void *ptr;
+    struct key *key;
+    unsigned int count = 0;
+    size_t size;
+    void *base;
+
+    branch->journal_size = 0;
+    if (!(base = map_file( branch->journal_path, &size ))) return synced;
+
+    reader.ptr = base;
+    reader.end = reader.ptr + size;
+    if (!(ptr = read_hive_data( &reader, sizeof(header) ))) goto done;
+    memcpy( &header, ptr, sizeof(header) );
+    if (memcmp( header.magic, journal_magic, sizeof(journal_magic) ) ||
+        header.version != HIVE_VERSION || header.generation != branch->generation)
+        goto done;  /* stale journal of a previous hive */
+
+    loading_journal = 1;
+    while ((ptr = read_hive_data( &reader, sizeof(record) )))
+    {
+        memcpy( &record, ptr, sizeof(record) );
+        if ((record.pathlen & 1) || !(path = read_hive_data( &reader, record.pathlen ))) break;
+
+        if (record.type == JOURNAL_DELETE)
+        {
+            if ((key = get_journal_key( branch_key, path, record.pathlen, 0 )) && key != branch_key)
+                delete_key( key, 1 );
+        }
+        else if (record.type == JOURNAL_KEY)
+        {
+            if (!(ptr = read_hive_data( &reader, sizeof(hdr) ))) break;
+            memcpy( &hdr, ptr, sizeof(hdr) );
+            if (((hdr.namelen | hdr.classlen) & 1) || hdr.nb_subkeys) break;
+            if (!read_hive_data( &reader, hdr.namelen )) break;
+            if (!(key = get_journal_key( branch_key, path, record.pathlen, 1 ))) break;
+            clear_values( key );
+            if (!load_hive_key( key, &hdr, &reader, 0 )) break;
+        }
+        else if (record.type == JOURNAL_SYNC)
+        {
+            if (record.pathlen || !(ptr = read_hive_data( &reader, sizeof(sync) ))) break;
+            memcpy( &sync, ptr, sizeof(sync) );
+            synced = (sync.text_mtime == st->st_mtime && sync.text_size == st->st_size);
+        }
+        else break;
+        count++;
+    }
+    loading_journal = 0;
+
+    /* a truncated journal can't be appended to */
+    if (reader.ptr == reader.end) branch->journal_size = size;
+    if (debug_level) fprintf( stderr, "wineserver: replayed %u records from %s\n", count, branch->journal_path );
+
+done:
+    munmap( base, size );
+    clear_error();
+    return synced;
+}
+
+/* move the contents of a key loaded from a hive to the empty key of its branch */
+static void attach_hive_key( struct key *branch_key, struct key *key )
+{
+    int i;
+
+    free( branch_key->class );
+    free( branch_key->subkeys );
+    free( branch_key->subkey_hash );
+    free( branch_key->values );
+    free( branch_key->value_hash );
+
+    branch_key->class            = key->class;
+    branch_key->classlen         = key->classlen;
+    branch_key->flags           |= key->flags & (KEY_SYMLINK | KEY_WOW64);
+    branch_key->modif            = key->modif;
+    branch_key->last_subkey      = key->last_subkey;
+    branch_key->nb_subkeys       = key->nb_subkeys;
+    branch_key->subkeys          = key->subkeys;
+    branch_key->sorted_subkeys   = key->sorted_subkeys;
+    branch_key->subkey_hash      = key->subkey_hash;
+    branch_key->subkey_hash_size = key->subkey_hash_size;
+    branch_key->last_value       = key->last_value;
+    branch_key->nb_values        = key->nb_values;
+    branch_key->values           = key->values;
+    branch_key->sorted_values    = key->sorted_values;
+    branch_key->value_hash       = key->value_hash;
+    branch_key->value_hash_size  = key->value_hash_size;
+    for (i = 0; i <= branch_key->last_subkey; i++) branch_key->subkeys[i]->parent = branch_key;
+
+    key->class            = NULL;
+    key->classlen         = 0;
+    key->last_subkey      = -1;
+    key->nb_subkeys       = 0;
+    key->subkeys          = NULL;
+    key->sorted_subkeys   = 0;
+    key->subkey_hash      = NULL;
+    key->subkey_hash_size = 0;
+    key->last_value       = -1;
+    key->nb_values        = 0;
+    key->values           = NULL;
+    key->sorted_values    = 0;
+    key->value_hash       = NULL;
+    key->value_hash_size  = 0;
+}
+
+/* load a registry branch from its hive; return 0 if the text file must be loaded instead */
+static int load_hive( struct save_branch_info *branch )
+{
+    struct hive_header header;
+    struct hive_reader reader;
+    struct hive_key hdr;
+    struct unicode_str name;
+    struct key *key = NULL;
+    struct stat st;
+    const void *ptr;
+    size_t size;
+    void *base;
+    int synced, ret = 0;
+
+    /* the branch key must not contain anything that the text file would replace */
+    if (branch->key->last_subkey != -1 || branch->key->last_value != -1) return 0;
+    if (stat( branch->path, &st ) == -1) return 0;
+    if (!(base = map_file( branch->hive_path, &size ))) return 0;
+
+    reader.ptr = base;
+    reader.end = reader.ptr + size;
+    if (!(ptr = read_hive_data( &reader, sizeof(header) ))) goto done;
+    memcpy( &header, ptr, sizeof(header) );
+    if (memcmp( header.magic, hive_magic, sizeof(hive_magic) ) || header.version != HIVE_VERSION) goto done;
+
+    if (header.arch != PREFIX_32BIT && header.arch != PREFIX_64BIT) goto done;
+    if (prefix_type != PREFIX_UNKNOWN && prefix_type != header.arch) goto done;
+
+    /* load the hive into a separate key so that nothing remains of it if it can't be used */
+    name.str = branch->key->name;
+    name.len = branch->key->namelen;
+    if (!(key = alloc_key( &name, branch->key->modif ))) goto done;
+
+    if (!(ptr = read_hive_data( &reader, sizeof(hdr) ))) goto done;
+    memcpy( &hdr, ptr, sizeof(hdr) );
+    if (((hdr.namelen | hdr.classlen) & 1) || !read_hive_data( &reader, hdr.namelen ) ||
+        !load_hive_key( key, &hdr, &reader, 0 ))
+    {
+        fprintf( stderr, "wineserver: %s is corrupted, loading %s instead\n",
+                 branch->hive_path, branch->path );
+        goto done;
+    }
+
+    branch->generation = header.generation;
+    branch->hive_size  = size;
+    synced = (header.text_mtime == st.st_mtime && header.text_size == st.st_size);
+
+    /* the text file has been modified since the hive or the journal was saved */
+    if (!replay_journal( branch, key, synced, &st )) goto done;
+
+    make_clean( key );
+    attach_hive_key( branch->key, key );
+    prefix_type = header.arch;
+    if (debug_level) fprintf( stderr, "wineserver: loaded %s\n", branch->hive_path );
+    ret = 1;
+
+done:
+    if (key) release_object( key );
+    munmap( base, size );
+    clear_error();
+    return ret;
+}
+
+/* save a key to a hive, with its subkeys if recurse is set */
+static void save_hive_key( struct key *key, FILE *f, int recurse )
+{
+    static const char pad;
+    struct hive_value value_hdr;
+    struct hive_key hdr;
+    int i;
+
+    sort_values( key );
+    memset( &hdr, 0, sizeof(hdr) );
+    hdr.modif     = key->modif;
+    hdr.flags     = key->flags & KEY_SYMLINK;
+    hdr.namelen   = key->namelen;
+    hdr.classlen  = key->classlen;
+    hdr.nb_values = key->last_value + 1;
+    if (recurse)
+    {
+        sort_subkeys( key );
+        for (i = 0; i <= key->last_subkey; i++)
+            if (!(key->subkeys[i]->flags & KEY_VOLATILE)) hdr.nb_subkeys++;
+    }
+
+    fwrite( &hdr, sizeof(hdr), 1, f );
+    if (key->namelen) fwrite( key->name, key->namelen, 1, f );
+    if (key->classlen) fwrite( key->class, key->classlen, 1, f );
+    for (i = 0; i <= key->last_value; i++)
+    {
+        const struct key_value *value = &key->values[i];
+
+        value_hdr.type    = value->type;
+        value_hdr.namelen = value->namelen;
+        value_hdr.len     = value->len;
+        fwrite( &value_hdr, sizeof(value_hdr), 1, f );
+        if (value->namelen) fwrite( value->name, value->namelen, 1, f );
+        if (value->len) fwrite( value->data, value->len, 1, f );
+        if (value->len & 1) fwrite( &pad, 1, 1, f );
+    }
+
+    if (!recurse) return;
+    for (i = 0; i <= key->last_subkey; i++)
+        if (!(key->subkeys[i]->flags & KEY_VOLATILE)) save_hive_key( key->subkeys[i], f, 1 );
+}
+
+/* write the path of a key relative to a base key */
+static void save_key_path( const struct key *key, const struct key *base, FILE *f )
+{
+    static const WCHAR backslash = '\\';
+
+    if (key->parent != base)
+    {
+        save_key_path( key->parent, base, f );
+        fwrite( &backslash, sizeof(backslash), 1, f );
+    }
+    fwrite( key->name, key->namelen, 1, f );
+}
+
+/* write the keys modified since the last save to a journal */
+static void save_journal_keys( struct key *key, const struct key *base, FILE *f )
+{
+    struct journal_record record;
+    int i;
+
+    if (key->flags & KEY_VOLATILE) return;
+    if (!(key->flags & KEY_DIRTY)) return;
+
+    record.type    = JOURNAL_KEY;
+    record.pathlen = get_relative_path_len( key, base );
+    fwrite( &record, sizeof(record), 1, f );
+    if (key != base) save_key_path( key, base, f );
+    save_hive_key( key, f, 0 );
+    for (i = 0; i <= key->last_subkey; i++) save_journal_keys( key->subkeys[i], base, f );
+}
+
+/* append the modifications of a branch to its journal */
+static int save_journal( struct save_branch_info *branch, const struct stat *text_st )
+{
+    struct journal_record record;
+    struct journal_sync sync;
+    struct deleted_key *deleted;
+    struct stat st;
+    FILE *f;
+    int fd;
+
+    if ((fd = open( branch->journal_path, O_WRONLY | O_APPEND )) == -1) return 0;
+    if (!(f = fdopen( fd, "a" )))
+    {
+        close( fd );
+        return 0;
+    }
+
+    LIST_FOR_EACH_ENTRY( deleted, &branch->deleted, struct deleted_key, entry )
+    {
+        record.type    = JOURNAL_DELETE;
+        record.pathlen = deleted->len;
+        fwrite( &record, sizeof(record), 1, f );
+        fwrite( deleted->path, deleted->len, 1, f );
+    }
+    save_journal_keys( branch->key, branch->key, f );
+
+    record.type     = JOURNAL_SYNC;
+    record.pathlen  = 0;
+    sync.text_mtime = text_st->st_mtime;
+    sync.text_size  = text_st->st_size;
+    fwrite( &record, sizeof(record), 1, f );
+    fwrite( &sync, sizeof(sync), 1, f );
+
+    if (fflush( f ) || fstat( fd, &st ) == -1)
+    {
+        fclose( f );
+        return 0;
+    }
+    branch->journal_size = st.st_size;
+    if (fclose( f )) return 0;
+    free_deleted_keys( branch );
+    return 1;
+}
+
+/* save a whole registry branch to its hive and start a new journal */
+static int save_hive( struct save_branch_info *branch, const struct stat *text_st )
+{
+    struct journal_header journal;
+    struct hive_header header;
+    char *tmp;
+    FILE *f;
+    int fd, ret;
+
+    if ((fd = create_temp_file( branch->hive_path, &tmp )) == -1) return 0;
+    if (!(f = fdopen( fd, "w" )))
+    {
+        close( fd );
+        unlink( tmp );
+        free( tmp );
+        return 0;
+    }
+
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, hive_magic, sizeof(hive_magic) );
+    header.version     = HIVE_VERSION;
+    header.arch        = prefix_type;
+    header.generation  = branch->generation + 1;
+    header.text_mtime  = text_st->st_mtime;
+    header.text_size   = text_st->st_size;
+
+    if (debug_level > 1)
+    {
+        fprintf( stderr, "%s: ", branch->hive_path );
+        dump_operation( branch->key, NULL, "saving" );
+    }
+
+    fwrite( &header, sizeof(header), 1, f );
+    save_hive_key( branch->key, f, 1 );
+    branch->hive_size = ftell( f );
+    ret = !fclose( f );
+    if (ret) ret = !rename( tmp, branch->hive_path );
+    if (!ret) unlink( tmp );
+    free( tmp );
+    if (!ret) return 0;
+
+    /* the previous journal doesn't apply to the new hive */
+    branch->generation++;
+    branch->journal_size = 0;
+    memset( &journal, 0, sizeof(journal) );
+    memcpy( journal.magic, journal_magic, sizeof(journal_magic) );
+    journal.version    = HIVE_VERSION;
+    journal.generation = branch->generation;
+    if ((fd = open( branch->journal_path, O_WRONLY | O_CREAT | O_TRUNC, 0666 )) != -1)
+    {
+        if (write( fd, &journal, sizeof(journal) ) == sizeof(journal))
+            branch->journal_size = sizeof(journal);
+        close( fd );
+    }
+
+    free_deleted_keys( branch );
+    branch->full_save = 0;
+    return 1;
+}
+
+/* save the modifications of a registry branch to its journal, or to a new hive and text file */
+static int save_branch_hive( struct save_branch_info *branch )
+{
+    struct stat st;
+
+    if (!(branch->key->flags & KEY_DIRTY) && list_empty( &branch->deleted ) && !branch->full_save)
+    {
+        if (debug_level > 1) dump_operation( branch->key, NULL, "Not saving clean" );
+        return 1;
+    }
+
+    if (stat( branch->path, &st ) == -1) memset( &st, 0, sizeof(st) );
+
+    /* rewrite the hive along with the text file once the journal becomes too large */
+    if (branch->full_save || !branch->journal_size || branch->journal_size > branch->hive_size / 2 ||
+        !save_journal( branch, &st ))
+    {
+        if (!save_text_file( branch->key, branch->path )) return 0;
+        if (stat( branch->path, &st ) == -1) memset( &st, 0, sizeof(st) );
+        /* the text file is saved, the hive will be rewritten on the next save */
+        if (!save_hive( branch, &st )) branch->full_save = 1;
+    }
+    make_clean( branch->key );
+    return 1;
+}
+
+/* initialize the hive information of a registry branch */
+static void init_branch_hive( struct save_branch_info *branch )
+{
+    size_t len = strlen( branch->path );
+
+    if (len > 4 && !strcmp( branch->path + len - 4, ".reg" )) len -= 4;
+    if (!(branch->hive_path = malloc( len + sizeof(".hiv") )) ||
+        !(branch->journal_path = malloc( len + sizeof(".hiv.log") )))
+        fatal_error( "out of memory\n" );
+    memcpy( branch->hive_path, branch->path, len );
+    strcpy( branch->hive_path + len, ".hiv" );
+    memcpy( branch->journal_path, branch->path, len );
+    strcpy( branch->journal_path + len, ".hiv.log" );
+    branch->generation   = 0;
+    branch->hive_size    = 0;
+    branch->journal_size = 0;
+    branch->full_save    = 0;
+    list_init( &branch->deleted );
+}
+
+
 /* periodic saving of the registry */
 static void periodic_save( void *arg )
 {
@@ -1998,7 +3019,10 @@ static void periodic_save( void *arg )
     if (fchdir( config_dir_fd ) == -1) return;
     save_timeout_user = NULL;
     for (i = 0; i < save_branch_count; i++)
-        save_branch( save_branch_info[i].key, save_branch_info[i].path );
+    {
+        if (use_registry_hive) save_branch_hive( &save_branch_info[i] );
+        else save_branch( save_branch_info[i].key, save_branch_info[i].path );
+    }
     if (fchdir( server_dir_fd ) == -1) fatal_error( "chdir to server dir: %s\n", strerror( errno ));
     set_periodic_save_timer();
 }
@@ -2018,7 +3042,8 @@ void flush_registry(void)
     if (fchdir( config_dir_fd ) == -1) return;
     for (i = 0; i < save_branch_count; i++)
     {
-        if (!save_branch( save_branch_info[i].key, save_branch_info[i].path ))
+        if (!(use_registry_hive ? save_branch_hive( &save_branch_info[i] ) :
+              save_branch( save_branch_info[i].key, save_branch_info[i].path )))
         {
             fprintf( stderr, "wineserver: could not save registry branch to %s",
                      save_branch_info[i].path );
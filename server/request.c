@@ -371,6 +371,99 @@ error:
         fatal_protocol_error( thread, "read: %s\n", strerror( errno ));
 }
 
+/* check if a request can be part of a batch */
+/* it must not block, pass file descriptors, or need any client-side processing of its reply */
+static int is_batch_request( enum request req )
+{
+    switch (req)
+    {
+    case REQ_open_key:
+    case REQ_enum_key:
+    case REQ_get_key_value:
+    case REQ_enum_key_value:
+    case REQ_query_symlink:
+    case REQ_get_object_info:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* process a batch of requests, storing all the replies in the batch reply */
+DECL_HANDLER(batch)
+{
+    static unsigned int nb_batches, nb_batched_requests;
+    struct thread *thread = current;
+    union generic_request batch_req = thread->req;
+    void *batch_data = thread->req_data;
+    const char *ptr = get_req_data(), *end = ptr + get_req_data_size();
+    data_size_t max_size = get_reply_max_size(), pos = 0;
+    unsigned int i, count = req->count;  /* req points to thread->req, which gets overwritten */
+    char *replies = NULL;
+
+    if (max_size && !(replies = mem_alloc( max_size ))) return;
+
+    for (i = 0; i < count; i++)
+    {
+        union generic_reply sub_reply;
+        enum request sub;
+
+        if (end - ptr < sizeof(thread->req)) break;
+        memcpy( &thread->req, ptr, sizeof(thread->req) );
+        ptr += sizeof(thread->req);
+        if (end - ptr < thread->req.request_header.request_size) break;
+        if (max_size - pos < sizeof(sub_reply) + thread->req.request_header.reply_size) break;
+
+        thread->req_data = (void *)ptr;
+        ptr += thread->req.request_header.request_size;
+        thread->reply_size = 0;
+        thread->reply_data = NULL;
+        clear_error();
+        memset( &sub_reply, 0, sizeof(sub_reply) );
+
+        if (debug_level) trace_request();
+
+        sub = thread->req.request_header.req;
+        if (is_batch_request( sub ))
+            req_handlers[sub]( &thread->req, &sub_reply );
+        else
+            set_error( STATUS_NOT_SUPPORTED );
+
+        if (!current) break;  /* the thread has been killed */
+
+        sub_reply.reply_header.error = thread->error;
+        sub_reply.reply_header.reply_size = thread->reply_size;
+        if (debug_level) trace_reply( sub, &sub_reply );
+        memcpy( replies + pos, &sub_reply, sizeof(sub_reply) );
+        pos += sizeof(sub_reply);
+        if (thread->reply_size) memcpy( replies + pos, thread->reply_data, thread->reply_size );
+        pos += thread->reply_size;
+        free( thread->reply_data );
+        thread->reply_data = NULL;
+    }
+
+    thread->req = batch_req;
+    thread->req_data = batch_data;
+    if (!current)
+    {
+        free( replies );
+        return;
+    }
+
+    nb_batches++;
+    nb_batched_requests += i;
+    if (debug_level)
+        fprintf( stderr, "%04x: *batch* %u requests, average batch size %.2f\n", current->id, i,
+                 (double)nb_batched_requests / nb_batches );
+
+    clear_error();
+    reply->count = i;
+    thread->reply_size = 0;
+    if (pos) set_reply_data_ptr( replies, pos );
+    else free( replies );
+    if (i < count) set_error( STATUS_INVALID_PARAMETER );
+}
+
 /* receive a file descriptor on the process socket */
 int receive_fd( struct process *process )
 {
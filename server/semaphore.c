@@ -38,9 +38,11 @@
 
 struct semaphore
 {
-    struct object  obj;    /* object header */
-    unsigned int   count;  /* current count */
-    unsigned int   max;    /* maximum possible count */
+    struct object      obj;            /* object header */
+    unsigned int       max;            /* maximum possible count */
+    int                fast_index;     /* index in the fast synchronization region, or -1 */
+    fast_sync_state_t *state;          /* current count, either shared or private */
+    fast_sync_state_t  private_state;  /* private count when not using the shared region */
 };
 
 static void semaphore_dump( struct object *obj, int verbose );
@@ -49,6 +51,7 @@ static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entr
 static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static unsigned int semaphore_map_access( struct object *obj, unsigned int access );
 static int semaphore_signal( struct object *obj, unsigned int access );
+static void semaphore_destroy( struct object *obj );
 
 static const struct object_ops semaphore_ops =
 {
@@ -69,7 +72,7 @@ static const struct object_ops semaphore_ops =
     default_unlink_name,           /* unlink_name */
     no_open_file,                  /* open_file */
     no_close_handle,               /* close_handle */
-    no_destroy                     /* destroy */
+    semaphore_destroy              /* destroy */
 };
 
 
@@ -89,8 +92,13 @@ static struct semaphore *create_semaphore( struct object *root, const struct uni
         if (get_error() != STATUS_OBJECT_NAME_EXISTS)
         {
             /* initialize it if it didn't already exist */
-            sem->count = initial;
-            sem->max   = max;
+            sem->max           = max;
+            sem->private_state = 0;
+            if ((sem->fast_index = alloc_fast_sync_index()) != -1)
+                sem->state = get_fast_sync_state( sem->fast_index );
+            else
+                sem->state = &sem->private_state;
+            fast_sync_set_count( sem->state, initial );
         }
     }
     return sem;
@@ -99,30 +107,36 @@ static struct semaphore *create_semaphore( struct object *root, const struct uni
 static int release_semaphore( struct semaphore *sem, unsigned int count,
                               unsigned int *prev )
 {
-    if (prev) *prev = sem->count;
-    if (sem->count + count < sem->count || sem->count + count > sem->max)
+    unsigned int old_count;
+
+    if (!fast_sync_add_count( sem->state, count, sem->max, &old_count ))
     {
+        if (prev) *prev = old_count;
         set_error( STATUS_SEMAPHORE_LIMIT_EXCEEDED );
         return 0;
     }
-    else if (sem->count)
-    {
-        /* there cannot be any thread to wake up if the count is != 0 */
-        sem->count += count;
-    }
-    else
-    {
-        sem->count = count;
-        wake_up( &sem->obj, count );
-    }
+    if (prev) *prev = old_count;
+    /* there cannot be any thread to wake up if the count was != 0 */
+    if (!old_count) wake_up( &sem->obj, count );
     return 1;
 }
 
+/* return the fast synchronization type and index of a semaphore object */
+int get_semaphore_fast_sync( struct object *obj, int *index, unsigned int *max )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+
+    if (obj->ops != &semaphore_ops || sem->fast_index == -1) return FAST_SYNC_NONE;
+    *index = sem->fast_index;
+    *max = sem->max;
+    return FAST_SYNC_SEMAPHORE;
+}
+
 static void semaphore_dump( struct object *obj, int verbose )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    fprintf( stderr, "Semaphore count=%d max=%d\n", sem->count, sem->max );
+    fprintf( stderr, "Semaphore count=%d max=%d\n", fast_sync_get_count( sem->state ), sem->max );
 }
 
 static struct object_type *semaphore_get_type( struct object *obj )
@@ -136,15 +150,16 @@ static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entr
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    return (sem->count > 0);
+    return fast_sync_get_count( sem->state ) > 0;
 }
 
 static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *entry )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    assert( sem->count );
-    sem->count--;
+    /* clients never decrement the count while we have waiters, so it cannot drop to 0 here */
+    assert( fast_sync_get_count( sem->state ) );
+    fast_sync_dec_count( sem->state );
 }
 
 static unsigned int semaphore_map_access( struct object *obj, unsigned int access )
@@ -169,6 +184,13 @@ static int semaphore_signal( struct object *obj, unsigned int access )
     return release_semaphore( sem, 1, NULL );
 }
 
+static void semaphore_destroy( struct object *obj )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    free_fast_sync_index( sem->fast_index );
+}
+
 /* create a semaphore */
 DECL_HANDLER(create_semaphore)
 {
@@ -223,7 +245,7 @@ DECL_HANDLER(query_semaphore)
     if ((sem = (struct semaphore *)get_handle_obj( current->process, req->handle,
                                                    SEMAPHORE_QUERY_STATE, &semaphore_ops )))
     {
-        reply->current = sem->count;
+        reply->current = fast_sync_get_count( sem->state );
         reply->max = sem->max;
         release_object( sem );
     }
@@ -23,6 +23,8 @@
 
 #include <assert.h>
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -33,6 +35,8 @@
 #include "winternl.h"
 
 #include "object.h"
+#include "file.h"
+#include "handle.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -73,6 +77,10 @@ struct window
     rectangle_t      client_rect;     /* client rectangle (relative to parent client area) */
     struct region   *win_region;      /* region for shaped windows (relative to window rect) */
     struct region   *update_region;   /* update region (relative to window rect) */
+    struct region   *vis_cache;       /* cached visible region (relative to window) */
+    unsigned int     vis_cache_flags; /* DCX flags used to compute the cached region */
+    int              vis_cache_valid; /* is the cached region up to date? */
+    struct child_index *child_index;  /* spatial index of the children, built on demand */
     unsigned int     style;           /* window style */
     unsigned int     ex_style;        /* window extended style */
     unsigned int     id;              /* window id */
@@ -104,6 +112,43 @@ struct window
 #define PAINT_DELAYED_ERASE      0x0080  /* still needs erase after WM_ERASEBKGND */
 #define PAINT_PIXEL_FORMAT_CHILD 0x0100  /* at least one child has a custom pixel format */
 
+/* Windows with many children keep a grid over the visible rectangles of
+ * their children, so that hit-testing only needs to look at the children
+ * overlapping the grid cell of the point. Each cell lists its children in
+ * z-order, so the first match is the same as with a walk of the children
+ * list. The index only depends on the children list order and on their
+ * visible rectangles; it is freed when they change and rebuilt on the next
+ * hit-test. */
+
+#define MIN_INDEXED_CHILDREN 32  /* don't bother with an index for fewer children */
+#define MAX_INDEX_GRID_SIZE  64  /* maximum number of rows and columns of the grid */
+
+struct child_index
+{
+    unsigned int     count;        /* number of children */
+    struct window  **children;     /* children in z-order */
+    rectangle_t      bounds;       /* bounding rectangle of all the children */
+    int              cols;         /* number of grid columns, 0 if the grid isn't used */
+    int              rows;         /* number of grid rows */
+    unsigned int     cell_width;   /* width of a grid cell */
+    unsigned int     cell_height;  /* height of a grid cell */
+    unsigned int    *cell_start;   /* start of each cell in the items array */
+    unsigned int    *items;        /* indices in the children array for each cell */
+};
+
+/* iterator over the children that may contain a point */
+struct child_iter
+{
+    struct window      *parent;    /* parent window */
+    struct child_index *index;     /* index of the parent, if used */
+    unsigned int        pos;       /* current position in the index items */
+    unsigned int        end;       /* end of the cell in the index items */
+    struct list        *entry;     /* current entry in the children list without index */
+};
+
+/* flags that change the result of get_visible_region */
+#define VIS_CACHE_FLAGS          (DCX_WINDOW | DCX_PARENTCLIP | DCX_CLIPCHILDREN)
+
 /* growable array of user handles */
 struct user_handle_array
 {
@@ -118,6 +163,26 @@ static struct window *shell_listview;
 static struct window *progman_window;
 static struct window *taskman_window;
 
+/* When the WINEFASTWINDOWS environment variable is set, the most commonly
+ * queried window state is mirrored in a memory region mapped read-only in
+ * the client processes, indexed like the user handle table. Each entry is
+ * protected by a sequence counter, so that clients can read it without
+ * locking and retry if it was modified in the meantime. */
+
+#define MAX_SHARED_WINDOWS ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+
+static struct mapping *window_shm_mapping;  /* mapping of the shared region */
+static struct window_shm *window_shm_states; /* server view of the shared region */
+
+/* A visible region is always contained in the window rectangle, or in the parent
+ * client area with DCX_PARENTCLIP, and is clipped to the client areas of all the
+ * ancestors. A change to a window can thus only affect the visible regions of its
+ * own descendants, and of the windows whose area overlaps the old or new window
+ * rectangle; only these cached regions are invalidated. */
+
+static unsigned int vis_cache_hits;          /* visible regions returned from the cache */
+static unsigned int vis_cache_misses;        /* visible regions computed from scratch */
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
@@ -138,6 +203,159 @@ static inline int is_desktop_window( const struct window *win )
     return !win->parent;  /* only desktop windows have no parent */
 }
 
+/* invalidate the cached visible regions of a window and of all its descendants */
+static void invalidate_visible_region_tree( struct window *win )
+{
+    struct window *child;
+
+    win->vis_cache_valid = 0;
+    LIST_FOR_EACH_ENTRY( child, &win->children, struct window, entry )
+        invalidate_visible_region_tree( child );
+}
+
+/* invalidate the cached visible regions of the windows of a tree that can overlap a rectangle */
+/* parent_client is the parent client area, and x,y the origin of the window coordinates, */
+/* all in screen coordinates */
+static void invalidate_overlapping_regions( struct window *win, const rectangle_t *rect,
+                                            const rectangle_t *parent_client, int x, int y )
+{
+    struct window *child;
+    rectangle_t area, client, tmp;
+
+    if (parent_client && !intersect_rect( &tmp, parent_client, rect )) return;
+
+    if (win->vis_cache_valid)
+    {
+        if ((win->vis_cache_flags & DCX_PARENTCLIP) && parent_client) area = *parent_client;
+        else
+        {
+            area.left   = min( win->window_rect.left, win->visible_rect.left ) + x;
+            area.top    = min( win->window_rect.top, win->visible_rect.top ) + y;
+            area.right  = max( win->window_rect.right, win->visible_rect.right ) + x;
+            area.bottom = max( win->window_rect.bottom, win->visible_rect.bottom ) + y;
+        }
+        if (intersect_rect( &tmp, &area, rect )) win->vis_cache_valid = 0;
+    }
+
+    client = win->client_rect;
+    if (is_desktop_window( win )) x = y = 0;  /* top-level windows are in screen coordinates */
+    else
+    {
+        client.left   += x;
+        client.top    += y;
+        client.right  += x;
+        client.bottom += y;
+        x = client.left;
+        y = client.top;
+    }
+    LIST_FOR_EACH_ENTRY( child, &win->children, struct window, entry )
+        invalidate_overlapping_regions( child, rect, &client, x, y );
+}
+
+/* invalidate the cached visible regions that a change to a window can affect */
+/* old_rect is the previous window area relative to the parent client area, if it changed */
+static void invalidate_visible_regions( struct window *win, const rectangle_t *old_rect )
+{
+    struct window *ptr, *root;
+    rectangle_t rect;
+    int x = 0, y = 0;
+
+    invalidate_visible_region_tree( win );
+    if (is_desktop_window( win )) return;
+
+    for (ptr = win->parent; !is_desktop_window( ptr ); ptr = ptr->parent)
+    {
+        x += ptr->client_rect.left;
+        y += ptr->client_rect.top;
+    }
+    for (root = win; root->parent; root = root->parent) ;
+
+    rect.left   = min( win->window_rect.left, win->visible_rect.left ) + x;
+    rect.top    = min( win->window_rect.top, win->visible_rect.top ) + y;
+    rect.right  = max( win->window_rect.right, win->visible_rect.right ) + x;
+    rect.bottom = max( win->window_rect.bottom, win->visible_rect.bottom ) + y;
+    invalidate_overlapping_regions( root, &rect, NULL, 0, 0 );
+
+    if (old_rect)
+    {
+        rect.left   = old_rect->left + x;
+        rect.top    = old_rect->top + y;
+        rect.right  = old_rect->right + x;
+        rect.bottom = old_rect->bottom + y;
+        invalidate_overlapping_regions( root, &rect, NULL, 0, 0 );
+    }
+}
+
+/* free the spatial index of the children of a window */
+static void invalidate_child_index( struct window *win )
+{
+    struct child_index *index = win->child_index;
+
+    if (!index) return;
+    free( index->children );
+    free( index->cell_start );
+    free( index->items );
+    free( index );
+    win->child_index = NULL;
+}
+
+/* create the shared region if enabled */
+void init_window_shm(void)
+{
+    const char *env = getenv( "WINEFASTWINDOWS" );
+
+    if (!env || !atoi( env )) return;
+
+    if (!(window_shm_mapping = create_shared_mapping( MAX_SHARED_WINDOWS * sizeof(*window_shm_states),
+                                                      (void **)&window_shm_states )))
+    {
+        clear_error();
+        return;
+    }
+    make_object_static( (struct object *)window_shm_mapping );
+    if (debug_level) fprintf( stderr, "wineserver: shared window state enabled\n" );
+}
+
+/* get the shared entry of a window handle, or NULL if disabled */
+static inline struct window_shm *get_window_shm( user_handle_t handle )
+{
+    if (!window_shm_states) return NULL;
+    return &window_shm_states[((handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+}
+
+/* publish the current state of a window in the shared region */
+static void update_window_shm( struct window *win )
+{
+    struct window_shm *shm = get_window_shm( win->handle );
+
+    if (!shm) return;
+    interlocked_xchg_add( (int *)&shm->seq, 1 );
+    shm->handle    = win->handle;
+    shm->parent    = win->parent ? win->parent->handle : 0;
+    shm->owner     = win->owner;
+    shm->tid       = win->thread ? get_thread_id( win->thread ) : 0;
+    shm->pid       = win->thread ? get_process_id( win->thread->process ) : 0;
+    shm->style     = win->style;
+    shm->ex_style  = win->ex_style;
+    shm->id        = win->id;
+    shm->instance  = win->instance;
+    shm->user_data = win->user_data;
+    shm->window    = win->window_rect;
+    shm->client    = win->client_rect;
+    interlocked_xchg_add( (int *)&shm->seq, 1 );
+}
+
+/* remove a window from the shared region */
+static void clear_window_shm( struct window *win )
+{
+    struct window_shm *shm = get_window_shm( win->handle );
+
+    if (!shm) return;
+    interlocked_xchg_add( (int *)&shm->seq, 1 );
+    shm->handle = 0;
+    interlocked_xchg_add( (int *)&shm->seq, 1 );
+}
+
 /* get next window in Z-order list */
 static inline struct window *get_next_window( struct window *win )
 {
@@ -227,6 +445,9 @@ static void link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    invalidate_child_index( win->parent );
+    invalidate_visible_regions( win, NULL );
+    update_window_shm( win );
 }
 
 /* change the parent of a window (or unlink the window if the new parent is NULL) */
@@ -244,6 +465,10 @@ static int set_parent_window( struct window *win, struct window *parent )
         }
     }
 
+    if (win->is_linked) invalidate_child_index( win->parent );
+
+    if (win->is_linked) invalidate_visible_regions( win, NULL );
+
     if (parent)
     {
         win->parent = parent;
@@ -401,6 +626,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_window_shm( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -478,6 +704,9 @@ static struct window *create_window( struct window *parent, struct window *owner
     win->last_active    = win->handle;
     win->win_region     = NULL;
     win->update_region  = NULL;
+    win->vis_cache      = NULL;
+    win->vis_cache_valid = 0;
+    win->child_index    = NULL;
     win->style          = 0;
     win->ex_style       = 0;
     win->id             = 0;
@@ -527,6 +756,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_window_shm( win );
     return win;
 
 failed:
@@ -656,6 +886,166 @@ static inline int is_point_in_window( struct window *win, int x, int y )
     return 1;
 }
 
+/* get the grid column of a coordinate inside the index bounds */
+static inline int index_column( const struct child_index *index, int x )
+{
+    return ((unsigned int)x - index->bounds.left) / index->cell_width;
+}
+
+/* get the grid row of a coordinate inside the index bounds */
+static inline int index_row( const struct child_index *index, int y )
+{
+    return ((unsigned int)y - index->bounds.top) / index->cell_height;
+}
+
+/* build the spatial index of the children of a window */
+static struct child_index *build_child_index( struct window *parent )
+{
+    struct child_index *index;
+    struct window *ptr;
+    unsigned int i, count = 0, total = 0, *pos = NULL;
+    int x, y, left, top, right, bottom;
+
+    LIST_FOR_EACH_ENTRY( ptr, &parent->children, struct window, entry ) count++;
+
+    if (!(index = mem_alloc( sizeof(*index) ))) return NULL;
+    memset( index, 0, sizeof(*index) );
+    index->count = count;
+    if (count < MIN_INDEXED_CHILDREN) return index;
+
+    if (!(index->children = mem_alloc( count * sizeof(*index->children) ))) goto failed;
+    i = 0;
+    LIST_FOR_EACH_ENTRY( ptr, &parent->children, struct window, entry )
+    {
+        const rectangle_t *rect = &ptr->visible_rect;
+
+        index->children[i++] = ptr;
+        if (rect->left >= rect->right || rect->top >= rect->bottom) continue;
+        if (index->bounds.left >= index->bounds.right) index->bounds = *rect;
+        else
+        {
+            index->bounds.left   = min( index->bounds.left, rect->left );
+            index->bounds.top    = min( index->bounds.top, rect->top );
+            index->bounds.right  = max( index->bounds.right, rect->right );
+            index->bounds.bottom = max( index->bounds.bottom, rect->bottom );
+        }
+    }
+    if (index->bounds.left >= index->bounds.right) return index;  /* no visible children */
+
+    for (index->cols = 1; index->cols * index->cols < count; index->cols++)
+        if (index->cols == MAX_INDEX_GRID_SIZE) break;
+    index->rows = index->cols;
+    index->cell_width  = ((unsigned int)index->bounds.right - index->bounds.left) / index->cols + 1;
+    index->cell_height = ((unsigned int)index->bounds.bottom - index->bounds.top) / index->rows + 1;
+
+    if (!(index->cell_start = mem_alloc( (index->cols * index->rows + 1) * sizeof(*index->cell_start) )))
+        goto failed;
+    memset( index->cell_start, 0, (index->cols * index->rows + 1) * sizeof(*index->cell_start) );
+
+    /* first count the windows in each cell */
+    for (i = 0; i < count; i++)
+    {
+        const rectangle_t *rect = &index->children[i]->visible_rect;
+
+        if (rect->left >= rect->right || rect->top >= rect->bottom) continue;
+        left   = index_column( index, rect->left );
+        top    = index_row( index, rect->top );
+        right  = index_column( index, rect->right - 1 );
+        bottom = index_row( index, rect->bottom - 1 );
+        total += (right - left + 1) * (bottom - top + 1);
+        for (y = top; y <= bottom; y++)
+            for (x = left; x <= right; x++) index->cell_start[y * index->cols + x + 1]++;
+    }
+
+    /* too many overlapping windows, the grid wouldn't help */
+    if (total > 8 * count)
+    {
+        index->cols = index->rows = 0;
+        return index;
+    }
+
+    for (i = 0; i < index->cols * index->rows; i++) index->cell_start[i + 1] += index->cell_start[i];
+
+    /* then fill the cells, in z-order */
+    if (!(index->items = mem_alloc( max( total, 1 ) * sizeof(*index->items) ))) goto failed;
+    if (!(pos = memdup( index->cell_start, index->cols * index->rows * sizeof(*pos) ))) goto failed;
+    for (i = 0; i < count; i++)
+    {
+        const rectangle_t *rect = &index->children[i]->visible_rect;
+
+        if (rect->left >= rect->right || rect->top >= rect->bottom) continue;
+        left   = index_column( index, rect->left );
+        top    = index_row( index, rect->top );
+        right  = index_column( index, rect->right - 1 );
+        bottom = index_row( index, rect->bottom - 1 );
+        for (y = top; y <= bottom; y++)
+            for (x = left; x <= right; x++) index->items[pos[y * index->cols + x]++] = i;
+    }
+    free( pos );
+    return index;
+
+failed:
+    free( pos );
+    free( index->children );
+    free( index->cell_start );
+    free( index->items );
+    free( index );
+    return NULL;
+}
+
+/* start iterating over the children of a window that may contain a point */
+static void child_iter_init( struct child_iter *iter, struct window *parent, int x, int y )
+{
+    struct child_index *index;
+
+    iter->parent = parent;
+    iter->index  = NULL;
+    iter->entry  = &parent->children;
+
+    if (!(index = parent->child_index))
+    {
+        if (!(index = parent->child_index = build_child_index( parent )))
+        {
+            clear_error();  /* simply use the children list */
+            return;
+        }
+    }
+    if (!index->cols) return;
+
+    iter->index = index;
+    iter->pos = iter->end = 0;
+    if (x >= index->bounds.left && x < index->bounds.right &&
+        y >= index->bounds.top && y < index->bounds.bottom)
+    {
+        unsigned int cell = index_row( index, y ) * index->cols + index_column( index, x );
+        iter->pos = index->cell_start[cell];
+        iter->end = index->cell_start[cell + 1];
+    }
+}
+
+/* get the next child containing the point, in z-order */
+static struct window *child_iter_next( struct child_iter *iter, int x, int y )
+{
+    struct window *ptr;
+
+    if (iter->index)
+    {
+        while (iter->pos < iter->end)
+        {
+            ptr = iter->index->children[iter->index->items[iter->pos++]];
+            if (is_point_in_window( ptr, x, y )) return ptr;
+        }
+        return NULL;
+    }
+
+    while ((iter->entry = list_next( &iter->parent->children, iter->entry )))
+    {
+        ptr = LIST_ENTRY( iter->entry, struct window, entry );
+        if (is_point_in_window( ptr, x, y )) return ptr;
+    }
+    return NULL;
+}
+
 /* fill an array with the handles of the children of a specified window */
 static unsigned int get_children_windows( struct window *parent, atom_t atom, thread_id_t tid,
                                           user_handle_t *handles, unsigned int max_count )
@@ -682,12 +1072,12 @@ static unsigned int get_children_windows( struct window *parent, atom_t atom, th
 /* find child of 'parent' that contains the given point (in parent-relative coords) */
 static struct window *child_window_from_point( struct window *parent, int x, int y )
 {
+    struct child_iter iter;
     struct window *ptr;
 
-    LIST_FOR_EACH_ENTRY( ptr, &parent->children, struct window, entry )
+    child_iter_init( &iter, parent, x, y );
+    if ((ptr = child_iter_next( &iter, x, y )))
     {
-        if (!is_point_in_window( ptr, x, y )) continue;  /* skip it */
-
         /* if window is minimized or disabled, return at once */
         if (ptr->style & (WS_MINIMIZE|WS_DISABLED)) return ptr;
 
@@ -705,12 +1095,12 @@ static struct window *child_window_from_point( struct window *parent, int x, int
 static int get_window_children_from_point( struct window *parent, int x, int y,
                                            struct user_handle_array *array )
 {
+    struct child_iter iter;
     struct window *ptr;
 
-    LIST_FOR_EACH_ENTRY( ptr, &parent->children, struct window, entry )
+    child_iter_init( &iter, parent, x, y );
+    while ((ptr = child_iter_next( &iter, x, y )))
     {
-        if (!is_point_in_window( ptr, x, y )) continue;  /* skip it */
-
         /* if point is in client area, and window is not minimized or disabled, check children */
         if (!(ptr->style & (WS_MINIMIZE|WS_DISABLED)) &&
             x >= ptr->client_rect.left && x < ptr->client_rect.right &&
@@ -730,15 +1120,13 @@ static int get_window_children_from_point( struct window *parent, int x, int y,
 /* get handle of root of top-most window containing point */
 user_handle_t shallow_window_from_point( struct desktop *desktop, int x, int y )
 {
+    struct child_iter iter;
     struct window *ptr;
 
     if (!desktop->top_window) return 0;
 
-    LIST_FOR_EACH_ENTRY( ptr, &desktop->top_window->children, struct window, entry )
-    {
-        if (!is_point_in_window( ptr, x, y )) continue;  /* skip it */
-        return ptr->handle;
-    }
+    child_iter_init( &iter, desktop->top_window, x, y );
+    if ((ptr = child_iter_next( &iter, x, y ))) return ptr->handle;
     return desktop->top_window->handle;
 }
 
@@ -968,7 +1356,7 @@ static inline struct window *get_top_clipping_window( struct window *win )
 
 
 /* compute the visible region of a window, in window coordinates */
-static struct region *get_visible_region( struct window *win, unsigned int flags )
+static struct region *compute_visible_region( struct window *win, unsigned int flags )
 {
     struct region *tmp = NULL, *region;
     int offset_x, offset_y;
@@ -1054,6 +1442,46 @@ error:
 }
 
 
+/* get the visible region of a window, in window coordinates, using the cache if possible */
+static struct region *get_visible_region( struct window *win, unsigned int flags )
+{
+    struct region *region;
+
+    flags &= VIS_CACHE_FLAGS;
+    if (win->vis_cache && win->vis_cache_valid && win->vis_cache_flags == flags)
+    {
+        vis_cache_hits++;
+        if (!(region = create_empty_region())) return NULL;
+        if (copy_region( region, win->vis_cache )) return region;
+        free_region( region );
+        return NULL;
+    }
+
+    if (debug_level && !(++vis_cache_misses % 1000))
+        fprintf( stderr, "wineserver: visible regions: %u cache hits, %u computed\n",
+                 vis_cache_hits, vis_cache_misses );
+
+    if (!(region = compute_visible_region( win, flags ))) return NULL;
+
+    if (!win->vis_cache && !(win->vis_cache = create_empty_region()))
+    {
+        clear_error();
+        return region;
+    }
+    if (copy_region( win->vis_cache, region ))
+    {
+        win->vis_cache_flags = flags;
+        win->vis_cache_valid = 1;
+    }
+    else
+    {
+        win->vis_cache_valid = 0;
+        clear_error();
+    }
+    return region;
+}
+
+
 /* clip all children with a custom pixel format out of the visible region */
 static struct region *clip_pixel_format_children( struct window *parent, struct region *parent_clip,
                                                   struct region *region, int offset_x, int offset_y )
@@ -1657,6 +2085,12 @@ static void set_window_pos( struct window *win, struct window *previous,
     if (!(swp_flags & SWP_NOZORDER) && win->parent) link_window( win, previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
+    if (win->parent) invalidate_child_index( win->parent );
+    rect.left   = min( old_window_rect.left, old_visible_rect.left );
+    rect.top    = min( old_window_rect.top, old_visible_rect.top );
+    rect.right  = max( old_window_rect.right, old_visible_rect.right );
+    rect.bottom = max( old_window_rect.bottom, old_visible_rect.bottom );
+    invalidate_visible_regions( win, &rect );
 
     /* keep children at the same position relative to top right corner when the parent is mirrored */
     if (win->ex_style & WS_EX_LAYOUTRTL)
@@ -1670,8 +2104,11 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->window_rect, new_size - old_size, 0 );
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shm( child );
         }
+        invalidate_child_index( win );
     }
+    update_window_shm( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) win->desktop->cursor.clip = *window_rect;
@@ -1812,6 +2249,7 @@ static void set_window_region( struct window *win, struct region *region, int re
 
     if (win->win_region) free_region( win->win_region );
     win->win_region = region;
+    invalidate_visible_regions( win, NULL );
 
     /* expose anything revealed by the change */
     if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn ))))
@@ -1833,6 +2271,7 @@ void destroy_window( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        invalidate_visible_regions( win, NULL );
         if (vis_rgn)
         {
             struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn );
@@ -1856,8 +2295,10 @@ void destroy_window( struct window *win )
     if (win == taskman_window) taskman_window = NULL;
     free_hotkeys( win->desktop, win->handle );
     cleanup_clipboard_window( win->desktop, win->handle );
+    clear_window_shm( win );
     free_user_handle( win->handle );
     destroy_properties( win );
+    if (win->parent) invalidate_child_index( win->parent );
     list_remove( &win->entry );
     if (is_desktop_window(win))
     {
@@ -1874,6 +2315,8 @@ void destroy_window( struct window *win )
     detach_window_thread( win );
     if (win->win_region) free_region( win->win_region );
     if (win->update_region) free_region( win->update_region );
+    if (win->vis_cache) free_region( win->vis_cache );
+    invalidate_child_index( win );
     if (win->class) release_class( win->class );
     free( win->text );
     memset( win, 0x55, sizeof(*win) + win->nb_extra_bytes - 1 );
@@ -1967,6 +2410,8 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            invalidate_visible_regions( desktop->top_window, NULL );
+            update_window_shm( desktop->top_window );
         }
     }
 
@@ -1979,6 +2424,8 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            invalidate_visible_regions( desktop->msg_window, NULL );
+            update_window_shm( desktop->msg_window );
         }
     }
 
@@ -2014,6 +2461,7 @@ DECL_HANDLER(set_window_owner)
 
     reply->prev_owner = win->owner;
     reply->full_owner = win->owner = owner ? owner->handle : 0;
+    update_window_shm( win );
 }
 
 
@@ -2040,6 +2488,19 @@ DECL_HANDLER(get_window_info)
 }
 
 
+/* retrieve the shared region holding the state of the windows */
+DECL_HANDLER(get_window_shm_region)
+{
+    if (!window_shm_mapping)
+    {
+        set_error( STATUS_NOT_IMPLEMENTED );
+        return;
+    }
+    reply->size   = MAX_SHARED_WINDOWS * sizeof(*window_shm_states);
+    reply->handle = alloc_handle( current->process, window_shm_mapping, SECTION_QUERY | SECTION_MAP_READ, 0 );
+}
+
+
 /* set some information in a window */
 DECL_HANDLER(set_window_info)
 {
@@ -2089,6 +2550,8 @@ DECL_HANDLER(set_window_info)
 
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) invalidate_visible_regions( win, NULL );
+    if (req->flags) update_window_shm( win );
 }
 
 
@@ -0,0 +1,276 @@
+/*
+ * Server worker threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * All the server objects are owned by the main loop and are never accessed
+ * from another thread. When the WINESERVERTHREADS environment variable is
+ * set, a small pool of worker threads is started to perform operations that
+ * may block for a long time in the kernel (like fsync) without holding up
+ * the requests of all the other clients. A work item only operates on the
+ * data it was given; its completion callback is then called from the main
+ * loop, where it can safely update the server objects.
+ */
+
+#include "config.h"
+#include "wine/port.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+
+#include "file.h"
+#include "object.h"
+#include "request.h"
+
+#ifdef HAVE_PTHREAD_H
+
+#define MAX_WORKERS 16
+
+struct work
+{
+    struct list      entry;      /* entry in pending or completed list */
+    work_func        func;       /* function to run in the worker thread */
+    work_func        callback;   /* completion function to run in the main loop */
+    void            *arg;        /* argument for both functions */
+};
+
+struct worker_notify
+{
+    struct object    obj;         /* object header */
+    struct fd       *fd;          /* file descriptor for the pipe read side */
+    int              pipe_write;  /* unix fd for the pipe write side */
+};
+
+static void worker_notify_dump( struct object *obj, int verbose );
+static void worker_notify_destroy( struct object *obj );
+
+static const struct object_ops worker_notify_ops =
+{
+    sizeof(struct worker_notify), /* size */
+    worker_notify_dump,           /* dump */
+    no_get_type,                  /* get_type */
+    no_add_queue,                 /* add_queue */
+    NULL,                         /* remove_queue */
+    NULL,                         /* signaled */
+    NULL,                         /* satisfied */
+    no_signal,                    /* signal */
+    no_get_fd,                    /* get_fd */
+    no_map_access,                /* map_access */
+    default_get_sd,               /* get_sd */
+    default_set_sd,               /* set_sd */
+    no_lookup_name,               /* lookup_name */
+    no_link_name,                 /* link_name */
+    NULL,                         /* unlink_name */
+    no_open_file,                 /* open_file */
+    no_close_handle,              /* close_handle */
+    worker_notify_destroy         /* destroy */
+};
+
+static void worker_notify_poll_event( struct fd *fd, int event );
+
+static const struct fd_ops worker_notify_fd_ops =
+{
+    NULL,                         /* get_poll_events */
+    worker_notify_poll_event,     /* poll_event */
+    NULL,                         /* flush */
+    NULL,                         /* get_fd_type */
+    NULL,                         /* ioctl */
+    NULL,                         /* queue_async */
+    NULL                          /* reselect_async */
+};
+
+static struct worker_notify *notify;  /* main loop notification of completed work */
+static struct list pending_work = LIST_INIT( pending_work );
+static struct list completed_work = LIST_INIT( completed_work );
+static int completion_pending;        /* a notification has been written to the pipe */
+static pthread_mutex_t work_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+
+static void worker_notify_dump( struct object *obj, int verbose )
+{
+    struct worker_notify *notify = (struct worker_notify *)obj;
+    fprintf( stderr, "Worker notification fd=%p\n", notify->fd );
+}
+
+static void worker_notify_destroy( struct object *obj )
+{
+    struct worker_notify *notify = (struct worker_notify *)obj;
+    if (notify->fd) release_object( notify->fd );
+    close( notify->pipe_write );
+}
+
+/* run the completion callbacks of the finished work items */
+static void worker_notify_poll_event( struct fd *fd, int event )
+{
+    struct list completed = LIST_INIT( completed );
+    struct list *ptr;
+    char dummy;
+
+    if (event & (POLLERR | POLLHUP))
+    {
+        /* this is not supposed to happen */
+        fprintf( stderr, "wineserver: Error on worker notification pipe\n" );
+        set_fd_events( fd, -1 );
+        return;
+    }
+
+    pthread_mutex_lock( &work_mutex );
+    read( get_unix_fd( fd ), &dummy, 1 );
+    completion_pending = 0;
+    list_move_tail( &completed, &completed_work );
+    pthread_mutex_unlock( &work_mutex );
+
+    while ((ptr = list_head( &completed )))
+    {
+        struct work *work = LIST_ENTRY( ptr, struct work, entry );
+        list_remove( &work->entry );
+        work->callback( work->arg );
+        free( work );
+    }
+}
+
+/* main function of the worker threads */
+static void *worker_thread( void *arg )
+{
+    struct list *ptr;
+
+    pthread_mutex_lock( &work_mutex );
+    for (;;)
+    {
+        struct work *work;
+
+        while (!(ptr = list_head( &pending_work ))) pthread_cond_wait( &work_cond, &work_mutex );
+        work = LIST_ENTRY( ptr, struct work, entry );
+        list_remove( &work->entry );
+        pthread_mutex_unlock( &work_mutex );
+
+        work->func( work->arg );
+
+        pthread_mutex_lock( &work_mutex );
+        list_add_tail( &completed_work, &work->entry );
+        if (!completion_pending)
+        {
+            char dummy = 0;
+            completion_pending = 1;
+            write( notify->pipe_write, &dummy, 1 );
+        }
+    }
+    return NULL;
+}
+
+/* start the worker threads if requested */
+void init_workers(void)
+{
+    const char *env = getenv( "WINESERVERTHREADS" );
+    int i, count, started = 0, fd[2];
+    sigset_t sigset, old_sigset;
+    pthread_attr_t attr;
+    pthread_t id;
+
+    if (!env || (count = atoi( env )) <= 0) return;
+    if (count > MAX_WORKERS) count = MAX_WORKERS;
+
+    if (pipe( fd ) == -1) return;
+    if (!(notify = alloc_object( &worker_notify_ops )))
+    {
+        close( fd[0] );
+        close( fd[1] );
+        return;
+    }
+    notify->pipe_write = fd[1];
+    if (!(notify->fd = create_anonymous_fd( &worker_notify_fd_ops, fd[0], &notify->obj, 0 )))
+        goto error;
+    set_fd_events( notify->fd, POLLIN );
+    make_object_static( &notify->obj );
+
+    /* signals must keep being delivered to the main loop thread */
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &old_sigset );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    for (i = 0; i < count; i++) if (!pthread_create( &id, &attr, worker_thread, NULL )) started++;
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old_sigset, NULL );
+
+    if (started)
+    {
+        if (debug_level) fprintf( stderr, "wineserver: started %d worker threads\n", started );
+        return;
+    }
+
+error:
+    release_object( notify );
+    notify = NULL;
+}
+
+/* check if work items can be queued to worker threads */
+int have_workers(void)
+{
+    return notify != NULL;
+}
+
+/* queue a work item to a worker thread; return 0 if work must be done synchronously */
+int queue_work( work_func func, work_func callback, void *arg )
+{
+    struct work *work;
+
+    if (!notify) return 0;
+    if (!(work = malloc( sizeof(*work) ))) return 0;
+    work->func     = func;
+    work->callback = callback;
+    work->arg      = arg;
+
+    pthread_mutex_lock( &work_mutex );
+    list_add_tail( &pending_work, &work->entry );
+    pthread_cond_signal( &work_cond );
+    pthread_mutex_unlock( &work_mutex );
+    return 1;
+}
+
+#else  /* HAVE_PTHREAD_H */
+
+void init_workers(void)
+{
+}
+
+int have_workers(void)
+{
+    return 0;
+}
+
+int queue_work( work_func func, work_func callback, void *arg )
+{
+    return 0;
+}
+
+#endif  /* HAVE_PTHREAD_H */